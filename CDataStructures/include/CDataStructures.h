@@ -16,12 +16,24 @@
 #   ifdef CDS_USE_ALLOC_LIB
 #       include "CDataStructures/alloc.h"
 #   endif
+#   include "CDataStructures/allocator.h"
+#   include "CDataStructures/appender.h"
+#   include "CDataStructures/bitset.h"
 #   include "CDataStructures/dynbuffer.h"
+#   include "CDataStructures/flatmap.h"
 #   include "CDataStructures/functional.h"
+#   include "CDataStructures/gapbuffer.h"
+#   include "CDataStructures/growth.h"
+#   include "CDataStructures/kernels.h"
+#   include "CDataStructures/parallel.h"
+#   include "CDataStructures/serialize.h"
 #   include "CDataStructures/slist.h"
+#   include "CDataStructures/sort.h"
+#   include "CDataStructures/span.h"
 #   include "CDataStructures/stack.h"
 #   include "CDataStructures/status.h"
 #   include "CDataStructures/type.h"
+#   include "CDataStructures/typed.h"
 #   include "CDataStructures/unarynode.h"
 #   include "CDataStructures/utils.h"
 #   include "CDataStructures/vector.h"
@@ -0,0 +1,21 @@
+#ifndef _CDATASTRUCTURES_CONFIG_H
+#   define _CDATASTRUCTURES_CONFIG_H
+
+/* #undef CDS_DEBUG */
+/* #undef CDS_USE_ALLOC_LIB */
+#   define CDS_HAVE_MMAP
+#   define CDS_HAVE_MREMAP
+#   define CDS_HAVE_PTHREAD
+
+#   if defined(_MSC_VER) && !defined(__INTEL_COMPILER)
+#       define _CDS_COMPILER "MSVC"
+#       pragma warning(disable : 4996)
+#   elif defined(__GNUC__) && !defined(__clang__)
+#       define _CDS_COMPILER "GCC"
+#   elif defined(__clang__)
+#       define _CDS_COMPILER "clang"
+#   else
+#       define _CDS_COMPILER "Unknown"
+#   endif
+
+#endif
@@ -0,0 +1,197 @@
+/**
+ * @file allocator.h
+ * @author RenoirTan
+ * @brief A header defining an interface for plugging custom memory allocators
+ * into the containers in this library.
+ * @version 0.1
+ * @date 2021-07-09
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#ifndef CDATASTRUCTURES_ALLOCATOR_H
+#   define CDATASTRUCTURES_ALLOCATOR_H
+
+#   include "_prelude.h"
+#   include "_common.h"
+
+#   ifndef CDS_DEFAULT_MMAP_THRESHOLD
+/**
+ * @brief Blocks of at least this many bytes are mapped directly from the
+ * operating system by the default allocator.
+ */
+#       define CDS_DEFAULT_MMAP_THRESHOLD ((size_t) 4 << 20)
+#   endif
+
+#   ifndef CDS_DEFAULT_HUGEPAGE_THRESHOLD
+/**
+ * @brief Mapped blocks of at least this many bytes are backed by transparent
+ * huge pages if possible.
+ */
+#       define CDS_DEFAULT_HUGEPAGE_THRESHOLD ((size_t) 32 << 20)
+#   endif
+
+/**
+ * @brief A function type which allocates `size` bytes and returns a pointer to
+ * the new memory block, or NULL if memory could not be allocated.
+ */
+typedef cds_ptr_t (*cds_alloc_f)(cds_ptr_t context, size_t size);
+
+/**
+ * @brief A function type which resizes a memory block from `old_size` bytes to
+ * `new_size` bytes, returning the pointer to the resized block or NULL if the
+ * block could not be resized (in which case the old block must be left
+ * untouched).
+ */
+typedef cds_ptr_t (*cds_realloc_f)(
+    cds_ptr_t context,
+    cds_ptr_t pointer,
+    size_t old_size,
+    size_t new_size
+);
+
+/**
+ * @brief A function type which gives back a memory block of `size` bytes.
+ */
+typedef void (*cds_dealloc_f)(cds_ptr_t context, cds_ptr_t pointer, size_t size);
+
+struct _cds_allocator_t {
+    cds_alloc_f alloc;
+    /**
+     * @brief The function used to resize memory blocks. If NULL, blocks are
+     * resized by allocating a new block, copying the data over and freeing
+     * the old block.
+     */
+    cds_realloc_f realloc;
+    cds_dealloc_f free;
+    /**
+     * @brief A pointer which is passed as the first argument to every
+     * function in this allocator, such as the arena or pool the memory comes
+     * from.
+     */
+    cds_ptr_t context;
+};
+
+/**
+ * @brief A table of functions telling a container where to get memory from.
+ * Containers initialised with an allocator (using the functions ending in
+ * `...with_allocator`) keep a pointer to it and use it for all of their
+ * allocations, so the allocator must outlive them. This lets you plug in
+ * arenas, pools or allocators that track memory usage.
+ * 
+ * Every function in this library which accepts an allocator treats NULL as
+ * `CDS_DEFAULT_ALLOCATOR`.
+ */
+typedef struct _cds_allocator_t cds_allocator_t;
+
+struct _cds_large_block_config_t {
+    /**
+     * @brief Blocks of at least this many bytes are anonymous memory mappings
+     * which grow using `mremap`, so their contents never have to be copied.
+     * 0 turns this off.
+     */
+    size_t mmap_threshold;
+    /**
+     * @brief Mapped blocks of at least this many bytes are advised to use
+     * transparent huge pages, which cuts down on TLB misses when walking
+     * through them. 0 turns this off.
+     */
+    size_t hugepage_threshold;
+};
+
+/**
+ * @brief Decides when an allocator made by `cds_large_block_allocator` maps
+ * blocks directly from the operating system instead of using `malloc`.
+ * Whether a block is mapped is recorded in a small header in front of it, so
+ * blocks are always freed the way they were allocated, whatever size they
+ * are freed with.
+ * 
+ * Mapping is only available on platforms with `mremap`. Elsewhere, every
+ * block comes from `malloc`.
+ */
+typedef struct _cds_large_block_config_t cds_large_block_config_t;
+
+/**
+ * @brief The thresholds used by `CDS_DEFAULT_ALLOCATOR`, made from
+ * `CDS_DEFAULT_MMAP_THRESHOLD` and `CDS_DEFAULT_HUGEPAGE_THRESHOLD`.
+ */
+CDS_PUBLIC const cds_large_block_config_t CDS_DEFAULT_LARGE_BLOCK_CONFIG;
+
+/**
+ * @brief The allocator backed by `malloc`, `realloc` and `free` for small
+ * blocks and anonymous memory mappings for large blocks, using
+ * `CDS_DEFAULT_LARGE_BLOCK_CONFIG`. Where mapping is available, its blocks
+ * start after a header, so they must not be given to `free` or taken from
+ * `malloc`. Use `CDS_MALLOC_ALLOCATOR` for that.
+ */
+CDS_PUBLIC const cds_allocator_t CDS_DEFAULT_ALLOCATOR;
+
+/**
+ * @brief The allocator backed by `malloc`, `realloc` and `free` alone. Vectors
+ * switch to it when they adopt an array with `cds_vector_adopt`, and vectors
+ * using it give up their arrays through `cds_vector_release` without copying
+ * them.
+ */
+CDS_PUBLIC const cds_allocator_t CDS_MALLOC_ALLOCATOR;
+
+/**
+ * @brief Make an allocator which works like `CDS_DEFAULT_ALLOCATOR` but with
+ * different thresholds for mapping large blocks.
+ * 
+ * @param config The thresholds, which must outlive the allocator. If NULL,
+ * `CDS_DEFAULT_LARGE_BLOCK_CONFIG` is used.
+ * 
+ * @return cds_allocator_t The allocator.
+ */
+CDS_PUBLIC
+cds_allocator_t cds_large_block_allocator(
+    const cds_large_block_config_t *config
+);
+
+/**
+ * @brief Allocate a block of memory using an allocator.
+ * 
+ * @param self The allocator. If NULL, `CDS_DEFAULT_ALLOCATOR` is used.
+ * @param size The number of bytes to allocate.
+ * 
+ * @return cds_ptr_t The pointer to the new block. NULL if memory could not be
+ * allocated.
+ */
+CDS_PUBLIC
+cds_ptr_t cds_allocator_alloc(const cds_allocator_t *self, size_t size);
+
+/**
+ * @brief Resize a block of memory allocated by an allocator.
+ * 
+ * @param self The allocator. If NULL, `CDS_DEFAULT_ALLOCATOR` is used.
+ * @param pointer The block to be resized. If NULL, a new block is allocated.
+ * @param old_size The current size of the block in bytes.
+ * @param new_size The size the block should have in bytes.
+ * 
+ * @return cds_ptr_t The pointer to the resized block. NULL if the block could
+ * not be resized, in which case `pointer` is still valid.
+ */
+CDS_PUBLIC
+cds_ptr_t cds_allocator_realloc(
+    const cds_allocator_t *self,
+    cds_ptr_t pointer,
+    size_t old_size,
+    size_t new_size
+);
+
+/**
+ * @brief Give a block of memory back to the allocator it came from.
+ * 
+ * @param self The allocator. If NULL, `CDS_DEFAULT_ALLOCATOR` is used.
+ * @param pointer The block to free. Nothing happens if this is NULL.
+ * @param size The size of the block in bytes.
+ */
+CDS_PUBLIC
+void cds_allocator_free(
+    const cds_allocator_t *self,
+    cds_ptr_t pointer,
+    size_t size
+);
+
+#endif
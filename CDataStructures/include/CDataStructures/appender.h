@@ -0,0 +1,176 @@
+/**
+ * @file appender.h
+ * @author RenoirTan
+ * @brief A header defining an appender, which lets many threads append
+ * elements to the same dynbuffer at once. Only available on platforms with
+ * POSIX threads (`CDS_HAVE_PTHREAD`).
+ * @version 0.1
+ * @date 2021-07-09
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#ifndef CDATASTRUCTURES_APPENDER_H
+#   define CDATASTRUCTURES_APPENDER_H
+
+#   include "_prelude.h"
+#   include "_common.h"
+#   include "dynbuffer.h"
+
+#   ifdef CDS_HAVE_PTHREAD
+#       include <pthread.h>
+
+struct _cds_appender_t {
+    /**
+     * @brief The dynbuffer, which may only be accessed while `lock` is held.
+     */
+    cds_buffer_t buffer;
+    size_t type_size;
+    /**
+     * @brief Writers hold this lock for reading while they fill in their
+     * slots, so any number of them can write at once. It is only held for
+     * writing while the buffer grows.
+     */
+    pthread_rwlock_t lock;
+    /**
+     * @brief The number of slots in the buffer, which only changes while
+     * `lock` is held for writing.
+     */
+    size_t capacity;
+    /**
+     * @brief The length of the buffer when the appender took it over.
+     */
+    size_t start;
+    /**
+     * @brief The index of the next slot to be claimed, advanced atomically.
+     */
+    size_t claimed;
+    /**
+     * @brief The number of elements whose slots have been committed,
+     * including the elements the buffer started with.
+     */
+    size_t committed;
+    /**
+     * @brief The number of slots which were claimed but could not be handed
+     * out because the buffer could not grow.
+     */
+    size_t lost;
+    /**
+     * @brief The index of the first lost slot. `SIZE_MAX` if no slots have
+     * been lost.
+     */
+    size_t first_lost;
+};
+
+/**
+ * @brief A wrapper around a dynbuffer which lets many threads append elements
+ * to it without an external mutex. Writers claim slots at the end of the
+ * buffer by atomically advancing a counter, so they never wait for each other
+ * while copying their elements in. The buffer only has to be locked when it
+ * runs out of capacity.
+ *
+ * Appending a batch of elements at once with `cds_appender_append` or
+ * `cds_appender_claim` is cheaper than appending them one by one.
+ */
+typedef struct _cds_appender_t cds_appender_t;
+
+/**
+ * @brief Initialise an appender by taking ownership of an initialised
+ * dynbuffer. New elements are appended after its current elements. Ring
+ * buffers are linearized and turned into normal buffers.
+ *
+ * @param self The appender.
+ * @param buffer The dynbuffer, which must not be used until it is handed back
+ * by `cds_appender_finish`.
+ *
+ * @return cds_status_t The status code of this operation.
+ */
+CDS_PUBLIC
+cds_status_t cds_appender_init(cds_appender_t *self, cds_buffer_t buffer);
+
+/**
+ * @brief Claim slots for `count` elements at the end of the buffer. The
+ * caller fills in the slots and then has to call `cds_appender_commit` with
+ * the same `count` on the same thread. The slots stay valid until then, but
+ * the buffer cannot grow, so no thread should wait on another thread between
+ * the 2 calls.
+ *
+ * @param self The appender.
+ * @param count The number of elements.
+ * @param slots Where the pointer to the first claimed slot is written to.
+ *
+ * @return cds_status_t The status code of this operation. If this fails,
+ * nothing needs to be committed. `cds_alloc_error` if `count` is too large,
+ * in which case nothing is claimed. If the buffer could not grow, the slots
+ * are lost and `cds_appender_finish` only keeps the elements in front of
+ * them.
+ */
+CDS_PUBLIC
+cds_status_t cds_appender_claim(
+    cds_appender_t *self,
+    size_t count,
+    cds_ptr_t *slots
+);
+
+/**
+ * @brief Publish slots filled in after `cds_appender_claim`.
+ *
+ * @param self The appender.
+ * @param count The number of elements that were claimed.
+ *
+ * @return cds_status_t The status code of this operation.
+ */
+CDS_PUBLIC
+cds_status_t cds_appender_commit(cds_appender_t *self, size_t count);
+
+/**
+ * @brief Append an array of elements to the buffer. This is safe to call from
+ * many threads at once. Elements appended by one call stay next to each
+ * other, but calls from different threads may end up in any order.
+ *
+ * @param self The appender.
+ * @param src The pointer to the first element to copy in.
+ * @param count The number of elements.
+ *
+ * @return cds_status_t The status code of this operation.
+ */
+CDS_PUBLIC
+cds_status_t cds_appender_append(
+    cds_appender_t *self,
+    cds_ptr_t src,
+    size_t count
+);
+
+/**
+ * @brief Get the number of elements which have been committed so far,
+ * including those the buffer started with.
+ *
+ * @param self The appender.
+ *
+ * @return size_t The number of committed elements. 0 if the appender is NULL.
+ */
+CDS_PUBLIC
+size_t cds_appender_length(cds_appender_t *self);
+
+/**
+ * @brief Hand the buffer back once every writer is done and destroy the
+ * appender. The buffer's length is updated to include every committed
+ * element.
+ *
+ * @param self The appender.
+ * @param buffer Where the dynbuffer is written to. It is handed back even if
+ * this fails.
+ *
+ * @return cds_status_t The status code of this operation. `cds_error` if
+ * some claimed slots were never committed, in which case the buffer keeps
+ * the length it started with. `cds_alloc_error` if some slots were lost
+ * because the buffer could not grow, in which case the buffer keeps every
+ * element in front of the first lost slot and drops the rest.
+ */
+CDS_PUBLIC
+cds_status_t cds_appender_finish(cds_appender_t *self, cds_buffer_t *buffer);
+
+#   endif
+
+#endif
\ No newline at end of file
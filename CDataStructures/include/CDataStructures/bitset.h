@@ -0,0 +1,331 @@
+/**
+ * @file bitset.h
+ * @author RenoirTan
+ * @brief A header defining a bitset, a fixed-length array of bits packed into
+ * 64-bit words, with an optional index for rank and select queries.
+ *
+ * The bits past the length in the last word are always clear, so whole words
+ * can be counted and combined without masking them. The bulk operations are
+ * plain loops over the words which the compiler can vectorize.
+ * @version 0.1
+ * @date 2021-07-09
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#ifndef CDATASTRUCTURES_BITSET_H
+#   define CDATASTRUCTURES_BITSET_H
+
+#   include "_prelude.h"
+#   include "_common.h"
+#   include "allocator.h"
+#   include "utils.h"
+
+/**
+ * @brief The number of bits in each word of a bitset.
+ */
+#   define CDS_BITSET_WORD_BITS 64
+
+#   ifndef CDS_BITSET_SELECT_SAMPLE
+/**
+ * @brief The index of a bitset remembers which block holds every
+ * `CDS_BITSET_SELECT_SAMPLE`-th set bit, so that `cds_bitset_select` only has
+ * to search the blocks between two of them.
+ */
+#       define CDS_BITSET_SELECT_SAMPLE 4096
+#   endif
+
+struct _cds_bitset_t {
+    /**
+     * @brief The words storing the bits. Bit `i` is bit `i % 64` of word
+     * `i / 64`.
+     */
+    uint64_t *words;
+    /**
+     * @brief The number of bits.
+     */
+    size_t length;
+    /**
+     * @brief The number of words allocated.
+     */
+    size_t capacity;
+    const cds_allocator_t *allocator;
+    /**
+     * @brief The rank and select index, which is only valid if `_indexed` is
+     * true. Each block of 8 words has 2 entries: the number of set bits
+     * before the block and the number of set bits before each of the words
+     * 1 to 7 in the block, packed into 9 bits each. The select samples are
+     * stored after the blocks.
+     */
+    uint64_t *_index;
+    size_t _index_words;
+    size_t _ones;
+    bool _indexed;
+};
+
+/**
+ * @brief An array of bits. Changing any bit makes the rank and select index
+ * stale until `cds_bitset_build_index` is called again.
+ */
+typedef struct _cds_bitset_t cds_bitset_t;
+
+/**
+ * @brief Initialise a bitset with every bit clear.
+ *
+ * @param self The bitset.
+ * @param length The number of bits.
+ *
+ * @return cds_status_t The status code of this operation.
+ */
+CDS_PUBLIC
+cds_status_t cds_bitset_init(cds_bitset_t *self, size_t length);
+
+/**
+ * @brief Initialise a bitset whose words come from an allocator.
+ *
+ * @param self The bitset.
+ * @param length The number of bits.
+ * @param allocator The allocator. If NULL, `CDS_DEFAULT_ALLOCATOR` is used.
+ *
+ * @return cds_status_t The status code of this operation.
+ */
+CDS_PUBLIC
+cds_status_t cds_bitset_init_with_allocator(
+    cds_bitset_t *self,
+    size_t length,
+    const cds_allocator_t *allocator
+);
+
+/**
+ * @brief Free the words and index of a bitset.
+ *
+ * @param self The bitset.
+ *
+ * @return cds_status_t The status code of this operation.
+ */
+CDS_PUBLIC
+cds_status_t cds_bitset_destroy(cds_bitset_t *self);
+
+/**
+ * @brief Change the number of bits in a bitset. Added bits are clear.
+ *
+ * @param self The bitset.
+ * @param length The new number of bits.
+ *
+ * @return cds_status_t The status code of this operation.
+ */
+CDS_PUBLIC
+cds_status_t cds_bitset_resize(cds_bitset_t *self, size_t length);
+
+/**
+ * @brief Check whether a bit is set.
+ *
+ * @param self The bitset.
+ * @param index The index of the bit.
+ * @return bool Whether the bit is set. false if the index is out of range.
+ */
+CDS_INLINE bool cds_bitset_test(const cds_bitset_t *self, size_t index) {
+    if (index >= self->length)
+        return false;
+    return (self->words[index / CDS_BITSET_WORD_BITS]
+        >> (index % CDS_BITSET_WORD_BITS)) & 1;
+}
+
+/**
+ * @brief Set a bit to 1.
+ *
+ * @param self The bitset.
+ * @param index The index of the bit.
+ * @return cds_status_t The status code of this operation. `cds_index_error`
+ * if the index is out of range.
+ */
+CDS_INLINE cds_status_t cds_bitset_set(cds_bitset_t *self, size_t index) {
+    if (index >= self->length)
+        return cds_index_error;
+    self->words[index / CDS_BITSET_WORD_BITS]
+        |= (uint64_t) 1 << (index % CDS_BITSET_WORD_BITS);
+    self->_indexed = false;
+    return cds_ok;
+}
+
+/**
+ * @brief Set a bit to 0.
+ *
+ * @param self The bitset.
+ * @param index The index of the bit.
+ * @return cds_status_t The status code of this operation. `cds_index_error`
+ * if the index is out of range.
+ */
+CDS_INLINE cds_status_t cds_bitset_clear(cds_bitset_t *self, size_t index) {
+    if (index >= self->length)
+        return cds_index_error;
+    self->words[index / CDS_BITSET_WORD_BITS]
+        &= ~((uint64_t) 1 << (index % CDS_BITSET_WORD_BITS));
+    self->_indexed = false;
+    return cds_ok;
+}
+
+/**
+ * @brief Flip a bit.
+ *
+ * @param self The bitset.
+ * @param index The index of the bit.
+ * @return cds_status_t The status code of this operation. `cds_index_error`
+ * if the index is out of range.
+ */
+CDS_INLINE cds_status_t cds_bitset_flip(cds_bitset_t *self, size_t index) {
+    if (index >= self->length)
+        return cds_index_error;
+    self->words[index / CDS_BITSET_WORD_BITS]
+        ^= (uint64_t) 1 << (index % CDS_BITSET_WORD_BITS);
+    self->_indexed = false;
+    return cds_ok;
+}
+
+/**
+ * @brief Set every bit to the same value.
+ *
+ * @param self The bitset.
+ * @param value The value of the bits.
+ *
+ * @return cds_status_t The status code of this operation.
+ */
+CDS_PUBLIC
+cds_status_t cds_bitset_fill(cds_bitset_t *self, bool value);
+
+/**
+ * @brief Clear every bit in a bitset which is clear in another bitset of the
+ * same length.
+ *
+ * @param self The bitset which is changed.
+ * @param other The other bitset.
+ *
+ * @return cds_status_t The status code of this operation. `cds_error` if the
+ * lengths differ.
+ */
+CDS_PUBLIC
+cds_status_t cds_bitset_and(cds_bitset_t *self, const cds_bitset_t *other);
+
+/**
+ * @brief Set every bit in a bitset which is set in another bitset of the same
+ * length.
+ *
+ * @param self The bitset which is changed.
+ * @param other The other bitset.
+ *
+ * @return cds_status_t The status code of this operation. `cds_error` if the
+ * lengths differ.
+ */
+CDS_PUBLIC
+cds_status_t cds_bitset_or(cds_bitset_t *self, const cds_bitset_t *other);
+
+/**
+ * @brief Flip every bit in a bitset which is set in another bitset of the
+ * same length.
+ *
+ * @param self The bitset which is changed.
+ * @param other The other bitset.
+ *
+ * @return cds_status_t The status code of this operation. `cds_error` if the
+ * lengths differ.
+ */
+CDS_PUBLIC
+cds_status_t cds_bitset_xor(cds_bitset_t *self, const cds_bitset_t *other);
+
+/**
+ * @brief Clear every bit in a bitset which is set in another bitset of the
+ * same length.
+ *
+ * @param self The bitset which is changed.
+ * @param other The other bitset.
+ *
+ * @return cds_status_t The status code of this operation. `cds_error` if the
+ * lengths differ.
+ */
+CDS_PUBLIC
+cds_status_t cds_bitset_andnot(cds_bitset_t *self, const cds_bitset_t *other);
+
+/**
+ * @brief Count the set bits in a bitset.
+ *
+ * @param self The bitset.
+ * @return size_t The number of set bits.
+ */
+CDS_PUBLIC
+size_t cds_bitset_count(const cds_bitset_t *self);
+
+/**
+ * @brief Find the first set bit at or after an index.
+ *
+ * @param self The bitset.
+ * @param from The index to start from.
+ * @return size_t The index of the set bit. The length of the bitset if there
+ * is none.
+ */
+CDS_PUBLIC
+size_t cds_bitset_find_next_set(const cds_bitset_t *self, size_t from);
+
+/**
+ * @brief Find the first clear bit at or after an index.
+ *
+ * @param self The bitset.
+ * @param from The index to start from.
+ * @return size_t The index of the clear bit. The length of the bitset if
+ * there is none.
+ */
+CDS_PUBLIC
+size_t cds_bitset_find_next_clear(const cds_bitset_t *self, size_t from);
+
+/**
+ * @brief Build the index used by `cds_bitset_rank` and `cds_bitset_select`.
+ * The index takes a quarter as much memory as the bits plus a word for every
+ * `CDS_BITSET_SELECT_SAMPLE` set bits.
+ *
+ * @param self The bitset.
+ *
+ * @return cds_status_t The status code of this operation.
+ */
+CDS_PUBLIC
+cds_status_t cds_bitset_build_index(cds_bitset_t *self);
+
+/**
+ * @brief Count the set bits before an index in constant time.
+ *
+ * @param self The bitset, whose index must be up to date.
+ * @param index The index, which may be the length of the bitset.
+ * @param result Where the number of set bits before `index` is written.
+ *
+ * @return cds_status_t The status code of this operation. `cds_error` if the
+ * index has not been built since the bitset last changed. `cds_index_error`
+ * if `index` is past the end.
+ */
+CDS_PUBLIC
+cds_status_t cds_bitset_rank(
+    const cds_bitset_t *self,
+    size_t index,
+    size_t *result
+);
+
+/**
+ * @brief Find the index of the set bit which has `rank` set bits before it.
+ * This looks up a select sample and binary searches the blocks between it and
+ * the next sample, which is a handful of steps unless the set bits are very
+ * sparse.
+ *
+ * @param self The bitset, whose index must be up to date.
+ * @param rank The number of set bits before the one to find.
+ * @param result Where the index of the set bit is written.
+ *
+ * @return cds_status_t The status code of this operation. `cds_error` if the
+ * index has not been built since the bitset last changed. `cds_index_error`
+ * if there are not more than `rank` set bits.
+ */
+CDS_PUBLIC
+cds_status_t cds_bitset_select(
+    const cds_bitset_t *self,
+    size_t rank,
+    size_t *result
+);
+
+#endif
\ No newline at end of file
@@ -3,9 +3,13 @@
 
 #   include "_prelude.h"
 #   include "_common.h"
+#   include "allocator.h"
 #   ifdef CDS_USE_ALLOC_LIB
 #       include "alloc.h"
 #   endif
+#   include "growth.h"
+#   include "serialize.h"
+#   include "sort.h"
 #   include "utils.h"
 #   ifdef CDS_DEBUG
 #       include <stdio.h>
@@ -19,11 +23,146 @@
  */
 typedef cds_ptr_t cds_buffer_t;
 
+/**
+ * @brief The largest alignment that can be requested for the elements of a
+ * buffer using `cds_buffer_init_aligned`.
+ */
+#   define CDS_BUFFER_MAX_ALIGNMENT 4096
+
+enum _cds_buffer_flag_t {
+    /**
+     * @brief The buffer is used as a ring (double-ended queue). Elements are
+     * stored starting from `cds_buffer_header_t::head` and wrap around to the
+     * start of the array, so inserting or removing elements at either end of
+     * the buffer takes amortised O(1) time.
+     */
+    cds_buffer_ring = 0x1,
+    /**
+     * @brief The buffer lives in a memory-mapped file created by
+     * `cds_buffer_map_file`.
+     */
+    cds_buffer_mapped = 0x2,
+    /**
+     * @brief The buffer is a memory-mapped file whose changes are written back
+     * to the file.
+     */
+    cds_buffer_mapped_shared = 0x4
+};
+
+enum _cds_buffer_map_flag_t {
+    /**
+     * @brief Map the file so that changes to the buffer are written back to
+     * the file and the buffer can grow. Without this flag, the file is opened
+     * read-only and the buffer is a private copy-on-write view of it which
+     * cannot grow beyond the file's size.
+     */
+    cds_buffer_map_writable = 0x1,
+    /**
+     * @brief Create the file if it does not exist. An empty file is turned
+     * into an empty buffer. Requires `cds_buffer_map_writable`.
+     */
+    cds_buffer_map_create = 0x2
+};
+
+/**
+ * @brief Options for `cds_buffer_map_file`.
+ */
+typedef enum _cds_buffer_map_flag_t cds_buffer_map_flag_t;
+
+/**
+ * @brief The first 4 bytes of a file storing a memory-mapped buffer ("CDSM" in
+ * a little-endian file).
+ */
+#   define CDS_BUFFER_FILE_MAGIC UINT32_C(0x4D534443)
+
+/**
+ * @brief The version of the memory-mapped file format written by this
+ * library.
+ */
+#   define CDS_BUFFER_FILE_VERSION 1
+
+struct _cds_buffer_file_header_t {
+    uint32_t magic;
+    uint16_t version;
+    /**
+     * @brief `CDS_SERIAL_ENDIAN_MARKER` in the byte order of the machine
+     * which wrote the file.
+     */
+    uint16_t endian_marker;
+    /**
+     * @brief The number of bytes before the first element, which is a
+     * multiple of the page size so that the elements can be mapped on their
+     * own.
+     */
+    uint64_t header_size;
+    uint64_t type_size;
+    uint64_t length;
+    uint64_t head;
+    /**
+     * @brief The `cds_buffer_flag_t` options stored with the elements. Only
+     * `cds_buffer_ring` is kept.
+     */
+    uint64_t flags;
+};
+
+/**
+ * @brief The fixed prefix at the start of a file storing a memory-mapped
+ * buffer. Only the fields which describe the elements are stored, and they
+ * are written when the buffer is synced or closed. Everything else in
+ * `cds_buffer_header_t` only means something to the process which mapped the
+ * file, so it is kept in private memory instead.
+ */
+typedef struct _cds_buffer_file_header_t cds_buffer_file_header_t;
+
+/**
+ * @brief Options which change how a buffer stores its elements. These are
+ * combined into `cds_buffer_header_t::flags`.
+ */
+typedef enum _cds_buffer_flag_t cds_buffer_flag_t;
+
 struct _cds_buffer_header_t {
     size_t type_size;
     size_t length;
     size_t reserved;
     size_t bytes_allocated;
+    const cds_growth_policy_t *policy;
+    size_t head;
+    cds_flag_t flags;
+    /**
+     * @brief How many times the length of the buffer fell below the growth
+     * policy's shrink percentage of its capacity without the buffer giving
+     * memory back, e.g. because of the shrink floor. Each fall counts once,
+     * not every removal made below the threshold.
+     */
+    size_t shrinks_avoided;
+    /**
+     * @brief The alignment of the first element in bytes, or 0 if the buffer
+     * only has the alignment given by the allocator.
+     */
+    size_t alignment;
+    /**
+     * @brief The number of bytes between the start of the allocated memory
+     * block and the header, used to align the elements.
+     */
+    size_t padding;
+    /**
+     * @brief The allocator which owns the memory block storing the buffer.
+     * NULL means `CDS_DEFAULT_ALLOCATOR`.
+     */
+    const cds_allocator_t *allocator;
+    /**
+     * @brief The file descriptor of the file backing a memory-mapped buffer.
+     * -1 if the buffer is not memory-mapped. The header of a mapped buffer
+     * is in private memory in front of the mapped elements, so this is never
+     * seen by other processes mapping the same file.
+     */
+    int fd;
+    /**
+     * @brief The number of owners sharing this buffer through
+     * `cds_buffer_share`. A buffer which is shared is copied before it is
+     * changed.
+     */
+    size_t refcount;
 };
 
 /**
@@ -46,7 +185,9 @@ typedef struct _cds_buffer_data_t cds_buffer_data_t;
 
 #   ifdef CDS_USE_ALLOC_LIB
 /**
- * @brief Memory allocation configuration data for `cds_buffer_t`.
+ * @brief Memory allocation configuration data for `cds_buffer_t`, for sizing
+ * blocks with the alloc library. Buffers themselves size their blocks with
+ * their growth policy.
  */
 CDS_PUBLIC const cds_alloc_config_t CDS_BUFFER_DATA_ALLOC_CONFIG;
 #   endif
@@ -105,7 +246,10 @@ cds_buffer_data_t *cds_buffer_get_data(cds_buffer_t buffer) {
     applier(type_size) \
     applier(length) \
     applier(reserved) \
-    applier(bytes_allocated)
+    applier(bytes_allocated) \
+    applier(head) \
+    applier(shrinks_avoided) \
+    applier(alignment)
 
 #define _SIZE_T_GETTER(field) \
     CDS_INLINE \
@@ -140,6 +284,19 @@ size_t cds_buffer_required_bytes(cds_buffer_data_t *self, size_t length);
 CDS_PUBLIC
 cds_buffer_t cds_buffer_new(void);
 
+/**
+ * @brief Create a new uninitialised buffer object whose memory comes from a
+ * custom allocator. The allocator is used for all future allocations made by
+ * the buffer, so it must outlive the buffer.
+ * 
+ * @param allocator The allocator. If NULL, `CDS_DEFAULT_ALLOCATOR` is used.
+ * 
+ * @return cds_buffer_t The pointer to the buffer (not including the preceding
+ * buffer metadata).
+ */
+CDS_PUBLIC
+cds_buffer_t cds_buffer_new_with_allocator(const cds_allocator_t *allocator);
+
 /**
  * @brief Initialise the buffer object with the size of the type. In addition,
  * the buffer object will be of 0 length.
@@ -158,13 +315,85 @@ cds_buffer_t cds_buffer_new(void);
 CDS_PUBLIC
 cds_status_t cds_buffer_init(cds_buffer_t *buffer, size_t type_size);
 
+/**
+ * @brief Initialise the buffer object with the size of the type and a growth
+ * policy which decides how much the buffer grows when it runs out of space.
+ * The buffer only stores a pointer to the policy, so the policy must outlive
+ * the buffer.
+ * 
+ * @see cds_buffer_init
+ * 
+ * @param buffer The buffer to be initialised.
+ * @param type_size The size of the type of data to be stored.
+ * @param policy The growth policy. If NULL, `CDS_DEFAULT_GROWTH_POLICY` is
+ * used.
+ * 
+ * @return cds_status_t The status code for this operation.
+ */
+CDS_PUBLIC
+cds_status_t cds_buffer_init_with_policy(
+    cds_buffer_t *buffer,
+    size_t type_size,
+    const cds_growth_policy_t *policy
+);
+
+/**
+ * @brief Initialise the buffer object with the size of the type and a custom
+ * allocator which all future allocations made by the buffer go through. If
+ * the buffer was created with a different allocator, it is moved into memory
+ * owned by `allocator`. The allocator must outlive the buffer.
+ * 
+ * @see cds_buffer_init
+ * 
+ * @param buffer The buffer to be initialised.
+ * @param type_size The size of the type of data to be stored.
+ * @param allocator The allocator. If NULL, `CDS_DEFAULT_ALLOCATOR` is used.
+ * 
+ * @return cds_status_t The status code for this operation.
+ */
+CDS_PUBLIC
+cds_status_t cds_buffer_init_with_allocator(
+    cds_buffer_t *buffer,
+    size_t type_size,
+    const cds_allocator_t *allocator
+);
+
+/**
+ * @brief Initialise the buffer object so that its first element is aligned to
+ * `alignment` bytes, for example to the size of a cache line (64) or an AVX
+ * register (32). The header is padded to achieve this, and the alignment is
+ * kept whenever the buffer is reallocated, including by `cds_buffer_reserve`
+ * and `cds_buffer_compact`. Every element is aligned if `type_size` is a
+ * multiple of `alignment`.
+ * 
+ * @see cds_buffer_init
+ * 
+ * @param buffer The buffer to be initialised.
+ * @param type_size The size of the type of data to be stored.
+ * @param alignment The alignment in bytes. This must be a power of 2 which is
+ * not greater than `CDS_BUFFER_MAX_ALIGNMENT`.
+ * 
+ * @return cds_status_t The status code for this operation.
+ */
+CDS_PUBLIC
+cds_status_t cds_buffer_init_aligned(
+    cds_buffer_t *buffer,
+    size_t type_size,
+    size_t alignment
+);
+
 /**
  * @brief Destroy all the data stored in the buffer, clearing the entire
  * buffer to length 0 without freeing the memory storing the buffer metadata.
+ * The buffer keeps as much memory as its growth policy allows, so use
+ * `cds_buffer_compact` afterwards if you want to give all of it back.
  * 
  * This function uses another function (called `clean_element`) to clean each
  * element of data in the buffer.
  * 
+ * If the buffer is shared, the caller gets a new empty buffer instead and
+ * `clean_element` is not called, as the other owners still use the elements.
+ * 
  * @param buffer The buffer to clear.
  * @param clean_element The function used to clean each element.
  * 
@@ -179,6 +408,12 @@ cds_status_t cds_buffer_destroy(cds_buffer_t *buffer, cds_free_f clean_element);
  * This function uses another function (called `clean_element`) to clean each
  * element of data in the buffer.
  * 
+ * Memory-mapped buffers are unmapped and their files closed instead. Their
+ * elements are left in the file and `clean_element` is not called.
+ * 
+ * If the buffer is shared, only the caller's reference is dropped and
+ * `clean_element` is not called. The last owner to free it frees the memory.
+ * 
  * @param buffer The buffer to clear.
  * @param clean_element The function used to clean each element.
  * 
@@ -187,6 +422,83 @@ cds_status_t cds_buffer_destroy(cds_buffer_t *buffer, cds_free_f clean_element);
 CDS_PUBLIC
 cds_status_t cds_buffer_free(cds_buffer_t buffer, cds_free_f clean_element);
 
+/**
+ * @brief Share a buffer with another owner without copying it. Both owners
+ * can read from the buffer, and each owner frees its own reference with
+ * `cds_buffer_free`. Every function that changes the buffer, such as
+ * `cds_buffer_insert`, `cds_buffer_remove` or `cds_buffer_reserve`, first
+ * gives the owner calling it a private copy if the buffer is still shared,
+ * so changes are never seen by the other owners.
+ * 
+ * Elements are copied byte by byte, so the owners of a buffer of pointers
+ * share the objects being pointed to. The reference count is updated
+ * atomically, so owners in different threads can share and free the same
+ * buffer at once.
+ * 
+ * Writing to an element through the pointer from `cds_buffer_get` changes it
+ * for every owner. Call `cds_buffer_make_unique` first to avoid that.
+ * 
+ * @param buffer The buffer to share.
+ * 
+ * @return cds_buffer_t The buffer for the new owner, which is the same
+ * pointer as `buffer`. NULL if the buffer is NULL or memory-mapped.
+ */
+CDS_PUBLIC
+cds_buffer_t cds_buffer_share(cds_buffer_t buffer);
+
+/**
+ * @brief Check whether a buffer has more than one owner.
+ * 
+ * @param buffer The buffer.
+ * 
+ * @return bool Whether the buffer is shared. false if the buffer is NULL.
+ */
+CDS_PUBLIC
+bool cds_buffer_is_shared(cds_buffer_t buffer);
+
+/**
+ * @brief Give the caller a private copy of a shared buffer. This does nothing
+ * if the buffer only has one owner.
+ * 
+ * @param buffer The buffer.
+ * 
+ * @return cds_status_t The status code of this operation.
+ */
+CDS_PUBLIC
+cds_status_t cds_buffer_make_unique(cds_buffer_t *buffer);
+
+/**
+ * @brief Swap 2 buffers without copying their elements.
+ * 
+ * @param buffer The buffer.
+ * @param other The other buffer.
+ * 
+ * @return cds_status_t The status code of this operation.
+ */
+CDS_PUBLIC
+cds_status_t cds_buffer_swap(cds_buffer_t *buffer, cds_buffer_t *other);
+
+/**
+ * @brief Move every element of `other` to the end of `buffer`, leaving
+ * `other` empty. If `buffer` is empty, the 2 buffers are swapped instead, so
+ * no elements are copied and `buffer` takes over the growth policy,
+ * allocator, alignment and ring setting of `other`. Memory-mapped buffers are
+ * never swapped. Otherwise the elements are copied over in one go, or in 2
+ * parts if they wrap around the end of a ring buffer.
+ * 
+ * A dynbuffer cannot adopt an array allocated elsewhere the way
+ * `cds_vector_adopt` does, as its header is stored in front of its elements.
+ * 
+ * @param buffer The buffer to append to.
+ * @param other The buffer to move the elements out of, which must have the
+ * same type size.
+ * 
+ * @return cds_status_t The status code of this operation. `cds_error` if the
+ * type sizes differ or both are the same buffer.
+ */
+CDS_PUBLIC
+cds_status_t cds_buffer_append_move(cds_buffer_t *buffer, cds_buffer_t *other);
+
 
 /**
  * @brief Increase the size of the buffer so that it can fit an additional
@@ -234,6 +546,49 @@ cds_status_t cds_buffer_insert(
 );
 
 
+/**
+ * @brief Insert `count` items into the buffer starting at the specified
+ * index. The buffer only reserves memory and shifts the elements after
+ * `index` once, so this is much faster than calling `cds_buffer_insert`
+ * `count` times.
+ * 
+ * @param buffer The buffer which you want to insert the elements into.
+ * @param index The position of the first new element.
+ * @param src A pointer to an array of `count` elements to be copied into the
+ * buffer. This must not point into the buffer itself.
+ * @param count The number of elements to insert.
+ * 
+ * @return cds_status_t The status code of this operation.
+ */
+CDS_PUBLIC
+cds_status_t cds_buffer_insert_range(
+    cds_buffer_t *buffer,
+    size_t index,
+    cds_ptr_t src,
+    size_t count
+);
+
+
+/**
+ * @brief Append `count` items to the end of the buffer.
+ * 
+ * @see cds_buffer_insert_range
+ * 
+ * @param buffer The buffer which you want to append the elements to.
+ * @param src A pointer to an array of `count` elements to be copied into the
+ * buffer. This must not point into the buffer itself.
+ * @param count The number of elements to append.
+ * 
+ * @return cds_status_t The status code of this operation.
+ */
+CDS_PUBLIC
+cds_status_t cds_buffer_extend(
+    cds_buffer_t *buffer,
+    cds_ptr_t src,
+    size_t count
+);
+
+
 /**
  * @brief Insert an item to the start of the buffer.
  * 
@@ -258,6 +613,34 @@ CDS_PUBLIC
 cds_status_t cds_buffer_push_back(cds_buffer_t *buffer, cds_ptr_t src);
 
 
+/**
+ * @brief Add an uninitialised element to the end of the buffer and get a
+ * pointer to it, so that the element can be written in place instead of
+ * being built somewhere else and copied in.
+ * 
+ * @param buffer The buffer.
+ * 
+ * @return cds_ptr_t The pointer to the new element, which is valid until the
+ * buffer is changed. NULL if the buffer is NULL or could not grow.
+ */
+CDS_PUBLIC
+cds_ptr_t cds_buffer_emplace_back(cds_buffer_t *buffer);
+
+
+/**
+ * @brief Change the length of the buffer in one step without touching the
+ * elements. New elements at the end are left uninitialised, and elements
+ * removed from the end are not cleaned up.
+ * 
+ * @param buffer The buffer.
+ * @param length The new length.
+ * 
+ * @return cds_status_t The status code of this operation.
+ */
+CDS_PUBLIC
+cds_status_t cds_buffer_resize_uninit(cds_buffer_t *buffer, size_t length);
+
+
 /**
  * @brief Remove an item in the buffer at a specified index. As you may want
  * to use the item's data somewhere else, you can pass in a pointer to the
@@ -278,6 +661,96 @@ cds_status_t cds_buffer_remove(
 );
 
 
+/**
+ * @brief Remove `count` items from the buffer starting at the specified
+ * index. The elements after the removed range are shifted only once.
+ * 
+ * @see cds_buffer_remove
+ * 
+ * @param buffer The buffer you want to remove the items from.
+ * @param index The index of the first element to remove.
+ * @param count The number of elements to remove.
+ * @param dest The destination array which the removed elements are copied
+ * to. It must be able to hold `count` elements. If the pointer is NULL, then
+ * no data will be copied over.
+ * @return cds_status_t The status code of this operation.
+ */
+CDS_PUBLIC
+cds_status_t cds_buffer_remove_range(
+    cds_buffer_t *buffer,
+    size_t index,
+    size_t count,
+    cds_ptr_t dest
+);
+
+
+/**
+ * @brief Remove the item at the specified index by moving the last item into
+ * its place. This takes O(1) time but does not preserve the order of the
+ * elements. The data of the removed element is copied to `dest` if it's not
+ * NULL.
+ * 
+ * @see cds_buffer_remove
+ * 
+ * @param buffer The buffer you want to remove the item from.
+ * @param index The index of the element to remove.
+ * @param dest The destination pointer for the removed data.
+ * @return cds_status_t The status code of this operation.
+ */
+CDS_PUBLIC
+cds_status_t cds_buffer_swap_remove(
+    cds_buffer_t *buffer,
+    size_t index,
+    cds_ptr_t dest
+);
+
+
+/**
+ * @brief Keep only the elements for which `predicate` returns true. The
+ * buffer is compacted in a single pass and the order of the remaining
+ * elements is preserved.
+ * 
+ * @param buffer The buffer to filter.
+ * @param predicate The function called with a pointer to each element and
+ * `context`.
+ * @param context The user-provided pointer passed on to `predicate`.
+ * @param clean_element The function called with a pointer to each discarded
+ * element. If NULL, discarded elements are just overwritten.
+ * @return cds_status_t The status code of this operation.
+ */
+CDS_PUBLIC
+cds_status_t cds_buffer_retain(
+    cds_buffer_t *buffer,
+    cds_predicate_f predicate,
+    cds_ptr_t context,
+    cds_free_f clean_element
+);
+
+
+/**
+ * @brief Remove all the elements for which `predicate` returns true. The
+ * buffer is compacted in a single pass and the order of the remaining
+ * elements is preserved.
+ * 
+ * @see cds_buffer_retain
+ * 
+ * @param buffer The buffer to filter.
+ * @param predicate The function called with a pointer to each element and
+ * `context`.
+ * @param context The user-provided pointer passed on to `predicate`.
+ * @param clean_element The function called with a pointer to each removed
+ * element. If NULL, removed elements are just overwritten.
+ * @return cds_status_t The status code of this operation.
+ */
+CDS_PUBLIC
+cds_status_t cds_buffer_remove_if(
+    cds_buffer_t *buffer,
+    cds_predicate_f predicate,
+    cds_ptr_t context,
+    cds_free_f clean_element
+);
+
+
 /**
  * @brief Remove the first item in the buffer. The data of the now deleted
  * element will be copied to `dest` if it's not NULL.
@@ -305,4 +778,228 @@ cds_status_t cds_buffer_pop_front(cds_buffer_t *buffer, cds_ptr_t dest);
 CDS_PUBLIC
 cds_status_t cds_buffer_pop_back(cds_buffer_t *buffer, cds_ptr_t dest);
 
+/**
+ * @brief Get a pointer to the element at a certain index. Unlike indexing the
+ * buffer directly, this works for buffers in ring mode too.
+ * 
+ * @param buffer The buffer.
+ * @param index The index of the element.
+ * 
+ * @return cds_ptr_t The pointer to the element. NULL if the buffer is NULL or
+ * the index is out of bounds.
+ */
+CDS_PUBLIC
+cds_ptr_t cds_buffer_get(cds_buffer_t buffer, size_t index);
+
+
+/**
+ * @brief Check whether the buffer is in ring mode.
+ * 
+ * @param buffer The buffer.
+ * 
+ * @return bool Whether the buffer is in ring mode. false if the buffer is
+ * NULL.
+ */
+CDS_PUBLIC
+bool cds_buffer_is_ring(cds_buffer_t buffer);
+
+
+/**
+ * @brief Turn ring mode on or off. In ring mode, `cds_buffer_push_front`,
+ * `cds_buffer_pop_front`, `cds_buffer_push_back` and `cds_buffer_pop_back`
+ * all take amortised O(1) time, which makes the buffer suitable as a FIFO
+ * queue. However, the elements may wrap around the end of the array, so you
+ * must access them using `cds_buffer_get` instead of indexing the buffer
+ * directly, or call `cds_buffer_linearize` first.
+ * 
+ * Turning ring mode off linearizes the buffer.
+ * 
+ * @param buffer The buffer.
+ * @param enabled Whether ring mode should be on.
+ * 
+ * @return cds_status_t The status code of this operation.
+ */
+CDS_PUBLIC
+cds_status_t cds_buffer_set_ring(cds_buffer_t *buffer, bool enabled);
+
+
+/**
+ * @brief Move the elements of the buffer so that the first element is at the
+ * start of the array and all elements are contiguous. After this, the buffer
+ * can be indexed directly until the next time an element is added to or
+ * removed from the front of a ring buffer. This does nothing to buffers that
+ * are already linear.
+ * 
+ * @param buffer The buffer.
+ * 
+ * @return cds_status_t The status code of this operation.
+ */
+CDS_PUBLIC
+cds_status_t cds_buffer_linearize(cds_buffer_t *buffer);
+
+
+
+/**
+ * @brief Sort the elements of the buffer in place using `cds_sort`. Ring
+ * buffers are linearized first.
+ * 
+ * @see cds_sort
+ * 
+ * @param buffer The buffer.
+ * @param compare The function which compares 2 elements.
+ * 
+ * @return cds_status_t The status code of this operation.
+ */
+CDS_PUBLIC
+cds_status_t cds_buffer_sort(cds_buffer_t *buffer, cds_compare_f compare);
+
+
+/**
+ * @brief Find the index of the first element in a sorted buffer which is not
+ * lesser than `key`. Wrapped ring buffers do not need to be linearized first.
+ * 
+ * @param buffer The sorted buffer.
+ * @param key The pointer to the element to search for.
+ * @param compare The function which compares 2 elements.
+ * 
+ * @return size_t The index of the element. The length of the buffer if every
+ * element is lesser than `key`.
+ */
+CDS_PUBLIC
+size_t cds_buffer_lower_bound(
+    cds_buffer_t buffer,
+    cds_ptr_t key,
+    cds_compare_f compare
+);
+
+
+/**
+ * @brief Find the index of the first element in a sorted buffer which is
+ * greater than `key`. Wrapped ring buffers do not need to be linearized first.
+ * 
+ * @param buffer The sorted buffer.
+ * @param key The pointer to the element to search for.
+ * @param compare The function which compares 2 elements.
+ * 
+ * @return size_t The index of the element. The length of the buffer if no
+ * element is greater than `key`.
+ */
+CDS_PUBLIC
+size_t cds_buffer_upper_bound(
+    cds_buffer_t buffer,
+    cds_ptr_t key,
+    cds_compare_f compare
+);
+
+
+#   define _CDS_BUFFER_RADIX_SORT_DECLARE(stn, ltn) \
+    CDS_PUBLIC cds_status_t \
+    cds_buffer_radix_sort_##stn(cds_buffer_t *buffer, size_t key_offset);
+
+/**
+ * @brief Generates `cds_buffer_radix_sort_<type>(buffer, key_offset)` for each
+ * type in `CDS_INTEGER_TYPES`, which radix sorts the elements of the buffer
+ * by a key of that type found `key_offset` bytes into each element. Ring
+ * buffers are linearized first.
+ * 
+ * @see cds_radix_sort
+ */
+CDS_INTEGER_TYPES(_CDS_BUFFER_RADIX_SORT_DECLARE)
+
+#   undef _CDS_BUFFER_RADIX_SORT_DECLARE
+
+
+/**
+ * @brief Open a buffer stored in a file by mapping the file into memory. The
+ * file starts with a `cds_buffer_file_header_t` padded to a whole number of
+ * pages, followed by the elements, so the elements can be used straight away
+ * without being parsed or copied, and their pages are shared with every
+ * other process mapping the same file. When the buffer grows, the file is
+ * extended and mapped again.
+ * 
+ * The buffer's header is a private copy in front of the mapped elements.
+ * The length, head and ring mode are read from the file when it is mapped
+ * and written back by `cds_buffer_sync` and `cds_buffer_free`.
+ * 
+ * The file must have been written by a mapped buffer on a machine with the
+ * same endianness, and its header size must be a multiple of this machine's
+ * page size. Mapped buffers cannot be aligned or use custom allocators. The
+ * buffer must be closed using `cds_buffer_free`.
+ * 
+ * @param path The path to the file.
+ * @param type_size The size of each element, which must match the size
+ * stored in the file.
+ * @param flags A combination of `cds_buffer_map_flag_t` options.
+ * 
+ * @return cds_buffer_t The mapped buffer. NULL if the file could not be
+ * opened or mapped, does not contain a valid buffer, or if memory-mapped
+ * files are not supported on this platform.
+ */
+CDS_PUBLIC
+cds_buffer_t cds_buffer_map_file(
+    const char *path,
+    size_t type_size,
+    cds_flag_t flags
+);
+
+
+/**
+ * @brief Write the changes made to a writable memory-mapped buffer and its
+ * length back to its file and wait until they have been written. This does
+ * nothing to read-only mapped buffers.
+ * 
+ * @param buffer The mapped buffer.
+ * 
+ * @return cds_status_t The status code of this operation. `cds_error` if the
+ * buffer is not memory-mapped or the changes could not be written.
+ */
+CDS_PUBLIC
+cds_status_t cds_buffer_sync(cds_buffer_t buffer);
+
+
+/**
+ * @brief Check whether the buffer lives in a memory-mapped file.
+ * 
+ * @param buffer The buffer.
+ * 
+ * @return bool
+ */
+CDS_PUBLIC
+bool cds_buffer_is_mapped(cds_buffer_t buffer);
+
+
+/**
+ * @brief Save the buffer to a file as a `cds_serial_header_t` followed by its
+ * elements, which are written using a single `fwrite`, or 2 if the elements
+ * of a ring buffer wrap around. The buffer is not changed, so it can be
+ * written while other owners read from it.
+ * 
+ * @param buffer The buffer.
+ * @param file The file to write to.
+ * 
+ * @return cds_status_t The status code of this operation. `cds_error` if
+ * the file could not be written to.
+ */
+CDS_PUBLIC
+cds_status_t cds_buffer_write(cds_buffer_t buffer, FILE *file);
+
+
+/**
+ * @brief Load a buffer saved by `cds_buffer_write` or `cds_vector_write`.
+ * The current elements of the buffer are discarded without being cleaned,
+ * then the buffer is grown to the saved length and the elements are read
+ * straight into it using a single `fread`.
+ * 
+ * @param buffer The initialised buffer, whose type size must match the size
+ * of the saved elements.
+ * @param file The file to read from.
+ * 
+ * @return cds_status_t The status code of this operation. `cds_error` if
+ * the file is not a saved container of the same type size and endianness,
+ * is truncated or fails its checksum, in which case the buffer is left
+ * empty.
+ */
+CDS_PUBLIC
+cds_status_t cds_buffer_read(cds_buffer_t *buffer, FILE *file);
+
 #endif
\ No newline at end of file
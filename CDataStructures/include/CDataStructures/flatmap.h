@@ -0,0 +1,238 @@
+/**
+ * @file flatmap.h
+ * @author RenoirTan
+ * @brief A header defining a flat map, an ordered map which keeps its entries
+ * sorted by key in a single vector.
+ *
+ * Lookups binary search contiguous memory and iterating over the map is a
+ * linear scan, so a flat map is much friendlier to the cache than a tree for
+ * small and medium maps which are read more often than they are changed.
+ * Inserting or removing one entry moves every entry after it, so many entries
+ * should be added at once with `cds_flatmap_build` or
+ * `cds_flatmap_insert_batch`.
+ * @version 0.1
+ * @date 2021-07-09
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#ifndef CDATASTRUCTURES_FLATMAP_H
+#   define CDATASTRUCTURES_FLATMAP_H
+
+#   include "_prelude.h"
+#   include "_common.h"
+#   include "vector.h"
+
+struct _cds_flatmap_t {
+    /**
+     * @brief The entries sorted by key. Each entry is a key followed by its
+     * value, which starts `value_offset` bytes into the entry.
+     */
+    cds_vector_t entries;
+    size_t key_size;
+    size_t value_size;
+    size_t value_offset;
+    /**
+     * @brief The function which compares 2 keys.
+     */
+    cds_compare_f compare;
+};
+
+/**
+ * @brief A map from keys to values whose entries are sorted by key in a
+ * vector. Keys are unique.
+ */
+typedef struct _cds_flatmap_t cds_flatmap_t;
+
+/**
+ * @brief Initialise an empty flat map.
+ *
+ * @param self The flat map.
+ * @param key_size The size of each key in bytes.
+ * @param value_size The size of each value in bytes. If 0, the map is a
+ * sorted set of keys.
+ * @param compare The function which compares 2 keys.
+ *
+ * @return cds_status_t The status code of this operation.
+ */
+CDS_PUBLIC
+cds_status_t cds_flatmap_init(
+    cds_flatmap_t *self,
+    size_t key_size,
+    size_t value_size,
+    cds_compare_f compare
+);
+
+/**
+ * @brief Free the entries of a flat map.
+ *
+ * @param self The flat map.
+ * @param clean_key The function which cleans up each key. If NULL, the keys
+ * are not cleaned up.
+ * @param clean_value The function which cleans up each value. If NULL, the
+ * values are not cleaned up.
+ *
+ * @return cds_status_t The status code of this operation.
+ */
+CDS_PUBLIC
+cds_status_t cds_flatmap_destroy(
+    cds_flatmap_t *self,
+    cds_free_f clean_key,
+    cds_free_f clean_value
+);
+
+/**
+ * @brief Get the number of entries in a flat map.
+ *
+ * @param self The flat map.
+ * @return size_t The number of entries.
+ */
+CDS_INLINE size_t cds_flatmap_length(const cds_flatmap_t *self) {
+    return self->entries.length;
+}
+
+/**
+ * @brief Get the key of the entry at an index. Entries are sorted by key, so
+ * this can be used to iterate over the map in order.
+ *
+ * @param self The flat map.
+ * @param index The index of the entry, which must be less than the length.
+ * @return cds_ptr_t The pointer to the key.
+ */
+CDS_INLINE cds_ptr_t cds_flatmap_key_at(
+    const cds_flatmap_t *self,
+    size_t index
+) {
+    return self->entries.buffer + index * self->entries.type_size;
+}
+
+/**
+ * @brief Get the value of the entry at an index.
+ *
+ * @param self The flat map.
+ * @param index The index of the entry, which must be less than the length.
+ * @return cds_ptr_t The pointer to the value.
+ */
+CDS_INLINE cds_ptr_t cds_flatmap_value_at(
+    const cds_flatmap_t *self,
+    size_t index
+) {
+    return self->entries.buffer
+        + index * self->entries.type_size
+        + self->value_offset;
+}
+
+/**
+ * @brief Find the index of the first entry whose key is not lesser than
+ * `key`. The binary search picks the next half without a branch and
+ * prefetches both entries it may look at next.
+ *
+ * @param self The flat map.
+ * @param key The pointer to the key.
+ * @return size_t The index of the entry. The length of the map if every key
+ * is lesser than `key`.
+ */
+CDS_PUBLIC
+size_t cds_flatmap_lower_bound(const cds_flatmap_t *self, cds_ptr_t key);
+
+/**
+ * @brief Find the value of a key.
+ *
+ * @param self The flat map.
+ * @param key The pointer to the key.
+ * @return cds_ptr_t The pointer to the value, which stays valid until the map
+ * is changed. NULL if the key is not in the map.
+ */
+CDS_PUBLIC
+cds_ptr_t cds_flatmap_find(const cds_flatmap_t *self, cds_ptr_t key);
+
+/**
+ * @brief Check whether a key is in a flat map.
+ *
+ * @param self The flat map.
+ * @param key The pointer to the key.
+ * @return bool Whether the key is in the map.
+ */
+CDS_PUBLIC
+bool cds_flatmap_contains(const cds_flatmap_t *self, cds_ptr_t key);
+
+/**
+ * @brief Insert an entry, replacing the value if the key is already in the
+ * map. This moves every entry after the new one.
+ *
+ * @param self The flat map.
+ * @param key The pointer to the key.
+ * @param value The pointer to the value. Ignored if the value size is 0.
+ *
+ * @return cds_status_t The status code of this operation.
+ */
+CDS_PUBLIC
+cds_status_t cds_flatmap_insert(
+    cds_flatmap_t *self,
+    cds_ptr_t key,
+    cds_ptr_t value
+);
+
+/**
+ * @brief Remove the entry with a key.
+ *
+ * @param self The flat map.
+ * @param key The pointer to the key.
+ * @param dest If not NULL, where the removed value is copied to.
+ *
+ * @return cds_status_t The status code of this operation. `cds_index_error`
+ * if the key is not in the map.
+ */
+CDS_PUBLIC
+cds_status_t cds_flatmap_remove(
+    cds_flatmap_t *self,
+    cds_ptr_t key,
+    cds_ptr_t dest
+);
+
+/**
+ * @brief Replace the entries of a flat map with unsorted keys and values.
+ * The entries are merge sorted and then duplicate keys are removed, keeping
+ * the value which came last in the input. The old entries are dropped
+ * without being cleaned up.
+ *
+ * @param self The flat map.
+ * @param keys The array of keys.
+ * @param values The array of values, in the same order as the keys. Ignored
+ * if the value size is 0.
+ * @param count The number of keys.
+ *
+ * @return cds_status_t The status code of this operation.
+ */
+CDS_PUBLIC
+cds_status_t cds_flatmap_build(
+    cds_flatmap_t *self,
+    cds_ptr_t keys,
+    cds_ptr_t values,
+    size_t count
+);
+
+/**
+ * @brief Insert many unsorted entries at once. The new entries are sorted on
+ * their own and then merged into the map from the back, so every old entry
+ * is moved once. A new value replaces the old value of the same key, and
+ * duplicate keys in the input keep the value which came last.
+ *
+ * @param self The flat map.
+ * @param keys The array of keys.
+ * @param values The array of values, in the same order as the keys. Ignored
+ * if the value size is 0.
+ * @param count The number of keys.
+ *
+ * @return cds_status_t The status code of this operation.
+ */
+CDS_PUBLIC
+cds_status_t cds_flatmap_insert_batch(
+    cds_flatmap_t *self,
+    cds_ptr_t keys,
+    cds_ptr_t values,
+    size_t count
+);
+
+#endif
\ No newline at end of file
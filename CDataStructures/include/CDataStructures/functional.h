@@ -23,7 +23,11 @@
 #   include "_common.h"
 #   include "type.h"
 
-#   define TS(applier) \
+/**
+ * @brief Apply `applier(short_name, type)` to each of the primitive integer
+ * types. Other headers use this to generate functions for each integer type.
+ */
+#   define CDS_INTEGER_TYPES(applier) \
     applier(int8, int8_t) \
     applier(int16, int16_t) \
     applier(int32, int32_t) \
@@ -35,7 +39,10 @@
     applier(char, char) \
     applier(size, size_t) \
     applier(wchar, wchar_t) \
-    applier(byte, cds_byte_t) \
+    applier(byte, cds_byte_t)
+
+#   define TS(applier) \
+    CDS_INTEGER_TYPES(applier) \
     applier(pointer, cds_ptr_t)
 
 #   define F1(stn, ltn)        \
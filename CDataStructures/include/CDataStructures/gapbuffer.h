@@ -0,0 +1,235 @@
+/**
+ * @file gapbuffer.h
+ * @author RenoirTan
+ * @brief A header defining a gap buffer, a sequence which is cheap to edit
+ * around a movable cursor.
+ * @version 0.1
+ * @date 2021-07-09
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#ifndef CDATASTRUCTURES_GAPBUFFER_H
+#   define CDATASTRUCTURES_GAPBUFFER_H
+
+#   include "_prelude.h"
+#   include "_common.h"
+#   include "dynbuffer.h"
+
+struct _cds_gapbuffer_t {
+    /**
+     * @brief The dynbuffer storing the elements. Its length is the number of
+     * elements in the gap buffer, but the elements are split around the gap,
+     * so it must not be used directly.
+     */
+    cds_buffer_t buffer;
+    /**
+     * @brief The slot where the gap starts, which is also the cursor.
+     */
+    size_t gap_start;
+    /**
+     * @brief The slot right after the end of the gap.
+     */
+    size_t gap_end;
+};
+
+/**
+ * @brief A sequence which keeps the unused capacity of its storage as a gap
+ * at the cursor. Elements before the cursor are stored at the start of the
+ * storage and elements after the cursor at the end, so inserting or erasing
+ * elements next to the cursor takes amortised O(1) time and moving the cursor
+ * takes time proportional to the distance it moves.
+ */
+typedef struct _cds_gapbuffer_t cds_gapbuffer_t;
+
+/**
+ * @brief Initialise an empty gap buffer with the cursor at the start.
+ *
+ * @param self The gap buffer.
+ * @param type_size The size of each element in bytes.
+ *
+ * @return cds_status_t The status code of this operation.
+ */
+CDS_PUBLIC
+cds_status_t cds_gapbuffer_init(cds_gapbuffer_t *self, size_t type_size);
+
+/**
+ * @brief Initialise a gap buffer by taking ownership of an initialised
+ * dynbuffer. The cursor is placed after the last element. Ring buffers are
+ * linearized and turned into normal buffers.
+ *
+ * @param self The gap buffer.
+ * @param buffer The dynbuffer, which must not be used afterwards. Memory-mapped
+ * buffers cannot be used.
+ *
+ * @return cds_status_t The status code of this operation.
+ */
+CDS_PUBLIC
+cds_status_t cds_gapbuffer_from_buffer(
+    cds_gapbuffer_t *self,
+    cds_buffer_t buffer
+);
+
+/**
+ * @brief Free the storage of a gap buffer.
+ *
+ * @param self The gap buffer.
+ * @param clean_element The function which cleans up each element. If NULL,
+ * the elements are not cleaned up.
+ *
+ * @return cds_status_t The status code of this operation.
+ */
+CDS_PUBLIC
+cds_status_t cds_gapbuffer_destroy(
+    cds_gapbuffer_t *self,
+    cds_free_f clean_element
+);
+
+/**
+ * @brief Get the number of elements in a gap buffer.
+ *
+ * @param self The gap buffer.
+ *
+ * @return size_t The number of elements. 0 if the gap buffer is NULL.
+ */
+CDS_PUBLIC
+size_t cds_gapbuffer_length(cds_gapbuffer_t *self);
+
+/**
+ * @brief Get the position of the cursor, which is the number of elements
+ * before it.
+ *
+ * @param self The gap buffer.
+ *
+ * @return size_t The position of the cursor. 0 if the gap buffer is NULL.
+ */
+CDS_PUBLIC
+size_t cds_gapbuffer_cursor(cds_gapbuffer_t *self);
+
+/**
+ * @brief Get a pointer to the element at an index.
+ *
+ * @param self The gap buffer.
+ * @param index The index of the element.
+ *
+ * @return cds_ptr_t The pointer to the element, which stays valid until the
+ * gap buffer is changed. NULL if the index is out of range.
+ */
+CDS_PUBLIC
+cds_ptr_t cds_gapbuffer_get(cds_gapbuffer_t *self, size_t index);
+
+/**
+ * @brief Move the cursor to a position. This moves the elements between the
+ * old and new positions across the gap.
+ *
+ * @param self The gap buffer.
+ * @param position The new position of the cursor, at most the length.
+ *
+ * @return cds_status_t The status code of this operation. `cds_index_error`
+ * if the position is past the end of the gap buffer.
+ */
+CDS_PUBLIC
+cds_status_t cds_gapbuffer_move_cursor(
+    cds_gapbuffer_t *self,
+    size_t position
+);
+
+/**
+ * @brief Insert an element at the cursor. The cursor moves past the new
+ * element.
+ *
+ * @param self The gap buffer.
+ * @param src The pointer to the element to copy in.
+ *
+ * @return cds_status_t The status code of this operation.
+ */
+CDS_PUBLIC
+cds_status_t cds_gapbuffer_insert(cds_gapbuffer_t *self, cds_ptr_t src);
+
+/**
+ * @brief Insert an array of elements at the cursor. The cursor moves past the
+ * new elements.
+ *
+ * @param self The gap buffer.
+ * @param src The pointer to the first element to copy in.
+ * @param count The number of elements.
+ *
+ * @return cds_status_t The status code of this operation.
+ */
+CDS_PUBLIC
+cds_status_t cds_gapbuffer_insert_range(
+    cds_gapbuffer_t *self,
+    cds_ptr_t src,
+    size_t count
+);
+
+/**
+ * @brief Erase elements right before the cursor, like pressing backspace.
+ *
+ * @param self The gap buffer.
+ * @param count The number of elements to erase.
+ * @param clean_element The function which cleans up each erased element. If
+ * NULL, the elements are not cleaned up.
+ *
+ * @return cds_status_t The status code of this operation. `cds_index_error`
+ * if there are fewer than `count` elements before the cursor.
+ */
+CDS_PUBLIC
+cds_status_t cds_gapbuffer_erase_before(
+    cds_gapbuffer_t *self,
+    size_t count,
+    cds_free_f clean_element
+);
+
+/**
+ * @brief Erase elements right after the cursor, like pressing delete.
+ *
+ * @param self The gap buffer.
+ * @param count The number of elements to erase.
+ * @param clean_element The function which cleans up each erased element. If
+ * NULL, the elements are not cleaned up.
+ *
+ * @return cds_status_t The status code of this operation. `cds_index_error`
+ * if there are fewer than `count` elements after the cursor.
+ */
+CDS_PUBLIC
+cds_status_t cds_gapbuffer_erase_after(
+    cds_gapbuffer_t *self,
+    size_t count,
+    cds_free_f clean_element
+);
+
+/**
+ * @brief Move the gap to the end and get the storage as a contiguous
+ * dynbuffer. The gap buffer keeps ownership of the dynbuffer, which must not
+ * be changed and is only valid until the gap buffer is changed.
+ *
+ * @param self The gap buffer.
+ * @param buffer Where the dynbuffer is written to.
+ *
+ * @return cds_status_t The status code of this operation.
+ */
+CDS_PUBLIC
+cds_status_t cds_gapbuffer_as_buffer(
+    cds_gapbuffer_t *self,
+    cds_buffer_t *buffer
+);
+
+/**
+ * @brief Move the gap to the end and give up ownership of the storage as a
+ * contiguous dynbuffer, which the caller must free. The gap buffer must be
+ * initialised again before it can be used.
+ *
+ * @param self The gap buffer.
+ * @param buffer Where the dynbuffer is written to.
+ *
+ * @return cds_status_t The status code of this operation.
+ */
+CDS_PUBLIC
+cds_status_t cds_gapbuffer_release(
+    cds_gapbuffer_t *self,
+    cds_buffer_t *buffer
+);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,182 @@
+/**
+ * @file growth.h
+ * @author RenoirTan
+ * @brief A header defining the policy objects which decide how much memory
+ * dynamically sized containers should reserve when they grow or shrink.
+ * @version 0.1
+ * @date 2021-07-09
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#ifndef CDATASTRUCTURES_GROWTH_H
+#   define CDATASTRUCTURES_GROWTH_H
+
+#   include <stdio.h>
+#   include "_prelude.h"
+#   include "_common.h"
+
+#   ifndef CDS_DEFAULT_GROWTH_PERCENT
+#       define CDS_DEFAULT_GROWTH_PERCENT 200
+#   endif
+
+#   ifndef CDS_DEFAULT_SIZE_CLASS
+#       define CDS_DEFAULT_SIZE_CLASS 16
+#   endif
+
+#   ifndef CDS_DEFAULT_SHRINK_PERCENT
+#       define CDS_DEFAULT_SHRINK_PERCENT 25
+#   endif
+
+#   ifndef CDS_DEFAULT_SHRINK_FLOOR
+#       define CDS_DEFAULT_SHRINK_FLOOR 0
+#   endif
+
+struct _cds_growth_policy_t {
+    /**
+     * @brief How big the new capacity should be compared to the old capacity
+     * whenever a container runs out of space, as a percentage. For example,
+     * 200 doubles the capacity and 150 grows it by half. Values of 100 or
+     * less make the container grow only as much as it needs to.
+     */
+    size_t growth_percent;
+    /**
+     * @brief The smallest number of elements a container should reserve once
+     * it allocates any memory at all.
+     */
+    size_t min_capacity;
+    /**
+     * @brief The granularity of the underlying allocator in bytes. The total
+     * size of each allocation (including any metadata stored alongside the
+     * elements) is rounded up to a multiple of this value and the leftover
+     * space is handed to the container as extra capacity. 0 disables
+     * rounding.
+     */
+    size_t size_class;
+    /**
+     * @brief Shrink a container once its length falls below this percentage
+     * of its capacity. 0 means containers never shrink on their own.
+     * 
+     * A container which shrinks is left with enough room to grow by one
+     * growth step, so a container whose length oscillates around a
+     * threshold does not keep reallocating (hysteresis).
+     */
+    size_t shrink_percent;
+    /**
+     * @brief The number of bytes of element storage below which a container
+     * never shrinks on its own. This stops small containers from giving back
+     * memory they are likely to need again.
+     */
+    size_t shrink_floor;
+};
+
+/**
+ * @brief A policy object telling a container how to grow and shrink. A
+ * container keeps a pointer to the policy it was initialised with, so any
+ * changes made to a policy object are seen by every container using it. This
+ * lets latency-sensitive code trade memory for fewer reallocations on a
+ * per-container basis.
+ */
+typedef struct _cds_growth_policy_t cds_growth_policy_t;
+
+/**
+ * @brief The policy used by containers which were not given one. It doubles
+ * the capacity of a container whenever it runs out of space and halves it
+ * once less than a quarter of it is used.
+ */
+CDS_PUBLIC const cds_growth_policy_t CDS_DEFAULT_GROWTH_POLICY;
+
+/**
+ * @brief Print (debug) this growth policy to a file.
+ * 
+ * @param self The growth policy.
+ * @param file The file to print the output to.
+ * 
+ * @return cds_status_t The status code of this operation.
+ */
+CDS_PUBLIC
+cds_status_t cds_growth_policy_debug(
+    const cds_growth_policy_t *self,
+    FILE *file
+);
+
+/**
+ * @brief Calculate the capacity a container should grow to so that it can
+ * hold at least `required` elements.
+ * 
+ * @param self The growth policy. If NULL, `CDS_DEFAULT_GROWTH_POLICY` is used.
+ * @param capacity The current capacity of the container.
+ * @param required The minimum number of elements the container must be able
+ * to hold after growing.
+ * @param type_size The size of each element in bytes.
+ * @param overhead The number of bytes allocated alongside the elements, such
+ * as a header stored in the same memory block.
+ * 
+ * @return size_t The new capacity. This is never less than `required`.
+ */
+CDS_PUBLIC
+size_t cds_growth_policy_grow(
+    const cds_growth_policy_t *self,
+    size_t capacity,
+    size_t required,
+    size_t type_size,
+    size_t overhead
+);
+
+/**
+ * @brief Check whether a container with `length` elements and room for
+ * `capacity` elements should give back some of its memory.
+ * 
+ * @param self The growth policy. If NULL, `CDS_DEFAULT_GROWTH_POLICY` is used.
+ * @param length The number of elements in the container.
+ * @param capacity The capacity of the container.
+ * @param type_size The size of each element in bytes.
+ * 
+ * @return bool Whether the container should shrink.
+ */
+CDS_PUBLIC
+bool cds_growth_policy_should_shrink(
+    const cds_growth_policy_t *self,
+    size_t length,
+    size_t capacity,
+    size_t type_size
+);
+
+/**
+ * @brief Get the length below which a container with room for `capacity`
+ * elements has passed the policy's shrink percentage. The container may still
+ * keep its memory because of the minimum capacity or the shrink floor.
+ * 
+ * @param self The growth policy. If NULL, `CDS_DEFAULT_GROWTH_POLICY` is used.
+ * @param capacity The capacity of the container.
+ * 
+ * @return size_t The threshold. 0 if the policy never shrinks containers.
+ */
+CDS_PUBLIC
+size_t cds_growth_policy_shrink_threshold(
+    const cds_growth_policy_t *self,
+    size_t capacity
+);
+
+/**
+ * @brief Calculate the capacity a container should shrink to. Enough space
+ * is left over for the container to grow by one growth step before it has
+ * to reallocate again, and the capacity never drops below the shrink floor.
+ * 
+ * @param self The growth policy. If NULL, `CDS_DEFAULT_GROWTH_POLICY` is used.
+ * @param length The number of elements in the container.
+ * @param type_size The size of each element in bytes.
+ * @param overhead The number of bytes allocated alongside the elements.
+ * 
+ * @return size_t The new capacity.
+ */
+CDS_PUBLIC
+size_t cds_growth_policy_shrink(
+    const cds_growth_policy_t *self,
+    size_t length,
+    size_t type_size,
+    size_t overhead
+);
+
+#endif
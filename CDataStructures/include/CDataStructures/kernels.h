@@ -0,0 +1,128 @@
+/**
+ * @file kernels.h
+ * @author RenoirTan
+ * @brief A header defining vectorized kernels over arrays of the integer
+ * types in `CDS_INTEGER_TYPES`, such as sums and searches.
+ *
+ * Each kernel has a portable scalar version and, when built with GCC or
+ * clang for x86, SSE2, AVX2 and AVX-512 versions. The fastest version the
+ * processor supports is picked once when the program starts.
+ *
+ * The kernels work on plain arrays. To run one over a vector, pass
+ * `(int32_t *) vector->buffer` and `vector->length`, which skips the bounds
+ * check `cds_vector_get` does for every element. Use a span to run one over
+ * part of a dynbuffer.
+ * @version 0.1
+ * @date 2021-07-09
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#ifndef CDATASTRUCTURES_KERNELS_H
+#   define CDATASTRUCTURES_KERNELS_H
+
+#   include "_prelude.h"
+#   include "_common.h"
+#   include "functional.h"
+
+enum _cds_kernel_isa_t {
+    /**
+     * @brief Plain C loops, available everywhere.
+     */
+    cds_kernel_scalar = 0,
+    cds_kernel_sse2 = 1,
+    cds_kernel_avx2 = 2,
+    /**
+     * @brief AVX-512 with the byte and word instructions (AVX-512F and
+     * AVX-512BW).
+     */
+    cds_kernel_avx512 = 3
+};
+
+/**
+ * @brief The instruction sets the kernels can be run with, from slowest to
+ * fastest.
+ */
+typedef enum _cds_kernel_isa_t cds_kernel_isa_t;
+
+/**
+ * @brief Check whether this build has kernels for an instruction set and the
+ * processor supports it.
+ *
+ * @param isa The instruction set.
+ * @return bool
+ */
+CDS_PUBLIC
+bool cds_kernel_isa_supported(cds_kernel_isa_t isa);
+
+/**
+ * @brief Get the instruction set the kernels currently run with.
+ *
+ * @return cds_kernel_isa_t The instruction set.
+ */
+CDS_PUBLIC
+cds_kernel_isa_t cds_kernel_get_isa(void);
+
+/**
+ * @brief Make the kernels run with another instruction set, e.g. to compare
+ * the versions against each other. This must not be called while another
+ * thread is running a kernel.
+ *
+ * @param isa The instruction set.
+ * @return cds_status_t The status code of this operation. `cds_error` if the
+ * instruction set is not supported.
+ */
+CDS_PUBLIC
+cds_status_t cds_kernel_set_isa(cds_kernel_isa_t isa);
+
+/**
+ * @brief Get the name of an instruction set, such as "avx2".
+ *
+ * @param isa The instruction set.
+ * @return const char* The name.
+ */
+CDS_PUBLIC
+const char *cds_kernel_isa_name(cds_kernel_isa_t isa);
+
+#   define _CDS_KERNELS_DECLARE(stn, ltn) \
+    CDS_PUBLIC ltn \
+    CDS_SMASH_PUBLIC(stn, sum)(const ltn *array, size_t length); \
+    CDS_PUBLIC cds_status_t \
+    CDS_SMASH_PUBLIC(stn, min)(const ltn *array, size_t length, ltn *result); \
+    CDS_PUBLIC cds_status_t \
+    CDS_SMASH_PUBLIC(stn, max)(const ltn *array, size_t length, ltn *result); \
+    CDS_PUBLIC size_t \
+    CDS_SMASH_PUBLIC(stn, find)(const ltn *array, size_t length, ltn value); \
+    CDS_PUBLIC size_t \
+    CDS_SMASH_PUBLIC(stn, count)(const ltn *array, size_t length, ltn value); \
+    CDS_PUBLIC void \
+    CDS_SMASH_PUBLIC(stn, add)(ltn *dest, const ltn *src, size_t length); \
+    CDS_PUBLIC void \
+    CDS_SMASH_PUBLIC(stn, scale)(ltn *array, size_t length, ltn factor);
+
+/**
+ * @brief Generates these kernels for each type in `CDS_INTEGER_TYPES`, e.g.
+ * `cds_int32_sum`:
+ *
+ * - `cds_<type>_sum(array, length)` adds up the elements.
+ * - `cds_<type>_min(array, length, result)` and `cds_<type>_max` write the
+ * smallest or largest element to `result`, returning `cds_zero_error` if the
+ * array is empty.
+ * - `cds_<type>_find(array, length, value)` returns the index of the first
+ * element equal to `value`, or `length` if there is none.
+ * - `cds_<type>_count(array, length, value)` counts the elements equal to
+ * `value`.
+ * - `cds_<type>_add(dest, src, length)` adds each element of `src` to the
+ * element of `dest` at the same index.
+ * - `cds_<type>_scale(array, length, factor)` multiplies every element by
+ * `factor`.
+ *
+ * Arithmetic overflows the same way it would in a plain loop, so signed
+ * types as wide as `int` must not overflow.
+ */
+CDS_INTEGER_TYPES(_CDS_KERNELS_DECLARE)
+
+#   undef _CDS_KERNELS_DECLARE
+
+#endif
\ No newline at end of file
@@ -0,0 +1,225 @@
+/**
+ * @file parallel.h
+ * @author RenoirTan
+ * @brief A header defining a thread pool and parallel algorithms which run on
+ * it over spans of elements. Only available on platforms with POSIX threads
+ * (`CDS_HAVE_PTHREAD`).
+ * @version 0.1
+ * @date 2021-07-09
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#ifndef CDATASTRUCTURES_PARALLEL_H
+#   define CDATASTRUCTURES_PARALLEL_H
+
+#   include "_prelude.h"
+#   include "_common.h"
+#   include "span.h"
+
+#   ifdef CDS_HAVE_PTHREAD
+#       include <pthread.h>
+
+#       ifndef CDS_PAR_CHUNK_BYTES
+/**
+ * @brief The number of bytes of elements handed to a thread at a time if the
+ * size of the L2 cache cannot be found out.
+ */
+#           define CDS_PAR_CHUNK_BYTES (256 * 1024)
+#       endif
+
+/**
+ * @brief A function type which runs one task of a job. The first argument is
+ * the context pointer of the job and the second is the index of the task.
+ */
+typedef cds_status_t (*cds_task_f)(cds_ptr_t, size_t);
+
+struct _cds_thread_pool_t {
+    pthread_t *threads;
+    /**
+     * @brief The number of threads running tasks, including the thread
+     * which submits the job.
+     */
+    size_t thread_count;
+    /**
+     * @brief The number of bytes of elements in each task, which can be
+     * changed between jobs. Defaults to the size of the L2 cache.
+     */
+    size_t chunk_bytes;
+    /**
+     * @brief Held while a job is running so that only one job runs at once.
+     */
+    pthread_mutex_t submit;
+    /**
+     * @brief Guards every field below.
+     */
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    pthread_cond_t done;
+    cds_task_f task;
+    cds_ptr_t context;
+    size_t task_count;
+    size_t next_task;
+    size_t finished;
+    cds_status_t status;
+    bool stopping;
+};
+
+/**
+ * @brief A fixed set of worker threads which run the tasks of one job at a
+ * time. The thread which submits a job runs tasks too, so a pool of 1 thread
+ * runs everything on the caller.
+ *
+ * The parallel algorithms split their span into chunks of `chunk_bytes`
+ * bytes. Where the chunks start only depends on the length of the span and
+ * the chunk size, never on the number of threads, so an associative
+ * operation combines its elements in the same order on any pool.
+ *
+ * A task must not submit another job to the pool it is running on.
+ */
+typedef struct _cds_thread_pool_t cds_thread_pool_t;
+
+/**
+ * @brief Initialise a thread pool and start its workers.
+ *
+ * @param self The pool.
+ * @param threads The number of threads, including the caller. 0 for one per
+ * online processor.
+ *
+ * @return cds_status_t The status code of this operation.
+ */
+CDS_PUBLIC
+cds_status_t cds_thread_pool_init(cds_thread_pool_t *self, size_t threads);
+
+/**
+ * @brief Stop the workers of a thread pool and free them. No job may be
+ * running.
+ *
+ * @param self The pool.
+ *
+ * @return cds_status_t The status code of this operation.
+ */
+CDS_PUBLIC
+cds_status_t cds_thread_pool_destroy(cds_thread_pool_t *self);
+
+/**
+ * @brief Get the pool used when a parallel algorithm is passed a NULL pool.
+ * It is started on first use with one thread per online processor and lives
+ * until the program exits.
+ *
+ * @return cds_thread_pool_t* The pool. NULL if it could not be started.
+ */
+CDS_PUBLIC
+cds_thread_pool_t *cds_thread_pool_default(void);
+
+/**
+ * @brief Run `task` once for every index in [0, count) on the pool's threads
+ * and wait for every task to finish.
+ *
+ * @param self The pool, or NULL for the default pool.
+ * @param task The function which runs one task.
+ * @param context The pointer passed to every task.
+ * @param count The number of tasks.
+ *
+ * @return cds_status_t The status code of this operation. If a task fails,
+ * the other tasks still run and the error of the first failed task is
+ * returned.
+ */
+CDS_PUBLIC
+cds_status_t cds_thread_pool_run(
+    cds_thread_pool_t *self,
+    cds_task_f task,
+    cds_ptr_t context,
+    size_t count
+);
+
+/**
+ * @brief Call `apply` on every element of a span in parallel. Use
+ * `cds_span_from_buffer` or `cds_span_from_vector` to run this over a
+ * container.
+ *
+ * @param pool The pool, or NULL for the default pool.
+ * @param span The elements.
+ * @param apply The function called with each element and `context`.
+ * @param context The pointer passed to `apply` as its second argument.
+ *
+ * @return cds_status_t The status code of this operation.
+ */
+CDS_PUBLIC
+cds_status_t cds_par_for_each(
+    cds_thread_pool_t *pool,
+    cds_span_t span,
+    cds_apply_f apply,
+    cds_ptr_t context
+);
+
+/**
+ * @brief Fold every element of a span into one value in parallel. Each chunk
+ * is folded from `identity` from left to right, then the results of the
+ * chunks are folded together from left to right. `combine` must be
+ * associative and `identity` must leave any value unchanged.
+ *
+ * @param pool The pool, or NULL for the default pool.
+ * @param span The elements.
+ * @param identity The pointer to the identity element of `combine`.
+ * @param combine The function which folds an element into an accumulator of
+ * the same type.
+ * @param result Where the result is written to. Gets `identity` if the span
+ * is empty.
+ *
+ * @return cds_status_t The status code of this operation.
+ */
+CDS_PUBLIC
+cds_status_t cds_par_reduce(
+    cds_thread_pool_t *pool,
+    cds_span_t span,
+    cds_ptr_t identity,
+    cds_combine_f combine,
+    cds_ptr_t result
+);
+
+/**
+ * @brief Replace every element of a span with the fold of itself and every
+ * element before it, in parallel. This reads every element twice, once to
+ * fold each chunk and once to write the prefixes.
+ *
+ * @param pool The pool, or NULL for the default pool.
+ * @param span The elements.
+ * @param identity The pointer to the identity element of `combine`.
+ * @param combine The function which folds an element into an accumulator of
+ * the same type, which must be associative.
+ *
+ * @return cds_status_t The status code of this operation.
+ */
+CDS_PUBLIC
+cds_status_t cds_par_inclusive_scan(
+    cds_thread_pool_t *pool,
+    cds_span_t span,
+    cds_ptr_t identity,
+    cds_combine_f combine
+);
+
+/**
+ * @brief Sort a span in parallel. Each chunk is sorted with `cds_sort`, then
+ * sorted runs are merged in pairs until one run is left. Each merge is split
+ * into chunk-sized pieces by binary searching both runs, so all threads stay
+ * busy until the last merge. This needs a scratch array as large as the span. The
+ * sort is not stable.
+ *
+ * @param pool The pool, or NULL for the default pool.
+ * @param span The elements.
+ * @param compare The function which compares 2 elements.
+ *
+ * @return cds_status_t The status code of this operation.
+ */
+CDS_PUBLIC
+cds_status_t cds_par_sort(
+    cds_thread_pool_t *pool,
+    cds_span_t span,
+    cds_compare_f compare
+);
+
+#   endif
+
+#endif
\ No newline at end of file
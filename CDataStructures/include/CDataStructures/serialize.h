@@ -0,0 +1,198 @@
+/**
+ * @file serialize.h
+ * @author RenoirTan
+ * @brief A header defining the binary format used to save containers to and
+ * load them from files.
+ * @version 0.1
+ * @date 2021-07-09
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#ifndef CDATASTRUCTURES_SERIALIZE_H
+#   define CDATASTRUCTURES_SERIALIZE_H
+
+#   include <stdio.h>
+#   include "_prelude.h"
+#   include "_common.h"
+
+/**
+ * @brief The first 4 bytes of every serialized container ("CDSB" in a
+ * little-endian file).
+ */
+#   define CDS_SERIAL_MAGIC UINT32_C(0x42534443)
+
+/**
+ * @brief The version of the format written by this library.
+ */
+#   define CDS_SERIAL_VERSION 1
+
+/**
+ * @brief A value whose byte order in a file shows whether the file was
+ * written on a machine with the same endianness as this one.
+ */
+#   define CDS_SERIAL_ENDIAN_MARKER 0x0102
+
+struct _cds_serial_header_t {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t endian_marker;
+    uint64_t type_size;
+    uint64_t length;
+    /**
+     * @brief The checksum of the elements following the header, as computed
+     * by `cds_serial_checksum`.
+     */
+    uint64_t checksum;
+};
+
+/**
+ * @brief The header written before the elements of a serialized container.
+ * The elements follow the header as one contiguous array in the byte order
+ * of the machine which wrote them.
+ */
+typedef struct _cds_serial_header_t cds_serial_header_t;
+
+struct _cds_serial_checksum_t {
+    uint64_t lanes[4];
+    /**
+     * @brief The bytes which did not fill a whole 32-byte block yet.
+     */
+    cds_byte_t pending[32];
+    size_t pending_bytes;
+};
+
+/**
+ * @brief The state of a checksum computed over data which comes in several
+ * pieces, such as the 2 halves of a ring buffer. Feeding every piece in
+ * order gives the same checksum as `cds_serial_checksum` over all of them.
+ */
+typedef struct _cds_serial_checksum_t cds_serial_checksum_t;
+
+/**
+ * @brief Compute the checksum of a block of memory. This processes the data
+ * 8 bytes at a time, so it runs at close to memory speed.
+ *
+ * @param data The pointer to the data.
+ * @param bytes The number of bytes.
+ * @return uint64_t The checksum.
+ */
+CDS_PUBLIC
+uint64_t cds_serial_checksum(cds_ptr_t data, size_t bytes);
+
+/**
+ * @brief Start a checksum over data which comes in pieces.
+ *
+ * @param self The checksum state.
+ * @param bytes The total number of bytes in every piece.
+ */
+CDS_PUBLIC
+void cds_serial_checksum_init(cds_serial_checksum_t *self, size_t bytes);
+
+/**
+ * @brief Add the next piece of data to a checksum.
+ *
+ * @param self The checksum state.
+ * @param data The pointer to the piece.
+ * @param bytes The number of bytes in the piece.
+ */
+CDS_PUBLIC
+void cds_serial_checksum_update(
+    cds_serial_checksum_t *self,
+    cds_ptr_t data,
+    size_t bytes
+);
+
+/**
+ * @brief Finish a checksum once every piece has been added.
+ *
+ * @param self The checksum state.
+ * @return uint64_t The checksum.
+ */
+CDS_PUBLIC
+uint64_t cds_serial_checksum_finish(cds_serial_checksum_t *self);
+
+/**
+ * @brief Write a header followed by an array of elements to a file using a
+ * single `fwrite` for the elements.
+ *
+ * @param file The file to write to.
+ * @param array The pointer to the first element.
+ * @param length The number of elements.
+ * @param type_size The size of each element in bytes.
+ * @return cds_status_t The status code of this operation. `cds_error` if
+ * the file could not be written to.
+ */
+CDS_PUBLIC
+cds_status_t cds_serial_write(
+    FILE *file,
+    cds_ptr_t array,
+    size_t length,
+    size_t type_size
+);
+
+/**
+ * @brief Write a header followed by elements which are split into 2 arrays,
+ * such as the 2 halves of a ring buffer whose elements wrap around. The
+ * file looks the same as if the arrays had been joined and written with
+ * `cds_serial_write`, but nothing is moved or copied.
+ *
+ * @param file The file to write to.
+ * @param first The pointer to the first array.
+ * @param first_length The number of elements in the first array.
+ * @param second The pointer to the second array, whose elements follow the
+ * elements of the first array.
+ * @param second_length The number of elements in the second array.
+ * @param type_size The size of each element in bytes.
+ * @return cds_status_t The status code of this operation. `cds_error` if
+ * the file could not be written to.
+ */
+CDS_PUBLIC
+cds_status_t cds_serial_write_split(
+    FILE *file,
+    cds_ptr_t first,
+    size_t first_length,
+    cds_ptr_t second,
+    size_t second_length,
+    size_t type_size
+);
+
+/**
+ * @brief Read and validate a header from a file. This checks the magic
+ * number, version, endianness and element size. If the file can seek, the
+ * length is also checked against the number of bytes left in the file, so
+ * that a corrupt length is caught before any memory is allocated for it.
+ *
+ * @param file The file to read from.
+ * @param type_size The size of each element the caller expects.
+ * @param header The header which is read into.
+ * @return cds_status_t The status code of this operation. `cds_error` if
+ * the header could not be read, does not match or claims more elements than
+ * the file holds.
+ */
+CDS_PUBLIC
+cds_status_t cds_serial_read_header(
+    FILE *file,
+    size_t type_size,
+    cds_serial_header_t *header
+);
+
+/**
+ * @brief Read the elements which follow a header into an array large enough
+ * to hold them using a single `fread`, then verify their checksum.
+ *
+ * @param file The file to read from.
+ * @param header The header read by `cds_serial_read_header`.
+ * @param array The array to read the elements into.
+ * @return cds_status_t The status code of this operation. `cds_error` if
+ * the elements could not be read or the checksum does not match.
+ */
+CDS_PUBLIC
+cds_status_t cds_serial_read_elements(
+    FILE *file,
+    const cds_serial_header_t *header,
+    cds_ptr_t array
+);
+
+#endif
@@ -19,6 +19,7 @@
 
 struct _cds_slist_t {
     cds_unary_node_t *head;
+    const cds_allocator_t *allocator;
 };
 
 /**
@@ -45,6 +46,21 @@ cds_slist_t *cds_slist_new(void);
 CDS_PUBLIC
 cds_status_t cds_slist_init(cds_slist_t *self);
 
+/**
+ * @brief Initialise the singly-linked list with a custom allocator which all
+ * the nodes in the list are allocated with. The allocator must outlive the
+ * list.
+ * 
+ * @param self The uninitialised singly-linked list.
+ * @param allocator The allocator. If NULL, `CDS_DEFAULT_ALLOCATOR` is used.
+ * @return cds_status_t The status code of this operation.
+ */
+CDS_PUBLIC
+cds_status_t cds_slist_init_with_allocator(
+    cds_slist_t *self,
+    const cds_allocator_t *allocator
+);
+
 /**
  * @brief Get the length of the list. This traverses through all the nodes in
  * the chain and hence will take O(N) time where N is the number of nodes in
@@ -0,0 +1,160 @@
+/**
+ * @file sort.h
+ * @author RenoirTan
+ * @brief A header defining sorting and binary searching functions for arrays
+ * of elements of any size.
+ * @version 0.1
+ * @date 2021-07-09
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#ifndef CDATASTRUCTURES_SORT_H
+#   define CDATASTRUCTURES_SORT_H
+
+#   include "_prelude.h"
+#   include "_common.h"
+#   include "functional.h"
+
+#   ifndef CDS_SORT_INSERTION_THRESHOLD
+/**
+ * @brief Partitions smaller than this number of elements are sorted using
+ * insertion sort.
+ */
+#       define CDS_SORT_INSERTION_THRESHOLD 24
+#   endif
+
+#   ifndef CDS_SORT_NINTHER_THRESHOLD
+/**
+ * @brief Partitions at least this large choose their pivot using the median
+ * of 3 medians instead of the median of 3 elements.
+ */
+#       define CDS_SORT_NINTHER_THRESHOLD 128
+#   endif
+
+/**
+ * @brief Sort an array in place using pattern-defeating quicksort. This is an
+ * introsort which detects already sorted and reversed inputs, sorts small
+ * partitions with insertion sort, handles many equal elements in linear time
+ * and falls back to heapsort after too many unbalanced partitions, so it
+ * always runs in O(n log n) time. The sort is not stable.
+ *
+ * @param array The pointer to the first element.
+ * @param length The number of elements in the array.
+ * @param type_size The size of each element in bytes.
+ * @param compare The function which compares 2 elements.
+ * @return cds_status_t The status code of this operation.
+ */
+CDS_PUBLIC
+cds_status_t cds_sort(
+    cds_ptr_t array,
+    size_t length,
+    size_t type_size,
+    cds_compare_f compare
+);
+
+/**
+ * @brief Check whether an array is sorted in non-descending order.
+ *
+ * @param array The pointer to the first element.
+ * @param length The number of elements in the array.
+ * @param type_size The size of each element in bytes.
+ * @param compare The function which compares 2 elements.
+ * @return bool
+ */
+CDS_PUBLIC
+bool cds_is_sorted(
+    cds_ptr_t array,
+    size_t length,
+    size_t type_size,
+    cds_compare_f compare
+);
+
+/**
+ * @brief Find the index of the first element in a sorted array which is not
+ * lesser than `key`.
+ *
+ * @param array The pointer to the first element.
+ * @param length The number of elements in the array.
+ * @param type_size The size of each element in bytes.
+ * @param key The pointer to the element to search for.
+ * @param compare The function which compares 2 elements.
+ * @return size_t The index of the element. `length` if every element is
+ * lesser than `key`.
+ */
+CDS_PUBLIC
+size_t cds_lower_bound(
+    cds_ptr_t array,
+    size_t length,
+    size_t type_size,
+    cds_ptr_t key,
+    cds_compare_f compare
+);
+
+/**
+ * @brief Find the index of the first element in a sorted array which is
+ * greater than `key`.
+ *
+ * @param array The pointer to the first element.
+ * @param length The number of elements in the array.
+ * @param type_size The size of each element in bytes.
+ * @param key The pointer to the element to search for.
+ * @param compare The function which compares 2 elements.
+ * @return size_t The index of the element. `length` if no element is greater
+ * than `key`.
+ */
+CDS_PUBLIC
+size_t cds_upper_bound(
+    cds_ptr_t array,
+    size_t length,
+    size_t type_size,
+    cds_ptr_t key,
+    cds_compare_f compare
+);
+
+/**
+ * @brief Sort an array of records in place by an integer key using a least
+ * significant digit radix sort. The sort is stable and takes O(n * k) time,
+ * where k is the number of bytes in the key. Byte columns which are the same
+ * in every key are skipped. This needs a scratch array as large as the input.
+ * 
+ * The typed variants (e.g. `cds_int32_radix_sort`) fill in `key_size` and
+ * `is_signed` for you.
+ * 
+ * @param array The pointer to the first record.
+ * @param length The number of records in the array.
+ * @param type_size The size of each record in bytes.
+ * @param key_offset The offset of the key in each record in bytes.
+ * @param key_size The size of the key in bytes, at most 8.
+ * @param is_signed Whether the key is a signed (two's complement) integer.
+ * @return cds_status_t The status code of this operation.
+ */
+CDS_PUBLIC
+cds_status_t cds_radix_sort(
+    cds_ptr_t array,
+    size_t length,
+    size_t type_size,
+    size_t key_offset,
+    size_t key_size,
+    bool is_signed
+);
+
+#   define _CDS_RADIX_SORT_DECLARE(stn, ltn) \
+    CDS_PUBLIC cds_status_t \
+    CDS_SMASH_PUBLIC(stn, radix_sort) \
+    (cds_ptr_t array, size_t length, size_t type_size, size_t key_offset);
+
+/**
+ * @brief Generates `cds_<type>_radix_sort(array, length, type_size,
+ * key_offset)` for each type in `CDS_INTEGER_TYPES`, which sorts records by a
+ * key of that type. For plain arrays of integers, `type_size` is the size of
+ * the integer and `key_offset` is 0.
+ * 
+ * @see cds_radix_sort
+ */
+CDS_INTEGER_TYPES(_CDS_RADIX_SORT_DECLARE)
+
+#   undef _CDS_RADIX_SORT_DECLARE
+
+#endif
\ No newline at end of file
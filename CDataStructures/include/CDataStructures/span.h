@@ -0,0 +1,268 @@
+/**
+ * @file span.h
+ * @author RenoirTan
+ * @brief A header defining spans, which are views into a contiguous range of
+ * elements owned by someone else.
+ * @version 0.1
+ * @date 2021-07-09
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#ifndef CDATASTRUCTURES_SPAN_H
+#   define CDATASTRUCTURES_SPAN_H
+
+#   include <assert.h>
+#   include "_prelude.h"
+#   include "_common.h"
+#   include "dynbuffer.h"
+#   include "sort.h"
+#   include "vector.h"
+
+struct _cds_span_t {
+    cds_byte_t *data;
+    size_t length;
+    size_t type_size;
+};
+
+/**
+ * @brief A view into `length` contiguous elements starting at `data`. A span
+ * does not own its elements, so making one never allocates or copies
+ * anything, and it is passed around by value. A span into a container is
+ * only valid until the container is changed.
+ *
+ * Spans made by `cds_span_from_buffer` and `cds_span_from_vector` are checked
+ * against the container. The other functions only check their indices with
+ * `assert`, so the checks go away in release builds (`NDEBUG`).
+ */
+typedef struct _cds_span_t cds_span_t;
+
+/**
+ * @brief Loop over every element in a span. `element` is set to a pointer to
+ * each element in turn.
+ *
+ * @param span The span.
+ * @param element A pointer variable, e.g. of type `cds_ptr_t` or `int *`.
+ */
+#   define CDS_SPAN_FOR_EACH(span, element) \
+    for ( \
+        (element) = (cds_ptr_t) (span).data; \
+        (cds_byte_t *) (element) \
+            < (span).data + (span).length * (span).type_size; \
+        (element) = (cds_ptr_t) ((cds_byte_t *) (element) + (span).type_size) \
+    )
+
+/**
+ * @brief Make a span out of a pointer to an array.
+ *
+ * @param data The pointer to the first element.
+ * @param length The number of elements.
+ * @param type_size The size of each element in bytes.
+ * @return cds_span_t The span.
+ */
+CDS_INLINE
+cds_span_t cds_span_new(cds_ptr_t data, size_t length, size_t type_size) {
+    cds_span_t span;
+    span.data = data;
+    span.length = length;
+    span.type_size = type_size;
+    return span;
+}
+
+/**
+ * @brief Make a span of a range of elements in a dynbuffer. Writing through
+ * the span to a shared buffer changes it for every owner.
+ *
+ * @param buffer The buffer.
+ * @param start The index of the first element in the range.
+ * @param length The number of elements in the range.
+ * @param span Where the span is written to.
+ * @return cds_status_t The status code of this operation. `cds_index_error`
+ * if the range goes past the end of the buffer, `cds_error` if the range
+ * wraps around the end of a ring buffer (use `cds_buffer_linearize` first).
+ */
+CDS_INLINE
+cds_status_t cds_span_from_buffer(
+    cds_buffer_t buffer,
+    size_t start,
+    size_t length,
+    cds_span_t *span
+) {
+    CDS_IF_NULL_RETURN_ERROR(buffer);
+    CDS_IF_NULL_RETURN_ERROR(span);
+    cds_buffer_header_t *header = &cds_buffer_get_data(buffer)->header;
+    if (start > header->length || length > header->length - start)
+        return cds_index_error;
+    size_t slot = header->head + start;
+    if (slot >= header->reserved)
+        slot -= header->reserved;
+    if (length > 0 && slot + length > header->reserved)
+        return cds_error;
+    *span = cds_span_new(
+        (cds_byte_t *) buffer + slot * header->type_size,
+        length,
+        header->type_size
+    );
+    return cds_ok;
+}
+
+/**
+ * @brief Make a span of a range of elements in a vector.
+ *
+ * @param self The vector.
+ * @param start The index of the first element in the range.
+ * @param length The number of elements in the range.
+ * @param span Where the span is written to.
+ * @return cds_status_t The status code of this operation. `cds_index_error`
+ * if the range goes past the end of the vector.
+ */
+CDS_INLINE
+cds_status_t cds_span_from_vector(
+    cds_vector_t *self,
+    size_t start,
+    size_t length,
+    cds_span_t *span
+) {
+    CDS_IF_NULL_RETURN_ERROR(self);
+    CDS_IF_NULL_RETURN_ERROR(span);
+    if (start > self->length || length > self->length - start)
+        return cds_index_error;
+    *span = cds_span_new(
+        self->buffer + start * self->type_size,
+        length,
+        self->type_size
+    );
+    return cds_ok;
+}
+
+/**
+ * @brief Get a pointer to an element in a span.
+ *
+ * @param span The span.
+ * @param index The index of the element, which must be less than the length.
+ * @return cds_ptr_t The pointer to the element.
+ */
+CDS_INLINE
+cds_ptr_t cds_span_get(cds_span_t span, size_t index) {
+    assert(index < span.length);
+    return span.data + index * span.type_size;
+}
+
+/**
+ * @brief Get a span of part of another span.
+ *
+ * @param span The span.
+ * @param start The index of the first element in the new span.
+ * @param length The number of elements in the new span.
+ * @return cds_span_t The new span.
+ */
+CDS_INLINE
+cds_span_t cds_span_sub(cds_span_t span, size_t start, size_t length) {
+    assert(start <= span.length && length <= span.length - start);
+    return cds_span_new(
+        span.data + start * span.type_size,
+        length,
+        span.type_size
+    );
+}
+
+/**
+ * @brief Get the elements of a span from an index to the end.
+ *
+ * @param span The span.
+ * @param start The index of the first element in the new span.
+ * @return cds_span_t The new span.
+ */
+CDS_INLINE
+cds_span_t cds_span_skip(cds_span_t span, size_t start) {
+    assert(start <= span.length);
+    return cds_span_sub(span, start, span.length - start);
+}
+
+/**
+ * @brief Find the first element in a span which passes a test.
+ *
+ * @param span The span.
+ * @param predicate The function testing each element.
+ * @param context The pointer passed to `predicate` as its second argument.
+ * @return size_t The index of the element. The length of the span if no
+ * element passes.
+ */
+CDS_INLINE
+size_t cds_span_find_if(
+    cds_span_t span,
+    cds_predicate_f predicate,
+    cds_ptr_t context
+) {
+    size_t index = 0;
+    for (; index < span.length; index++) {
+        if (predicate(span.data + index * span.type_size, context))
+            return index;
+    }
+    return span.length;
+}
+
+/**
+ * @brief Sort the elements of a span in place.
+ *
+ * @see cds_sort
+ */
+CDS_INLINE
+cds_status_t cds_span_sort(cds_span_t span, cds_compare_f compare) {
+    return cds_sort(span.data, span.length, span.type_size, compare);
+}
+
+/**
+ * @brief Check whether the elements of a span are sorted.
+ *
+ * @see cds_is_sorted
+ */
+CDS_INLINE
+bool cds_span_is_sorted(cds_span_t span, cds_compare_f compare) {
+    return cds_is_sorted(span.data, span.length, span.type_size, compare);
+}
+
+/**
+ * @brief Find the index of the first element in a sorted span which is not
+ * lesser than `key`.
+ *
+ * @see cds_lower_bound
+ */
+CDS_INLINE
+size_t cds_span_lower_bound(
+    cds_span_t span,
+    cds_ptr_t key,
+    cds_compare_f compare
+) {
+    return cds_lower_bound(
+        span.data,
+        span.length,
+        span.type_size,
+        key,
+        compare
+    );
+}
+
+/**
+ * @brief Find the index of the first element in a sorted span which is
+ * greater than `key`.
+ *
+ * @see cds_upper_bound
+ */
+CDS_INLINE
+size_t cds_span_upper_bound(
+    cds_span_t span,
+    cds_ptr_t key,
+    cds_compare_f compare
+) {
+    return cds_upper_bound(
+        span.data,
+        span.length,
+        span.type_size,
+        key,
+        compare
+    );
+}
+
+#endif
\ No newline at end of file
@@ -42,6 +42,21 @@ cds_stack_t *cds_stack_new(void);
 CDS_PUBLIC
 cds_status_t cds_stack_init(cds_stack_t *self);
 
+/**
+ * @brief Initialise the stack with a custom allocator which all the elements
+ * pushed onto the stack are allocated with. The allocator must outlive the
+ * stack.
+ * 
+ * @param self The uninitialised stack object.
+ * @param allocator The allocator. If NULL, `CDS_DEFAULT_ALLOCATOR` is used.
+ * @return cds_status_t
+ */
+CDS_PUBLIC
+cds_status_t cds_stack_init_with_allocator(
+    cds_stack_t *self,
+    const cds_allocator_t *allocator
+);
+
 /**
  * @brief Create a new stack from a singly-linked list.
  * 
@@ -59,4 +59,23 @@ typedef void (*cds_free_f)(cds_ptr_t);
 
 typedef cds_ordering_t (*cds_compare_f)(cds_ptr_t, cds_ptr_t);
 
+/**
+ * @brief A function type which tests an element. The second argument is a
+ * user-provided context pointer which is passed through unchanged.
+ */
+typedef bool (*cds_predicate_f)(cds_ptr_t, cds_ptr_t);
+
+/**
+ * @brief A function type which does something to an element. The second
+ * argument is a user-provided context pointer which is passed through
+ * unchanged.
+ */
+typedef void (*cds_apply_f)(cds_ptr_t, cds_ptr_t);
+
+/**
+ * @brief A function type which folds the element in the second argument into
+ * the accumulator in the first argument.
+ */
+typedef void (*cds_combine_f)(cds_ptr_t, cds_ptr_t);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,207 @@
+/**
+ * @file typed.h
+ * @author RenoirTan
+ * @brief A header defining macros which generate typed wrappers around
+ * `cds_vector_t` and `cds_buffer_t`.
+ *
+ * The generic containers only learn the size of their elements at runtime, so
+ * every element they move goes through a `memcpy` of unknown length.
+ * `CDS_DEFINE_VECTOR` and `CDS_DEFINE_BUFFER` generate inline functions for
+ * one element type which move elements by assignment instead, so the
+ * compiler can turn them into plain loads and stores. The functions only
+ * handle the common case themselves and fall back onto the generic functions
+ * whenever the container has to grow or shrink or a shared buffer has to be
+ * copied, so typed and generic functions can be mixed freely on the same
+ * container.
+ * @version 0.1
+ * @date 2021-07-09
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#ifndef CDATASTRUCTURES_TYPED_H
+#   define CDATASTRUCTURES_TYPED_H
+
+#   include <string.h>
+#   include "_prelude.h"
+#   include "_common.h"
+#   include "dynbuffer.h"
+#   include "functional.h"
+#   include "growth.h"
+#   include "vector.h"
+
+/**
+ * @brief Generate `<name>_init`, `<name>_get`, `<name>_push_back`,
+ * `<name>_pop_back` and `<name>_insert`, which work on a `cds_vector_t`
+ * storing elements of type `T`. The vector must be initialised with
+ * `sizeof(T)` as its type size, which `<name>_init` does for you.
+ *
+ * @param name The prefix of the generated functions.
+ * @param T The type of the elements.
+ */
+#   define CDS_DEFINE_VECTOR(name, T) _CDS_DEFINE_VECTOR(name, T)
+
+#   define _CDS_DEFINE_VECTOR(name, T) \
+    CDS_INLINE \
+    cds_status_t name##_init(cds_vector_t *self) { \
+        return cds_vector_init(self, sizeof(T)); \
+    } \
+    \
+    CDS_INLINE \
+    T *name##_get(cds_vector_t *self, size_t index) { \
+        if (index >= self->length) \
+            return NULL; \
+        return (T *) self->buffer + index; \
+    } \
+    \
+    CDS_INLINE \
+    cds_status_t name##_push_back(cds_vector_t *self, T value) { \
+        if (self->length < self->capacity) { \
+            ((T *) self->buffer)[self->length++] = value; \
+            return cds_ok; \
+        } \
+        return cds_vector_push_back(self, &value); \
+    } \
+    \
+    CDS_INLINE \
+    cds_status_t name##_pop_back(cds_vector_t *self, T *dest) { \
+        if (self->length == 0) \
+            return cds_warning; \
+        if (dest != NULL) \
+            *dest = ((T *) self->buffer)[self->length - 1]; \
+        if (!cds_growth_policy_should_shrink( \
+            self->policy, \
+            self->length - 1, \
+            self->capacity, \
+            sizeof(T) \
+        )) { \
+            --(self->length); \
+            return cds_ok; \
+        } \
+        return cds_vector_pop_back(self, NULL); \
+    } \
+    \
+    CDS_INLINE \
+    cds_status_t name##_insert(cds_vector_t *self, size_t index, T value) { \
+        if (index > self->length) \
+            return cds_index_error; \
+        if (self->length < self->capacity) { \
+            T *array = (T *) self->buffer; \
+            memmove( \
+                array + index + 1, \
+                array + index, \
+                (self->length - index) * sizeof(T) \
+            ); \
+            array[index] = value; \
+            ++(self->length); \
+            return cds_ok; \
+        } \
+        return cds_vector_insert(self, index, &value); \
+    }
+
+/**
+ * @brief Generate `<name>_init`, `<name>_get`, `<name>_push_back`,
+ * `<name>_pop_back` and `<name>_insert`, which work on a `cds_buffer_t`
+ * storing elements of type `T`. Ring buffers are supported. The buffer must
+ * be initialised with `sizeof(T)` as its type size, which `<name>_init` does
+ * for you.
+ *
+ * @param name The prefix of the generated functions.
+ * @param T The type of the elements.
+ */
+#   define CDS_DEFINE_BUFFER(name, T) _CDS_DEFINE_BUFFER(name, T)
+
+#   define _CDS_DEFINE_BUFFER(name, T) \
+    CDS_INLINE \
+    cds_status_t name##_init(cds_buffer_t *buffer) { \
+        return cds_buffer_init(buffer, sizeof(T)); \
+    } \
+    \
+    CDS_INLINE \
+    T *name##_get(cds_buffer_t buffer, size_t index) { \
+        cds_buffer_header_t *header = &cds_buffer_get_data(buffer)->header; \
+        if (index >= header->length) \
+            return NULL; \
+        size_t slot = header->head + index; \
+        if (slot >= header->reserved) \
+            slot -= header->reserved; \
+        return (T *) buffer + slot; \
+    } \
+    \
+    CDS_INLINE \
+    cds_status_t name##_push_back(cds_buffer_t *buffer, T value) { \
+        cds_buffer_header_t *header = &cds_buffer_get_data(*buffer)->header; \
+        if (header->length < header->reserved && header->refcount == 1) { \
+            size_t slot = header->head + header->length; \
+            if (slot >= header->reserved) \
+                slot -= header->reserved; \
+            ((T *) *buffer)[slot] = value; \
+            ++(header->length); \
+            return cds_ok; \
+        } \
+        return cds_buffer_push_back(buffer, &value); \
+    } \
+    \
+    CDS_INLINE \
+    cds_status_t name##_pop_back(cds_buffer_t *buffer, T *dest) { \
+        cds_buffer_header_t *header = &cds_buffer_get_data(*buffer)->header; \
+        if (header->length == 0) \
+            return cds_index_error; \
+        if (dest != NULL) \
+            *dest = *name##_get(*buffer, header->length - 1); \
+        if (header->refcount == 1 && !cds_growth_policy_should_shrink( \
+            header->policy, \
+            header->length - 1, \
+            header->reserved, \
+            sizeof(T) \
+        )) { \
+            size_t threshold = cds_growth_policy_shrink_threshold( \
+                header->policy, \
+                header->reserved \
+            ); \
+            if (header->length == threshold) \
+                ++(header->shrinks_avoided); \
+            if (--(header->length) == 0) \
+                header->head = 0; \
+            return cds_ok; \
+        } \
+        return cds_buffer_pop_back(buffer, NULL); \
+    } \
+    \
+    CDS_INLINE \
+    cds_status_t name##_insert(cds_buffer_t *buffer, size_t index, T value) { \
+        cds_buffer_header_t *header = &cds_buffer_get_data(*buffer)->header; \
+        if (index > header->length) \
+            return cds_index_error; \
+        /* Ring and shared buffers are left to the generic function. */ \
+        if (header->length < header->reserved \
+            && header->refcount == 1 \
+            && (header->flags & cds_buffer_ring) == 0) { \
+            T *array = (T *) *buffer; \
+            memmove( \
+                array + index + 1, \
+                array + index, \
+                (header->length - index) * sizeof(T) \
+            ); \
+            array[index] = value; \
+            ++(header->length); \
+            return cds_ok; \
+        } \
+        return cds_buffer_insert(buffer, index, &value); \
+    }
+
+#   define _CDS_DEFINE_TYPED_CONTAINERS(stn, ltn) \
+    CDS_DEFINE_VECTOR(CDS_SMASH_PUBLIC(stn, vector), ltn) \
+    CDS_DEFINE_BUFFER(CDS_SMASH_PUBLIC(stn, buffer), ltn)
+
+/**
+ * @brief Typed vector and buffer functions for each type in
+ * `CDS_INTEGER_TYPES`, such as `cds_int32_vector_push_back` and
+ * `cds_int32_buffer_get`.
+ */
+CDS_INTEGER_TYPES(_CDS_DEFINE_TYPED_CONTAINERS)
+
+#   undef _CDS_DEFINE_TYPED_CONTAINERS
+
+#endif
\ No newline at end of file
@@ -14,6 +14,7 @@
 
 #   include "_prelude.h"
 #   include "_common.h"
+#   include "allocator.h"
 
 struct _cds_unary_node_t {
     cds_ptr_t data;
@@ -31,6 +32,18 @@ typedef struct _cds_unary_node_t cds_unary_node_t;
 CDS_PUBLIC
 cds_unary_node_t *cds_unary_node_new(void);
 
+/**
+ * @brief Create a node with at most 1 child using a custom allocator. The node
+ * must be freed with the same allocator.
+ * 
+ * @param allocator The allocator. If NULL, `CDS_DEFAULT_ALLOCATOR` is used.
+ * @return cds_unary_node_t* The pointer to the node.
+ */
+CDS_PUBLIC
+cds_unary_node_t *cds_unary_node_new_with_allocator(
+    const cds_allocator_t *allocator
+);
+
 /**
  * @brief Initialise a unary node.
  * 
@@ -160,4 +173,20 @@ cds_status_t cds_unary_node_free_all(
     cds_free_f clean_element
 );
 
+/**
+ * @brief Free all the nodes and data in the current chain, where the nodes
+ * were created using a custom allocator.
+ * 
+ * @param node The current node.
+ * @param clean_element The function used to free the data.
+ * @param allocator The allocator the nodes were created with.
+ * @return cds_status_t The status code of this operation.
+ */
+CDS_PUBLIC
+cds_status_t cds_unary_node_free_all_with_allocator(
+    cds_unary_node_t *node,
+    cds_free_f clean_element,
+    const cds_allocator_t *allocator
+);
+
 #endif
\ No newline at end of file
@@ -162,4 +162,63 @@ CDS_INLINE int32_t cds_uint64_trailing_ones(uint64_t n) {
     return b == 0 ? 64 : cds_int_log2(b);
 }
 
+/**
+ * @brief Count the number of set bits in an integer.
+ * 
+ * @param n The input integer.
+ * @return int32_t The number of ones.
+ */
+CDS_INLINE int32_t cds_uint64_popcount(uint64_t n) {
+#   ifdef __GNUC__
+    return __builtin_popcountll(n);
+#   else
+    n = n - ((n >> 1) & 0x5555555555555555);
+    n = (n & 0x3333333333333333) + ((n >> 2) & 0x3333333333333333);
+    n = (n + (n >> 4)) & 0x0F0F0F0F0F0F0F0F;
+    return (int32_t) ((n * 0x0101010101010101) >> 56);
+#   endif
+}
+
+/**
+ * @brief Count the number of trailing zeroes in an integer.
+ * 
+ * @param n The input integer.
+ * @return int32_t The number of trailing zeroes. 64 if n is 0.
+ */
+CDS_INLINE int32_t cds_uint64_trailing_zeros(uint64_t n) {
+    if (n == 0)
+        return 64;
+#   ifdef __GNUC__
+    return __builtin_ctzll(n);
+#   else
+    return cds_int_log2(n & (~n + 1));
+#   endif
+}
+
+/**
+ * @brief Find the index of the `rank`-th set bit in an integer, counting
+ * from 0 at the least significant bit. Whole bytes are skipped using their
+ * popcounts, so this takes at most 8 + 8 steps.
+ * 
+ * @param n The input integer.
+ * @param rank The number of set bits to skip.
+ * @return int32_t The index of the bit. 64 if n has `rank` or fewer ones.
+ */
+CDS_INLINE int32_t cds_uint64_select(uint64_t n, int32_t rank) {
+    int32_t shift = 0;
+    int32_t ones = 0;
+    for (; shift < 64; shift += 8) {
+        ones = cds_uint64_popcount((n >> shift) & 0xFF);
+        if (rank < ones)
+            break;
+        rank -= ones;
+    }
+    if (shift == 64)
+        return 64;
+    n >>= shift;
+    for (; rank > 0; --rank)
+        n &= n - 1;
+    return shift + cds_uint64_trailing_zeros(n);
+}
+
 #endif
\ No newline at end of file
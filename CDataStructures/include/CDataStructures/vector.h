@@ -14,12 +14,21 @@
 
 #   include "_prelude.h"
 #   include "_common.h"
+#   include "allocator.h"
+#   include "growth.h"
+#   include "serialize.h"
+#   include "sort.h"
 
 struct _cds_vector_t {
     cds_byte_t *buffer;
     size_t type_size;
     size_t length;
+    size_t capacity;
     size_t _bytes_allocated;
+    const cds_growth_policy_t *policy;
+    const cds_allocator_t *allocator;
+    cds_byte_t *_inline_storage;
+    size_t _inline_bytes;
 };
 
 /**
@@ -27,6 +36,35 @@ struct _cds_vector_t {
  */
 typedef struct _cds_vector_t cds_vector_t;
 
+#   ifndef CDS_SMALL_VECTOR_BYTES
+/**
+ * @brief The number of bytes stored inline in a `cds_small_vector_t` before it
+ * spills over onto the heap.
+ */
+#       define CDS_SMALL_VECTOR_BYTES 64
+#   endif
+
+struct _cds_small_vector_t {
+    cds_vector_t vector;
+    union {
+        cds_byte_t bytes[CDS_SMALL_VECTOR_BYTES];
+        long double _align_ld;
+        void *_align_ptr;
+        long _align_long;
+    } storage;
+};
+
+/**
+ * @brief A vector which keeps its first `CDS_SMALL_VECTOR_BYTES` bytes of
+ * elements inside the struct itself and only allocates a buffer on the heap
+ * once it outgrows them. Use `cds_small_vector_init` to initialise it and
+ * pass `&small->vector` to the other `cds_vector_*` functions.
+ * 
+ * As the vector points into the struct, a small vector must not be moved or
+ * copied (e.g. with memcpy or by assignment) once it has been initialised.
+ */
+typedef struct _cds_small_vector_t cds_small_vector_t;
+
 /**
  * @brief Get the pointer to the internal buffer.
  * 
@@ -67,6 +105,88 @@ cds_vector_t *cds_vector_new(void);
 CDS_PUBLIC
 cds_status_t cds_vector_init(cds_vector_t *self, size_t type_size);
 
+/**
+ * @brief Initialise the vector with a growth policy which decides how much
+ * the vector grows when it runs out of space and when it gives memory back.
+ * The vector only stores a pointer to the policy, so the policy must outlive
+ * the vector.
+ * 
+ * @param self The pointer to a vector object.
+ * @param type_size The size of the type being stored in bytes.
+ * @param policy The growth policy. If NULL, `CDS_DEFAULT_GROWTH_POLICY` is
+ * used.
+ * @return cds_status_t This operation's status code.
+ */
+CDS_PUBLIC
+cds_status_t cds_vector_init_with_policy(
+    cds_vector_t *self,
+    size_t type_size,
+    const cds_growth_policy_t *policy
+);
+
+/**
+ * @brief Initialise the vector with a growth policy and a custom allocator
+ * which all allocations made by the vector go through. The vector only stores
+ * pointers to the policy and the allocator, so both must outlive the vector.
+ * 
+ * @param self The pointer to a vector object.
+ * @param type_size The size of the type being stored in bytes.
+ * @param policy The growth policy. If NULL, `CDS_DEFAULT_GROWTH_POLICY` is
+ * used.
+ * @param allocator The allocator. If NULL, `CDS_DEFAULT_ALLOCATOR` is used.
+ * @return cds_status_t This operation's status code.
+ */
+CDS_PUBLIC
+cds_status_t cds_vector_init_with_allocator(
+    cds_vector_t *self,
+    size_t type_size,
+    const cds_growth_policy_t *policy,
+    const cds_allocator_t *allocator
+);
+
+/**
+ * @brief Initialise the vector so that it stores its elements in `storage`
+ * until they no longer fit, after which the elements are moved into a buffer
+ * on the heap. `storage` is never freed by the vector and must outlive it.
+ * If `storage` cannot hold a single element, the vector is initialised as
+ * though `cds_vector_init` was called.
+ * 
+ * @param self The pointer to a vector object.
+ * @param type_size The size of the type being stored in bytes.
+ * @param storage The inline memory block. It must be suitably aligned for
+ * the type being stored.
+ * @param bytes The size of `storage` in bytes.
+ * @return cds_status_t This operation's status code.
+ */
+CDS_PUBLIC
+cds_status_t cds_vector_init_inline(
+    cds_vector_t *self,
+    size_t type_size,
+    cds_ptr_t storage,
+    size_t bytes
+);
+
+/**
+ * @brief Initialise a small vector, whose first `CDS_SMALL_VECTOR_BYTES` bytes
+ * of elements are stored inside the small vector itself.
+ * 
+ * @param self The pointer to a small vector object.
+ * @param type_size The size of the type being stored in bytes.
+ * @return cds_status_t This operation's status code.
+ */
+CDS_PUBLIC
+cds_status_t cds_small_vector_init(cds_small_vector_t *self, size_t type_size);
+
+/**
+ * @brief Check whether the vector is still storing its elements in its inline
+ * memory block rather than on the heap.
+ * 
+ * @param self The pointer to a vector object.
+ * @return bool
+ */
+CDS_PUBLIC
+bool cds_vector_is_inline(cds_vector_t *self);
+
 /**
  * @brief Free up the memory used by the buffer in the vector but do not free
  * the vector itself. If you are using a 2-dimensional vector, you can pass
@@ -94,6 +214,112 @@ cds_status_t cds_vector_destroy(cds_vector_t *self, cds_free_f clean_element);
 CDS_PUBLIC
 cds_status_t cds_vector_free(cds_vector_t *self, cds_free_f clean_element);
 
+/**
+ * @brief Get the number of elements the vector can hold before it has to
+ * reallocate its buffer.
+ * 
+ * @param self The pointer to a vector object.
+ * @return size_t The capacity of the vector. 0 if `self` is NULL.
+ */
+CDS_PUBLIC
+size_t cds_vector_capacity(cds_vector_t *self);
+
+/**
+ * @brief Increase the capacity of the vector so that it can fit an additional
+ * specified number of elements (`amount`) without reallocating. Reserving
+ * ahead of time lets you fill a vector of a known size with only one
+ * allocation.
+ * 
+ * @param self The pointer to a vector object.
+ * @param amount The number of extra elements the vector should be able to
+ * hold on top of its current length.
+ * @return cds_status_t This operation's status code.
+ */
+CDS_PUBLIC
+cds_status_t cds_vector_reserve(cds_vector_t *self, size_t amount);
+
+/**
+ * @brief Remove unused capacity from the vector so that the buffer only holds
+ * the elements currently inside the vector.
+ * 
+ * @param self The pointer to a vector object.
+ * @return cds_status_t This operation's status code.
+ */
+CDS_PUBLIC
+cds_status_t cds_vector_shrink_to_fit(cds_vector_t *self);
+
+/**
+ * @brief Make the vector take ownership of an array instead of copying its
+ * elements in. The vector's current elements are dropped without being
+ * cleaned and its growth policy is kept. As the array comes from `malloc`,
+ * the vector switches to `CDS_MALLOC_ALLOCATOR`. The vector may have been
+ * destroyed, as long as it was initialised before.
+ * 
+ * @param self The pointer to a vector object.
+ * @param array The array, which must be a block of `capacity * type_size`
+ * bytes from `malloc`. It must not be used by the caller afterwards.
+ * @param length The number of elements in the array.
+ * @param capacity The number of elements the array has room for.
+ * @return cds_status_t This operation's status code. `cds_error` if
+ * `capacity` is 0 or lesser than `length`.
+ */
+CDS_PUBLIC
+cds_status_t cds_vector_adopt(
+    cds_vector_t *self,
+    cds_ptr_t array,
+    size_t length,
+    size_t capacity
+);
+
+/**
+ * @brief Take the array out of the vector and leave the vector destroyed, as
+ * if `cds_vector_destroy` had been called without cleaning the elements. The
+ * array always comes from `malloc`. It is not copied if the vector uses
+ * `CDS_MALLOC_ALLOCATOR`. Otherwise, including when the elements are stored
+ * inline, they are copied into a block from `malloc` first and the vector
+ * switches to `CDS_MALLOC_ALLOCATOR`.
+ * 
+ * @param self The pointer to a vector object.
+ * @param length Where the number of elements is written to, if not NULL.
+ * @param capacity Where the number of elements the array has room for is
+ * written to, if not NULL. The array must be given to `free`.
+ * @return cds_ptr_t The array. NULL if there is an error, in which case the
+ * vector is left untouched.
+ */
+CDS_PUBLIC
+cds_ptr_t cds_vector_release(
+    cds_vector_t *self,
+    size_t *length,
+    size_t *capacity
+);
+
+/**
+ * @brief Swap the elements, type sizes, growth policies and allocators of 2
+ * vectors without copying their elements. Vectors storing their elements
+ * inline move them onto the heap first.
+ * 
+ * @param self The pointer to a vector object.
+ * @param other The pointer to the other vector object.
+ * @return cds_status_t This operation's status code.
+ */
+CDS_PUBLIC
+cds_status_t cds_vector_swap(cds_vector_t *self, cds_vector_t *other);
+
+/**
+ * @brief Move every element of `other` to the end of `self`, leaving `other`
+ * empty. If `self` is empty, it takes over the array of `other` without
+ * copying, as long as neither vector stores its elements inline and both use
+ * the same allocator. Otherwise the elements are copied over with one
+ * `memcpy`.
+ * 
+ * @param self The pointer to a vector object.
+ * @param other The pointer to a vector object with the same type size.
+ * @return cds_status_t This operation's status code. `cds_error` if the type
+ * sizes differ or both are the same vector.
+ */
+CDS_PUBLIC
+cds_status_t cds_vector_append_move(cds_vector_t *self, cds_vector_t *other);
+
 /**
  * @brief Get the pointer to an element in the vector.
  * 
@@ -157,6 +383,30 @@ cds_status_t cds_vector_insert(cds_vector_t *self, size_t index, cds_ptr_t src);
 CDS_PUBLIC
 cds_status_t cds_vector_push_back(cds_vector_t *self, cds_ptr_t src);
 
+/**
+ * @brief Add an uninitialised element to the end of a vector and get a
+ * pointer to it, so that the element can be written in place instead of
+ * being built somewhere else and copied in.
+ * 
+ * @param self The pointer to a vector object.
+ * @return cds_ptr_t The pointer to the new element, which is valid until the
+ * vector is changed. NULL if the vector is NULL or could not grow.
+ */
+CDS_PUBLIC
+cds_ptr_t cds_vector_emplace_back(cds_vector_t *self);
+
+/**
+ * @brief Change the length of a vector in one step without touching the
+ * elements. New elements at the end are left uninitialised, and elements
+ * removed from the end are not cleaned up.
+ * 
+ * @param self The pointer to a vector object.
+ * @param length The new length.
+ * @return cds_status_t This operation's status code.
+ */
+CDS_PUBLIC
+cds_status_t cds_vector_resize_uninit(cds_vector_t *self, size_t length);
+
 /**
  * @brief Push an element to the front of the vector.
  * 
@@ -211,4 +461,93 @@ cds_status_t cds_vector_pop_back(cds_vector_t *self, cds_ptr_t dest);
 CDS_PUBLIC
 cds_status_t cds_vector_pop_front(cds_vector_t *self, cds_ptr_t dest);
 
+/**
+ * @brief Sort the elements of the vector in place using `cds_sort`.
+ * 
+ * @see cds_sort
+ * 
+ * @param self The pointer to a vector object.
+ * @param compare The function which compares 2 elements.
+ * @return cds_status_t This operation's status code.
+ */
+CDS_PUBLIC
+cds_status_t cds_vector_sort(cds_vector_t *self, cds_compare_f compare);
+
+/**
+ * @brief Find the index of the first element in a sorted vector which is not
+ * lesser than `key`.
+ * 
+ * @param self The pointer to a sorted vector object.
+ * @param key The pointer to the element to search for.
+ * @param compare The function which compares 2 elements.
+ * @return size_t The index of the element. The length of the vector if every
+ * element is lesser than `key`.
+ */
+CDS_PUBLIC
+size_t cds_vector_lower_bound(
+    cds_vector_t *self,
+    cds_ptr_t key,
+    cds_compare_f compare
+);
+
+/**
+ * @brief Find the index of the first element in a sorted vector which is
+ * greater than `key`.
+ * 
+ * @param self The pointer to a sorted vector object.
+ * @param key The pointer to the element to search for.
+ * @param compare The function which compares 2 elements.
+ * @return size_t The index of the element. The length of the vector if no
+ * element is greater than `key`.
+ */
+CDS_PUBLIC
+size_t cds_vector_upper_bound(
+    cds_vector_t *self,
+    cds_ptr_t key,
+    cds_compare_f compare
+);
+
+#   define _CDS_VECTOR_RADIX_SORT_DECLARE(stn, ltn) \
+    CDS_PUBLIC cds_status_t \
+    cds_vector_radix_sort_##stn(cds_vector_t *self, size_t key_offset);
+
+/**
+ * @brief Generates `cds_vector_radix_sort_<type>(self, key_offset)` for each
+ * type in `CDS_INTEGER_TYPES`, which radix sorts the elements of the vector
+ * by a key of that type found `key_offset` bytes into each element.
+ * 
+ * @see cds_radix_sort
+ */
+CDS_INTEGER_TYPES(_CDS_VECTOR_RADIX_SORT_DECLARE)
+
+#   undef _CDS_VECTOR_RADIX_SORT_DECLARE
+
+/**
+ * @brief Save the vector to a file as a `cds_serial_header_t` followed by its
+ * elements, which are written using a single `fwrite`.
+ * 
+ * @param self The pointer to a vector object.
+ * @param file The file to write to.
+ * @return cds_status_t This operation's status code. `cds_error` if the file
+ * could not be written to.
+ */
+CDS_PUBLIC
+cds_status_t cds_vector_write(cds_vector_t *self, FILE *file);
+
+/**
+ * @brief Load a vector saved by `cds_vector_write` or `cds_buffer_write`.
+ * The current elements of the vector are discarded without being cleaned,
+ * then enough capacity is reserved for the saved elements, which are read
+ * straight into the vector using a single `fread`.
+ * 
+ * @param self The pointer to an initialised vector object, whose type size
+ * must match the size of the saved elements.
+ * @param file The file to read from.
+ * @return cds_status_t This operation's status code. `cds_error` if the file
+ * is not a saved container of the same type size and endianness, is
+ * truncated or fails its checksum, in which case the vector is left empty.
+ */
+CDS_PUBLIC
+cds_status_t cds_vector_read(cds_vector_t *self, FILE *file);
+
 #endif
\ No newline at end of file
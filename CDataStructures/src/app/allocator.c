@@ -0,0 +1,245 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <CDataStructures.h>
+
+#define MAX_BLOCKS 256
+
+/**
+ * An allocator which remembers the size of every live block, so that it can
+ * check that each container resizes and frees its blocks with the sizes they
+ * were allocated with.
+ */
+struct counting_allocator_t {
+    cds_ptr_t blocks[MAX_BLOCKS];
+    size_t sizes[MAX_BLOCKS];
+    size_t allocs;
+    size_t reallocs;
+    size_t frees;
+    size_t mismatches;
+};
+
+static size_t find_block(struct counting_allocator_t *self, cds_ptr_t block) {
+    size_t slot = 0;
+    while (slot < MAX_BLOCKS && self->blocks[slot] != block)
+        ++slot;
+    return slot;
+}
+
+static cds_ptr_t counting_alloc(cds_ptr_t context, size_t size) {
+    struct counting_allocator_t *self = context;
+    size_t slot = find_block(self, NULL);
+    if (slot == MAX_BLOCKS)
+        return NULL;
+    cds_ptr_t block = malloc(size);
+    if (block == NULL)
+        return NULL;
+    self->blocks[slot] = block;
+    self->sizes[slot] = size;
+    ++self->allocs;
+    return block;
+}
+
+static cds_ptr_t counting_realloc(
+    cds_ptr_t context,
+    cds_ptr_t pointer,
+    size_t old_size,
+    size_t new_size
+) {
+    struct counting_allocator_t *self = context;
+    size_t slot = find_block(self, pointer);
+    if (slot == MAX_BLOCKS || self->sizes[slot] != old_size) {
+        ++self->mismatches;
+        return NULL;
+    }
+    cds_ptr_t block = realloc(pointer, new_size);
+    if (block == NULL)
+        return NULL;
+    self->blocks[slot] = block;
+    self->sizes[slot] = new_size;
+    ++self->reallocs;
+    return block;
+}
+
+static void counting_free(cds_ptr_t context, cds_ptr_t pointer, size_t size) {
+    struct counting_allocator_t *self = context;
+    size_t slot = find_block(self, pointer);
+    if (pointer == NULL)
+        return;
+    if (slot == MAX_BLOCKS || self->sizes[slot] != size) {
+        ++self->mismatches;
+        return;
+    }
+    free(pointer);
+    self->blocks[slot] = NULL;
+    ++self->frees;
+}
+
+/**
+ * Check that every block has been given back with the right size and that
+ * the allocator saw at least `allocs` allocations and `reallocs` resizes.
+ */
+static int check_counts(
+    struct counting_allocator_t *self,
+    size_t allocs,
+    size_t reallocs
+) {
+    printf(
+        "%lu allocs, %lu reallocs, %lu frees, %lu mismatches\n",
+        (unsigned long) self->allocs,
+        (unsigned long) self->reallocs,
+        (unsigned long) self->frees,
+        (unsigned long) self->mismatches
+    );
+    return self->mismatches != 0
+        || self->allocs != self->frees
+        || self->allocs < allocs
+        || self->reallocs < reallocs
+        || find_block(self, NULL) != 0;
+}
+
+static int test_buffer(const cds_allocator_t *allocator) {
+    printf("Testing dynbuffer with a counting allocator.\n");
+    cds_buffer_t buffer = cds_buffer_new_with_allocator(allocator);
+    if (CDS_IS_ERROR(cds_buffer_init(&buffer, sizeof(int)))) {
+        cds_buffer_free(buffer, NULL);
+        return 1;
+    }
+    int status = 0;
+    int number = 0;
+    for (; number < 1000 && !status; ++number)
+        status = CDS_IS_ERROR(cds_buffer_push_back(&buffer, &number));
+    while (!status && cds_buffer_cds_get_length(buffer) > 10)
+        status = CDS_IS_ERROR(cds_buffer_pop_back(&buffer, NULL));
+    status = status || CDS_IS_ERROR(cds_buffer_compact(&buffer));
+    cds_buffer_free(buffer, NULL);
+    return status;
+}
+
+static int test_slist(const cds_allocator_t *allocator) {
+    printf("Testing slist with a counting allocator.\n");
+    static int numbers[100];
+    cds_slist_t slist;
+    cds_ptr_t data = NULL;
+    if (CDS_IS_ERROR(cds_slist_init_with_allocator(&slist, allocator)))
+        return 1;
+    int status = 0;
+    size_t index = 0;
+    for (; index < 100 && !status; ++index) {
+        status = CDS_IS_ERROR(index % 2 == 0
+            ? cds_slist_push_back(&slist, &numbers[index])
+            : cds_slist_push_front(&slist, &numbers[index])
+        );
+    }
+    status = status
+        || CDS_IS_ERROR(cds_slist_insert(&slist, 50, &numbers[0]))
+        || CDS_IS_ERROR(cds_slist_remove(&slist, 20, &data))
+        || CDS_IS_ERROR(cds_slist_pop_front(&slist, &data))
+        || CDS_IS_ERROR(cds_slist_pop_back(&slist, &data))
+        || cds_slist_length(&slist) != 98;
+    cds_slist_destroy(&slist, NULL);
+    return status;
+}
+
+static int test_stack(const cds_allocator_t *allocator) {
+    printf("Testing stack with a counting allocator.\n");
+    static int numbers[100];
+    cds_stack_t stack;
+    cds_ptr_t data = NULL;
+    if (CDS_IS_ERROR(cds_stack_init_with_allocator(&stack, allocator)))
+        return 1;
+    int status = 0;
+    size_t index = 0;
+    for (; index < 100 && !status; ++index)
+        status = CDS_IS_ERROR(cds_stack_push(&stack, &numbers[index]));
+    for (index = 0; index < 30 && !status; ++index) {
+        status = CDS_IS_ERROR(cds_stack_pop(&stack, &data))
+            || data != &numbers[99 - index];
+    }
+    cds_stack_destroy(&stack, NULL);
+    return status;
+}
+
+static int test_unary_node(const cds_allocator_t *allocator) {
+    printf("Testing unary nodes with a counting allocator.\n");
+    static int numbers[10];
+    cds_unary_node_t *head = NULL;
+    int status = 0;
+    size_t index = 0;
+    for (; index < 10 && !status; ++index) {
+        cds_unary_node_t *node = cds_unary_node_new_with_allocator(allocator);
+        status = node == NULL || CDS_IS_ERROR(cds_unary_node_init(node));
+        if (node != NULL) {
+            node->data = &numbers[index];
+            node->next = head;
+            head = node;
+        }
+    }
+    status = CDS_IS_ERROR(
+        cds_unary_node_free_all_with_allocator(head, NULL, allocator)
+    ) || status;
+    return status;
+}
+
+/**
+ * Move blocks back and forth across the mapping threshold, then free them
+ * with sizes on the wrong side of it. The allocator has to remember how each
+ * block was allocated instead of guessing from the size.
+ */
+static int test_large_blocks(void) {
+    printf("Testing large blocks freed with the wrong size.\n");
+    static const cds_large_block_config_t config = {
+        .mmap_threshold = 8192,
+        .hugepage_threshold = 0
+    };
+    cds_allocator_t allocator = cds_large_block_allocator(&config);
+    unsigned char *small = cds_allocator_alloc(&allocator, 100);
+    unsigned char *large = cds_allocator_alloc(&allocator, 20000);
+    int status = small == NULL || large == NULL;
+    size_t index = 0;
+    for (; index < 100 && !status; ++index) {
+        small[index] = (unsigned char) index;
+        large[index] = (unsigned char) (index + 1);
+    }
+    if (!status) {
+        small = cds_allocator_realloc(&allocator, small, 100, 30000);
+        large = cds_allocator_realloc(&allocator, large, 20000, 50);
+        status = small == NULL || large == NULL;
+    }
+    for (index = 0; index < 50 && !status; ++index) {
+        status = small[index] != (unsigned char) index
+            || large[index] != (unsigned char) (index + 1);
+    }
+    cds_allocator_free(&allocator, small, 1);
+    cds_allocator_free(&allocator, large, 1 << 20);
+    return status;
+}
+
+int main(int argc, char **argv) {
+    printf("Test allocator.\n");
+    static struct counting_allocator_t context;
+    cds_allocator_t allocator = {
+        .alloc = counting_alloc,
+        .realloc = counting_realloc,
+        .free = counting_free,
+        .context = &context
+    };
+    // Each container has to route everything through the allocator: the
+    // buffer grows in place, and the lists allocate and free their nodes.
+    int status = test_buffer(&allocator) || check_counts(&context, 1, 5);
+    status = status
+        || test_slist(&allocator)
+        || check_counts(&context, 1 + 101, 5);
+    status = status
+        || test_stack(&allocator)
+        || check_counts(&context, 1 + 101 + 100, 5);
+    status = status
+        || test_unary_node(&allocator)
+        || check_counts(&context, 1 + 101 + 100 + 10, 5);
+    status = status || test_large_blocks();
+    if (status) {
+        printf("Errored out.\n");
+        return 1;
+    }
+    printf("Success.\n");
+    return 0;
+}
@@ -0,0 +1,199 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <pthread.h>
+#include <CDataStructures.h>
+
+#define THREADS 8
+#define RECORDS_PER_THREAD 200000
+#define BATCH 64
+#define MEMORY_LIMIT 4096
+
+typedef struct _record_t {
+    uint32_t thread;
+    uint32_t sequence;
+} record_t;
+
+typedef struct _worker_t {
+    cds_appender_t *appender;
+    cds_buffer_t *buffer;
+    pthread_mutex_t *mutex;
+    uint32_t thread;
+} worker_t;
+
+static void *append_records(void *argument) {
+    worker_t *worker = argument;
+    record_t batch[BATCH];
+    uint32_t sequence = 0;
+    while (sequence < RECORDS_PER_THREAD) {
+        size_t index = 0;
+        for (; index < BATCH && sequence < RECORDS_PER_THREAD; index++) {
+            batch[index].thread = worker->thread;
+            batch[index].sequence = sequence++;
+        }
+        if (CDS_IS_ERROR(cds_appender_append(worker->appender, batch, index)))
+            return argument;
+    }
+    return NULL;
+}
+
+static void *push_records(void *argument) {
+    worker_t *worker = argument;
+    uint32_t sequence = 0;
+    for (; sequence < RECORDS_PER_THREAD; sequence++) {
+        record_t record = {worker->thread, sequence};
+        pthread_mutex_lock(worker->mutex);
+        cds_status_t status = cds_buffer_push_back(worker->buffer, &record);
+        pthread_mutex_unlock(worker->mutex);
+        if (CDS_IS_ERROR(status))
+            return argument;
+    }
+    return NULL;
+}
+
+static int check_records(cds_buffer_t buffer) {
+    uint32_t next[THREADS] = {0};
+    size_t index = 0;
+    if (cds_buffer_cds_get_length(buffer) != THREADS * RECORDS_PER_THREAD)
+        return 1;
+    for (; index < THREADS * RECORDS_PER_THREAD; index++) {
+        record_t *record = cds_buffer_get(buffer, index);
+        // Each thread's records must appear in the order they were appended.
+        if (record->thread >= THREADS
+            || record->sequence != next[record->thread]++)
+            return 1;
+    }
+    return 0;
+}
+
+/**
+ * An allocator which refuses to hand out blocks larger than `MEMORY_LIMIT`
+ * bytes, so that the appender runs out of memory.
+ */
+static cds_ptr_t limited_alloc(cds_ptr_t context, size_t size) {
+    return size > MEMORY_LIMIT ? NULL : malloc(size);
+}
+
+static cds_ptr_t limited_realloc(
+    cds_ptr_t context,
+    cds_ptr_t pointer,
+    size_t old_size,
+    size_t new_size
+) {
+    return new_size > MEMORY_LIMIT ? NULL : realloc(pointer, new_size);
+}
+
+static void limited_free(cds_ptr_t context, cds_ptr_t pointer, size_t size) {
+    free(pointer);
+}
+
+/**
+ * Claims which fail must not throw away the elements committed before them.
+ */
+static int test_failed_claims(void) {
+    static const cds_allocator_t allocator = {
+        .alloc = limited_alloc,
+        .realloc = limited_realloc,
+        .free = limited_free,
+        .context = NULL
+    };
+    cds_buffer_t buffer = cds_buffer_new_with_allocator(&allocator);
+    cds_appender_t appender;
+    record_t batch[BATCH];
+    cds_ptr_t slots = NULL;
+    size_t committed = 0;
+    size_t index = 0;
+    if (CDS_IS_ERROR(cds_buffer_init(&buffer, sizeof(record_t)))
+        || CDS_IS_ERROR(cds_appender_init(&appender, buffer))) {
+        cds_buffer_free(buffer, NULL);
+        return 1;
+    }
+    for (; index < BATCH; index++) {
+        batch[index].thread = 0;
+        batch[index].sequence = (uint32_t) index;
+    }
+    // A claim which would overflow is refused without claiming anything.
+    int status = CDS_IS_ERROR(cds_appender_append(&appender, batch, BATCH))
+        || cds_appender_claim(&appender, SIZE_MAX, &slots) != cds_alloc_error;
+    committed = BATCH;
+    // Append until the buffer cannot grow any more. The slots of the batch
+    // which did not fit are lost, and so are the slots of every later claim.
+    cds_status_t appended = cds_ok;
+    while (!status && appended == cds_ok) {
+        appended = cds_appender_append(&appender, batch, BATCH);
+        if (appended == cds_ok)
+            committed += BATCH;
+        status = committed * sizeof(record_t) > MEMORY_LIMIT;
+    }
+    status = status
+        || appended != cds_alloc_error
+        || cds_appender_append(&appender, batch, 1) != cds_alloc_error
+        || cds_appender_length(&appender) != committed
+        || cds_appender_finish(&appender, &buffer) != cds_alloc_error
+        || cds_buffer_cds_get_length(buffer) != committed;
+    for (index = 0; index < committed && !status; index++) {
+        record_t *record = cds_buffer_get(buffer, index);
+        status = record->sequence != index % BATCH;
+    }
+    cds_buffer_free(buffer, NULL);
+    return status;
+}
+
+static double run(void *(*routine)(void *), worker_t *workers) {
+    pthread_t threads[THREADS];
+    struct timespec start, end;
+    size_t index = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (; index < THREADS; index++)
+        pthread_create(&threads[index], NULL, routine, &workers[index]);
+    for (index = 0; index < THREADS; index++)
+        pthread_join(threads[index], NULL);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    return (double) (end.tv_sec - start.tv_sec)
+        + (double) (end.tv_nsec - start.tv_nsec) / 1e9;
+}
+
+int main(int argc, char **argv) {
+    printf("Test appender.\n");
+    cds_buffer_t buffer = cds_buffer_new();
+    cds_buffer_t locked = cds_buffer_new();
+    cds_appender_t appender;
+    pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+    worker_t workers[THREADS];
+    if (CDS_IS_ERROR(cds_buffer_init(&buffer, sizeof(record_t)))
+        || CDS_IS_ERROR(cds_buffer_init(&locked, sizeof(record_t)))
+        || CDS_IS_ERROR(cds_appender_init(&appender, buffer))) {
+        printf("Could not initialise buffers.\n");
+        return 1;
+    }
+    size_t index = 0;
+    for (; index < THREADS; index++) {
+        workers[index].appender = &appender;
+        workers[index].buffer = &locked;
+        workers[index].mutex = &mutex;
+        workers[index].thread = (uint32_t) index;
+    }
+
+    double appender_time = run(append_records, workers);
+    double mutex_time = run(push_records, workers);
+    printf(
+        "Appending %d records from %d threads: appender %.3fs, mutex %.3fs\n",
+        THREADS * RECORDS_PER_THREAD,
+        THREADS,
+        appender_time,
+        mutex_time
+    );
+
+    int failed = CDS_IS_ERROR(cds_appender_finish(&appender, &buffer))
+        || check_records(buffer)
+        || check_records(locked)
+        || test_failed_claims();
+    cds_buffer_free(buffer, NULL);
+    cds_buffer_free(locked, NULL);
+    if (failed) {
+        printf("Records are missing or out of order.\n");
+        return 1;
+    }
+    printf("Success.\n");
+    return 0;
+}
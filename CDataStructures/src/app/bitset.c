@@ -0,0 +1,166 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <CDataStructures.h>
+
+#define TRIALS 40
+#define MAX_LENGTH 20000
+
+static int test_word_helpers(void) {
+    uint64_t word = 0x8000000000010F01;
+    return cds_uint64_popcount(word) != 7
+        || cds_uint64_trailing_zeros(word) != 0
+        || cds_uint64_trailing_zeros(word & ~(uint64_t) 1) != 8
+        || cds_uint64_trailing_zeros(0) != 64
+        || cds_uint64_select(word, 0) != 0
+        || cds_uint64_select(word, 4) != 11
+        || cds_uint64_select(word, 5) != 16
+        || cds_uint64_select(word, 6) != 63
+        || cds_uint64_select(word, 7) != 64;
+}
+
+/**
+ * Fill a bitset and an array of flags with the same random bits. `density`
+ * is the chance out of 1000 that a bit is set.
+ */
+static int fill(cds_bitset_t *bits, char *flags, int density) {
+    size_t index = 0;
+    for (; index < bits->length; index++) {
+        flags[index] = rand() % 1000 < density;
+        if (flags[index] && CDS_IS_ERROR(cds_bitset_set(bits, index)))
+            return 1;
+    }
+    return 0;
+}
+
+/**
+ * Check every query against the flags.
+ */
+static int check(cds_bitset_t *bits, const char *flags) {
+    size_t length = bits->length;
+    size_t ones = 0;
+    size_t next_set = length;
+    size_t next_clear = length;
+    size_t index = length;
+    size_t result = 0;
+    if (CDS_IS_ERROR(cds_bitset_build_index(bits)))
+        return 1;
+    // Walk backwards so that the next set and clear bits are known.
+    while (index-- > 0) {
+        if (cds_bitset_test(bits, index) != (bool) flags[index])
+            return 1;
+        if (flags[index])
+            next_set = index;
+        else
+            next_clear = index;
+        if (cds_bitset_find_next_set(bits, index) != next_set
+            || cds_bitset_find_next_clear(bits, index) != next_clear)
+            return 1;
+    }
+    for (index = 0; index < length; index++) {
+        if (CDS_IS_ERROR(cds_bitset_rank(bits, index, &result))
+            || result != ones)
+            return 1;
+        if (flags[index]) {
+            if (CDS_IS_ERROR(cds_bitset_select(bits, ones, &result))
+                || result != index)
+                return 1;
+            ones++;
+        }
+    }
+    return cds_bitset_count(bits) != ones
+        || CDS_IS_ERROR(cds_bitset_rank(bits, length, &result))
+        || result != ones
+        || cds_bitset_select(bits, ones, &result) != cds_index_error;
+}
+
+static int test_random(void) {
+    static const int densities[] = {0, 1, 30, 500, 990, 1000};
+    char *flags = malloc(MAX_LENGTH);
+    char *other_flags = malloc(MAX_LENGTH);
+    int status = flags == NULL || other_flags == NULL;
+    int trial = 0;
+    for (; trial < TRIALS && !status; trial++) {
+        size_t length = (size_t) rand() % MAX_LENGTH;
+        int density = densities[trial % 6];
+        cds_bitset_t bits;
+        cds_bitset_t other;
+        size_t index = 0;
+        if (CDS_IS_ERROR(cds_bitset_init(&bits, length))
+            || CDS_IS_ERROR(cds_bitset_init(&other, length))) {
+            status = 1;
+            break;
+        }
+        status = fill(&bits, flags, density)
+            || fill(&other, other_flags, 500)
+            || check(&bits, flags);
+        // The index goes stale as soon as a bit changes.
+        if (!status && length > 0) {
+            cds_bitset_flip(&bits, 0);
+            flags[0] = !flags[0];
+            status = cds_bitset_rank(&bits, 0, &index) != cds_error;
+        }
+        switch (trial % 4) {
+        case 0:
+            status = status || CDS_IS_ERROR(cds_bitset_and(&bits, &other));
+            for (index = 0; index < length; index++)
+                flags[index] = flags[index] && other_flags[index];
+            break;
+        case 1:
+            status = status || CDS_IS_ERROR(cds_bitset_or(&bits, &other));
+            for (index = 0; index < length; index++)
+                flags[index] = flags[index] || other_flags[index];
+            break;
+        case 2:
+            status = status || CDS_IS_ERROR(cds_bitset_xor(&bits, &other));
+            for (index = 0; index < length; index++)
+                flags[index] = flags[index] != other_flags[index];
+            break;
+        default:
+            status = status || CDS_IS_ERROR(cds_bitset_andnot(&bits, &other));
+            for (index = 0; index < length; index++)
+                flags[index] = flags[index] && !other_flags[index];
+            break;
+        }
+        status = status || check(&bits, flags);
+        // Shrinking and growing again must leave the new bits clear.
+        if (!status) {
+            size_t half = length / 2;
+            status = CDS_IS_ERROR(cds_bitset_resize(&bits, half))
+                || CDS_IS_ERROR(cds_bitset_resize(&bits, length));
+            memset(flags + half, 0, length - half);
+            status = status || check(&bits, flags);
+        }
+        if (!status) {
+            status = CDS_IS_ERROR(cds_bitset_fill(&bits, true));
+            memset(flags, 1, length);
+            status = status || check(&bits, flags);
+        }
+        status = status
+            || cds_bitset_set(&bits, length) != cds_index_error
+            || cds_bitset_and(&bits, &other) != cds_ok;
+        cds_bitset_destroy(&bits);
+        cds_bitset_destroy(&other);
+        if (status)
+            printf("Bitset of length %lu failed.\n", (unsigned long) length);
+    }
+    free(flags);
+    free(other_flags);
+    return status;
+}
+
+int main(int argc, char **argv) {
+    printf("Test bitset.\n");
+    srand(11);
+    if (test_word_helpers()) {
+        printf("Word helpers are wrong.\n");
+        printf("Errored out.\n");
+        return 1;
+    }
+    if (test_random()) {
+        printf("Errored out.\n");
+        return 1;
+    }
+    printf("Success.\n");
+    return 0;
+}
@@ -1,3 +1,4 @@
+#include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -6,7 +7,15 @@
 
 
 #define MAX_MESSAGE_LEN 16
+#define RANGE_ROUNDS 3000
+#define MAX_RANGE 24
+#define MAX_MODEL_LENGTH 1024
+#define SHIFTED_BLOCKS 16
+#define ALIGNMENT 64
+#define FILTER_LENGTH 40
+#define LARGE_LENGTH ((size_t) 2 << 20)
 
+CDS_DEFINE_BUFFER(int_buffer, int)
 
 struct message_t {
     size_t length;
@@ -56,6 +65,784 @@ static void clean_message(struct message_t *message) {
 }
 
 
+static int test_ring_queue(void) {
+    printf("Testing dynbuffer as a ring queue.\n");
+    cds_buffer_t queue = cds_buffer_new();
+    if (queue == NULL || CDS_IS_ERROR(cds_buffer_init(&queue, sizeof(int)))) {
+        printf("Could not create queue.\n");
+        return 1;
+    }
+    cds_buffer_set_ring(&queue, true);
+
+    int number = 0;
+    int popped = 0;
+    for (; number < 24; ++number) {
+        if (CDS_IS_ERROR(cds_buffer_push_back(&queue, &number)))
+            goto errored;
+        if (number % 3 == 2 && CDS_IS_ERROR(cds_buffer_pop_front(
+            &queue,
+            &popped
+        )))
+            goto errored;
+    }
+    printf(
+        "Queue length: %zu Head: %zu Shrinks avoided: %zu\n",
+        cds_buffer_cds_get_length(queue),
+        cds_buffer_cds_get_head(queue),
+        cds_buffer_cds_get_shrinks_avoided(queue)
+    );
+    cds_buffer_linearize(&queue);
+    size_t index = 0;
+    for (; index < cds_buffer_cds_get_length(queue); ++index) {
+        printf("%d ", ((int *) queue)[index]);
+    }
+    printf("\n");
+
+    cds_buffer_free(queue, NULL);
+    return 0;
+
+errored:
+    printf("Could not use queue.\n");
+    cds_buffer_free(queue, NULL);
+    return 1;
+}
+
+static int test_mapped_file(void) {
+#ifdef CDS_HAVE_MMAP
+    printf("Testing memory-mapped dynbuffer.\n");
+    const char *path = "CDataStructures-dynbuffer.map";
+    remove(path);
+    cds_buffer_t table = cds_buffer_map_file(
+        path,
+        sizeof(int),
+        cds_buffer_map_writable | cds_buffer_map_create
+    );
+    if (table == NULL) {
+        printf("Could not map file.\n");
+        return 1;
+    }
+    int number = 0;
+    for (; number < 1000; ++number) {
+        if (CDS_IS_ERROR(cds_buffer_push_back(&table, &number))) {
+            cds_buffer_free(table, NULL);
+            return 1;
+        }
+    }
+    if (CDS_IS_ERROR(cds_buffer_sync(table))) {
+        cds_buffer_free(table, NULL);
+        return 1;
+    }
+    cds_buffer_free(table, NULL);
+
+    // Reopen the file read-only and check that the elements are still there.
+    table = cds_buffer_map_file(path, sizeof(int), 0);
+    if (table == NULL) {
+        printf("Could not map file again.\n");
+        return 1;
+    }
+    printf(
+        "Mapped length: %zu Last element: %d\n",
+        cds_buffer_cds_get_length(table),
+        ((int *) table)[cds_buffer_cds_get_length(table) - 1]
+    );
+    int status = cds_buffer_cds_get_length(table) == 1000
+        && ((int *) table)[999] == 999 ? 0 : 1;
+    cds_buffer_free(table, NULL);
+
+    // Map the file twice, as 2 processes would. Each mapping keeps its own
+    // header and descriptor, so closing one must not break the other.
+    cds_buffer_t first = cds_buffer_map_file(
+        path,
+        sizeof(int),
+        cds_buffer_map_writable
+    );
+    cds_buffer_t second = cds_buffer_map_file(
+        path,
+        sizeof(int),
+        cds_buffer_map_writable
+    );
+    status = status || first == NULL || second == NULL;
+    for (number = 1000; number < 3000 && !status; ++number)
+        status = CDS_IS_ERROR(cds_buffer_push_back(&first, &number));
+    status = status
+        || cds_buffer_cds_get_length(second) != 1000
+        || ((int *) second)[999] != 999;
+    cds_buffer_free(second, NULL);
+    for (number = 3000; number < 6000 && !status; ++number)
+        status = CDS_IS_ERROR(cds_buffer_push_back(&first, &number));
+    cds_buffer_free(first, NULL);
+    table = cds_buffer_map_file(path, sizeof(int), 0);
+    status = status
+        || table == NULL
+        || cds_buffer_cds_get_length(table) != 6000
+        || ((int *) table)[5999] != 5999;
+    cds_buffer_free(table, NULL);
+
+    // A file without the magic number is not a buffer.
+    FILE *file = fopen(path, "r+b");
+    uint32_t garbage = 0;
+    status = status
+        || file == NULL
+        || fwrite(&garbage, sizeof(garbage), 1, file) != 1;
+    if (file != NULL)
+        fclose(file);
+    status = status || cds_buffer_map_file(path, sizeof(int), 0) != NULL;
+    remove(path);
+    return status;
+#else
+    return 0;
+#endif
+}
+
+static int test_emplace(void) {
+    printf("Testing emplace and uninitialised resize.\n");
+    cds_buffer_t buffer = cds_buffer_new();
+    if (CDS_IS_ERROR(cds_buffer_init(&buffer, sizeof(struct message_t))))
+        return 1;
+    struct message_t *message = cds_buffer_emplace_back(&buffer);
+    if (message == NULL) {
+        cds_buffer_free(buffer, NULL);
+        return 1;
+    }
+    *message = random_message();
+    size_t length = 8;
+    if (CDS_IS_ERROR(cds_buffer_resize_uninit(&buffer, length))) {
+        cds_buffer_free(buffer, (cds_free_f) clean_message);
+        return 1;
+    }
+    size_t index = 1;
+    for (; index < length; ++index)
+        *(struct message_t *) cds_buffer_get(buffer, index) = random_message();
+    int status = cds_buffer_cds_get_length(buffer) != length;
+    cds_buffer_free(buffer, (cds_free_f) clean_message);
+    return status;
+}
+
+/**
+ * Blocks this large are mapped by the default allocator. Appending one and
+ * swapping it around must keep each block with the allocator and size it
+ * was allocated with.
+ */
+static int test_large_append_move(void) {
+    printf("Testing append move of large buffers.\n");
+    cds_buffer_t target = cds_buffer_new();
+    cds_buffer_t source = cds_buffer_new();
+    int number = -1;
+    int status = CDS_IS_ERROR(cds_buffer_init(&target, sizeof(int)))
+        || CDS_IS_ERROR(cds_buffer_init(&source, sizeof(int)))
+        || CDS_IS_ERROR(cds_buffer_push_back(&target, &number))
+        || CDS_IS_ERROR(cds_buffer_resize_uninit(&source, LARGE_LENGTH));
+    size_t index = 0;
+    for (; index < LARGE_LENGTH && !status; ++index)
+        *(int *) cds_buffer_get(source, index) = (int) index;
+    status = status
+        || CDS_IS_ERROR(cds_buffer_append_move(&target, &source))
+        || CDS_IS_ERROR(cds_buffer_swap(&target, &source))
+        || CDS_IS_ERROR(cds_buffer_append_move(&target, &source))
+        || cds_buffer_cds_get_length(target) != LARGE_LENGTH + 1
+        || *(int *) cds_buffer_get(target, LARGE_LENGTH)
+            != (int) LARGE_LENGTH - 1
+        || CDS_IS_ERROR(cds_buffer_compact(&target));
+    cds_buffer_free(target, NULL);
+    cds_buffer_free(source, NULL);
+    return status;
+}
+
+static int test_append_move(void) {
+    printf("Testing append move.\n");
+    cds_buffer_t target = cds_buffer_new();
+    cds_buffer_t source = cds_buffer_new();
+    if (CDS_IS_ERROR(cds_buffer_init(&target, sizeof(int)))
+        || CDS_IS_ERROR(cds_buffer_init(&source, sizeof(int)))) {
+        cds_buffer_free(target, NULL);
+        cds_buffer_free(source, NULL);
+        return 1;
+    }
+    int number = 0;
+    for (; number < 10; ++number)
+        cds_buffer_push_back(&source, &number);
+    // An empty buffer takes the other buffer's block.
+    cds_buffer_t block = source;
+    int status = CDS_IS_ERROR(cds_buffer_append_move(&target, &source))
+        || target != block
+        || cds_buffer_cds_get_length(source) != 0;
+    // A wrapped ring buffer is copied in two pieces.
+    cds_buffer_set_ring(&source, true);
+    for (number = 10; number < 20; ++number)
+        cds_buffer_push_back(&source, &number);
+    for (number = 9; number >= 0; --number)
+        cds_buffer_push_front(&source, &number);
+    status = status
+        || CDS_IS_ERROR(cds_buffer_append_move(&target, &source))
+        || cds_buffer_cds_get_length(source) != 0
+        || cds_buffer_cds_get_length(target) != 30;
+    size_t index = 0;
+    for (; index < 30 && !status; ++index) {
+        int expected = (int) (index % 10) + (index >= 20 ? 10 : 0);
+        status = *(int *) cds_buffer_get(target, index) != expected;
+    }
+    // Appending one element at a time must grow by the policy rather than
+    // by exactly one element each time.
+    size_t reserved = cds_buffer_cds_get_reserved(target);
+    size_t growths = 0;
+    for (number = 0; number < 1000 && !status; ++number) {
+        status = CDS_IS_ERROR(cds_buffer_push_back(&source, &number))
+            || CDS_IS_ERROR(cds_buffer_append_move(&target, &source));
+        if (cds_buffer_cds_get_reserved(target) != reserved) {
+            reserved = cds_buffer_cds_get_reserved(target);
+            growths++;
+        }
+    }
+    status = status
+        || cds_buffer_cds_get_length(target) != 1030
+        || growths > 20
+        || *(int *) cds_buffer_get(target, 1029) != 999;
+    cds_buffer_free(target, NULL);
+    cds_buffer_free(source, NULL);
+    return status || test_large_append_move();
+}
+
+/**
+ * Check that the buffer holds the same elements as the plain array and count
+ * the times the elements wrap around the end of the block.
+ */
+static int check_model(
+    cds_buffer_t buffer,
+    const int *model,
+    size_t length,
+    size_t *wraps
+) {
+    if (cds_buffer_cds_get_length(buffer) != length)
+        return 1;
+    if (cds_buffer_cds_get_head(buffer) + length
+        > cds_buffer_cds_get_reserved(buffer))
+        ++*wraps;
+    size_t index = 0;
+    for (; index < length; ++index) {
+        if (*(int *) cds_buffer_get(buffer, index) != model[index])
+            return 1;
+    }
+    return 0;
+}
+
+/**
+ * Insert, append and remove random ranges at random places in a buffer and
+ * in a plain array side by side, so that ranges are copied in and out of
+ * ring buffers which wrap around.
+ */
+static int test_random_ranges(bool ring) {
+    printf("Testing random ranges on a %s buffer.\n", ring ? "ring" : "linear");
+    static int model[MAX_MODEL_LENGTH];
+    int values[MAX_RANGE];
+    int removed[MAX_RANGE];
+    size_t length = 0;
+    size_t wraps = 0;
+    int next = 0;
+    cds_buffer_t buffer = cds_buffer_new();
+    if (CDS_IS_ERROR(cds_buffer_init(&buffer, sizeof(int)))
+        || CDS_IS_ERROR(cds_buffer_set_ring(&buffer, ring))) {
+        cds_buffer_free(buffer, NULL);
+        return 1;
+    }
+    int status = 0;
+    size_t round = 0;
+    for (; round < RANGE_ROUNDS && !status; ++round) {
+        size_t count = (size_t) rand() % MAX_RANGE;
+        size_t index = (size_t) rand() % (length + 1);
+        size_t value = 0;
+        int operation = rand() % 4;
+        // Drain the buffer while it is too long to take another range.
+        if (length + count >= MAX_MODEL_LENGTH)
+            operation = 3;
+        switch (operation) {
+        case 0:
+            for (value = 0; value < count; ++value)
+                values[value] = next++;
+            status = CDS_IS_ERROR(
+                cds_buffer_insert_range(&buffer, index, values, count)
+            );
+            memmove(
+                model + index + count,
+                model + index,
+                (length - index) * sizeof(int)
+            );
+            memcpy(model + index, values, count * sizeof(int));
+            length += count;
+            break;
+        case 1:
+            for (value = 0; value < count; ++value)
+                values[value] = next++;
+            status = CDS_IS_ERROR(cds_buffer_extend(&buffer, values, count));
+            memcpy(model + length, values, count * sizeof(int));
+            length += count;
+            break;
+        case 2:
+            // Move the head so that later ranges straddle the end.
+            status = CDS_IS_ERROR(cds_buffer_push_front(&buffer, &next));
+            memmove(model + 1, model, length * sizeof(int));
+            model[0] = next++;
+            ++length;
+            break;
+        default:
+            if (count > length - index)
+                count = length - index;
+            status = CDS_IS_ERROR(
+                cds_buffer_remove_range(&buffer, index, count, removed)
+            ) || memcmp(removed, model + index, count * sizeof(int)) != 0;
+            memmove(
+                model + index,
+                model + index + count,
+                (length - index - count) * sizeof(int)
+            );
+            length -= count;
+            break;
+        }
+        status = status || check_model(buffer, model, length, &wraps);
+        if (status)
+            printf("Round %lu failed.\n", (unsigned long) round);
+    }
+    printf("Wrapped around in %lu rounds.\n", (unsigned long) wraps);
+    // Rings must actually wrap for the test to cover the split copies.
+    status = status || (ring && wraps == 0);
+    cds_buffer_free(buffer, NULL);
+    return status;
+}
+
+/**
+ * An allocator which hands out blocks at a different offset from `malloc`
+ * every time, so that the padding in front of an aligned buffer has to
+ * change whenever the buffer is moved to a new block.
+ */
+struct shifting_allocator_t {
+    cds_byte_t *bases[SHIFTED_BLOCKS];
+    cds_byte_t *blocks[SHIFTED_BLOCKS];
+    size_t allocations;
+};
+
+static cds_ptr_t shifting_alloc(cds_ptr_t context, size_t size) {
+    struct shifting_allocator_t *self = context;
+    size_t slot = 0;
+    while (slot < SHIFTED_BLOCKS && self->bases[slot] != NULL)
+        ++slot;
+    if (slot == SHIFTED_BLOCKS)
+        return NULL;
+    cds_byte_t *base = malloc(size + ALIGNMENT);
+    if (base == NULL)
+        return NULL;
+    self->bases[slot] = base;
+    self->blocks[slot] = base + 8 * (self->allocations++ % 8);
+    return self->blocks[slot];
+}
+
+static void shifting_free(cds_ptr_t context, cds_ptr_t pointer, size_t size) {
+    struct shifting_allocator_t *self = context;
+    size_t slot = 0;
+    for (; slot < SHIFTED_BLOCKS; ++slot) {
+        if (self->blocks[slot] == pointer && pointer != NULL) {
+            free(self->bases[slot]);
+            self->bases[slot] = NULL;
+            self->blocks[slot] = NULL;
+        }
+    }
+}
+
+/**
+ * Check that the elements are aligned and still count up from 0.
+ */
+static int check_aligned(cds_buffer_t buffer) {
+    double *numbers = (double *) buffer;
+    size_t length = cds_buffer_cds_get_length(buffer);
+    size_t index = 0;
+    if ((uintptr_t) buffer % ALIGNMENT != 0)
+        return 1;
+    for (; index < length; ++index) {
+        if (numbers[index] != (double) index)
+            return 1;
+    }
+    return 0;
+}
+
+static int test_aligned(const cds_allocator_t *allocator) {
+    printf("Testing aligned buffer.\n");
+    cds_buffer_t buffer = cds_buffer_new_with_allocator(allocator);
+    if (CDS_IS_ERROR(
+        cds_buffer_init_aligned(&buffer, sizeof(double), ALIGNMENT)
+    )) {
+        cds_buffer_free(buffer, NULL);
+        return 1;
+    }
+    int status = check_aligned(buffer);
+    size_t reserved = cds_buffer_cds_get_reserved(buffer);
+    double number = 0;
+    // Every growth moves the elements to a new block.
+    for (; number < 1000 && !status; ++number) {
+        status = CDS_IS_ERROR(cds_buffer_push_back(&buffer, &number));
+        if (cds_buffer_cds_get_reserved(buffer) != reserved) {
+            reserved = cds_buffer_cds_get_reserved(buffer);
+            status = status || check_aligned(buffer);
+        }
+    }
+    while (!status && cds_buffer_cds_get_length(buffer) > 100)
+        status = CDS_IS_ERROR(cds_buffer_pop_back(&buffer, NULL));
+    status = status
+        || CDS_IS_ERROR(cds_buffer_compact(&buffer))
+        || cds_buffer_cds_get_reserved(buffer) != 100
+        || cds_buffer_cds_get_alignment(buffer) != ALIGNMENT
+        || check_aligned(buffer);
+    cds_buffer_free(buffer, NULL);
+    return status;
+}
+
+static int test_aligned_moves(void) {
+    struct shifting_allocator_t context = {{NULL}, {NULL}, 0};
+    cds_allocator_t allocator = {
+        .alloc = shifting_alloc,
+        .realloc = NULL,
+        .free = shifting_free,
+        .context = &context
+    };
+    size_t slot = 0;
+    int status = test_aligned(NULL) || test_aligned(&allocator);
+    // The offset from `malloc` goes round every 8 blocks, so the padding
+    // must have changed on the way.
+    status = status || context.allocations < 8;
+    for (; slot < SHIFTED_BLOCKS; ++slot)
+        status = status || context.bases[slot] != NULL;
+    return status;
+}
+
+static size_t cleaned_count = 0;
+static int cleaned_sum = 0;
+
+static void clean_number(int *number) {
+    ++cleaned_count;
+    cleaned_sum += *number;
+}
+
+static bool is_multiple(int *number, int *divisor) {
+    return *number % *divisor == 0;
+}
+
+/**
+ * Check that the buffer holds every number from 0 up to `FILTER_LENGTH`
+ * which `is_multiple` keeps, in order, and that every other number was
+ * passed to `clean_number` once.
+ */
+static int check_filtered(cds_buffer_t buffer, int divisor, bool keep) {
+    size_t length = 0;
+    size_t removed = 0;
+    int removed_sum = 0;
+    int number = 0;
+    for (; number < FILTER_LENGTH; ++number) {
+        if (is_multiple(&number, &divisor) != keep) {
+            ++removed;
+            removed_sum += number;
+        } else if (length >= cds_buffer_cds_get_length(buffer)
+            || *(int *) cds_buffer_get(buffer, length++) != number) {
+            return 1;
+        }
+    }
+    return length != cds_buffer_cds_get_length(buffer)
+        || removed != cleaned_count
+        || removed_sum != cleaned_sum;
+}
+
+/**
+ * Fill a buffer with the numbers from 0 up to `FILTER_LENGTH`. Ring buffers
+ * get the first half pushed to the front so that the elements wrap.
+ */
+static int fill_numbers(cds_buffer_t *buffer, bool ring) {
+    int number = 0;
+    cleaned_count = 0;
+    cleaned_sum = 0;
+    if (CDS_IS_ERROR(cds_buffer_init(buffer, sizeof(int)))
+        || CDS_IS_ERROR(cds_buffer_set_ring(buffer, ring)))
+        return 1;
+    for (number = FILTER_LENGTH / 2; number < FILTER_LENGTH; ++number) {
+        if (CDS_IS_ERROR(cds_buffer_push_back(buffer, &number)))
+            return 1;
+    }
+    for (number = FILTER_LENGTH / 2 - 1; number >= 0; --number) {
+        if (CDS_IS_ERROR(cds_buffer_push_front(buffer, &number)))
+            return 1;
+    }
+    return ring && cds_buffer_cds_get_head(*buffer) + FILTER_LENGTH
+        <= cds_buffer_cds_get_reserved(*buffer);
+}
+
+static int test_filters(bool ring) {
+    printf("Testing filters on a %s buffer.\n", ring ? "ring" : "linear");
+    int divisor = 2;
+    int status = 0;
+    cds_buffer_t buffer = cds_buffer_new();
+    // Keep the even numbers.
+    status = fill_numbers(&buffer, ring)
+        || CDS_IS_ERROR(cds_buffer_retain(
+            &buffer,
+            (cds_predicate_f) is_multiple,
+            &divisor,
+            NULL
+        ));
+    divisor = 3;
+    cleaned_count = 0;
+    cleaned_sum = 0;
+    // The odd numbers went without being cleaned up. Now drop the even
+    // multiples of 3, which leaves the numbers which are multiples of 2 and
+    // not 3, while cleaning the rest.
+    status = status
+        || cleaned_count != 0
+        || cds_buffer_cds_get_length(buffer) != FILTER_LENGTH / 2
+        || CDS_IS_ERROR(cds_buffer_remove_if(
+            &buffer,
+            (cds_predicate_f) is_multiple,
+            &divisor,
+            (cds_free_f) clean_number
+        ))
+        || cleaned_count != 7
+        || cleaned_sum != 0 + 6 + 12 + 18 + 24 + 30 + 36;
+    cds_buffer_free(buffer, NULL);
+    buffer = cds_buffer_new();
+    // Keep the multiples of 4.
+    divisor = 4;
+    status = status
+        || fill_numbers(&buffer, ring)
+        || CDS_IS_ERROR(cds_buffer_retain(
+            &buffer,
+            (cds_predicate_f) is_multiple,
+            &divisor,
+            (cds_free_f) clean_number
+        ))
+        || check_filtered(buffer, divisor, true);
+    cds_buffer_free(buffer, NULL);
+    buffer = cds_buffer_new();
+    divisor = 5;
+    status = status
+        || fill_numbers(&buffer, ring)
+        || CDS_IS_ERROR(cds_buffer_remove_if(
+            &buffer,
+            (cds_predicate_f) is_multiple,
+            &divisor,
+            (cds_free_f) clean_number
+        ))
+        || check_filtered(buffer, divisor, false);
+    cds_buffer_free(buffer, NULL);
+    // Swap removal moves the last number into the hole.
+    buffer = cds_buffer_new();
+    int removed = -1;
+    status = status
+        || fill_numbers(&buffer, ring)
+        || CDS_IS_ERROR(cds_buffer_swap_remove(&buffer, 0, &removed))
+        || removed != 0
+        || *(int *) cds_buffer_get(buffer, 0) != FILTER_LENGTH - 1
+        || CDS_IS_ERROR(cds_buffer_swap_remove(&buffer, 10, NULL))
+        || *(int *) cds_buffer_get(buffer, 10) != FILTER_LENGTH - 2
+        || CDS_IS_ERROR(cds_buffer_swap_remove(
+            &buffer,
+            FILTER_LENGTH - 3,
+            &removed
+        ))
+        || removed != FILTER_LENGTH - 3
+        || cds_buffer_cds_get_length(buffer) != FILTER_LENGTH - 3
+        || *(int *) cds_buffer_get(buffer, 1) != 1
+        || *(int *) cds_buffer_get(buffer, FILTER_LENGTH / 2)
+            != FILTER_LENGTH / 2
+        || cds_buffer_swap_remove(&buffer, FILTER_LENGTH, NULL)
+            != cds_index_error;
+    cds_buffer_free(buffer, NULL);
+    return status;
+}
+
+/**
+ * Save a buffer holding the numbers from 0 up to `length` and load it into
+ * `loaded`, checking that the numbers come back in order.
+ */
+static int round_trip(cds_buffer_t buffer, cds_buffer_t *loaded, FILE *file) {
+    size_t length = cds_buffer_cds_get_length(buffer);
+    size_t index = 0;
+    cds_ptr_t first = cds_buffer_get(buffer, 0);
+    rewind(file);
+    // Writing must leave the elements where they are, even in a wrapped
+    // ring, since other owners may be reading them.
+    if (CDS_IS_ERROR(cds_buffer_write(buffer, file))
+        || cds_buffer_get(buffer, 0) != first)
+        return 1;
+    rewind(file);
+    if (CDS_IS_ERROR(cds_buffer_read(loaded, file))
+        || cds_buffer_cds_get_length(*loaded) != length)
+        return 1;
+    for (; index < length; ++index) {
+        if (*(int *) cds_buffer_get(*loaded, index) != (int) index)
+            return 1;
+    }
+    return 0;
+}
+
+/**
+ * Overwrite `size` bytes at `offset` in a file.
+ */
+static int patch_file(FILE *file, long offset, cds_ptr_t data, size_t size) {
+    return fseek(file, offset, SEEK_SET) != 0
+        || fwrite(data, 1, size, file) != size
+        || fflush(file) != 0;
+}
+
+/**
+ * Load a buffer from the start of a file, which must fail and leave the
+ * buffer empty.
+ */
+static int load_rejected(FILE *file, cds_buffer_t *loaded) {
+    rewind(file);
+    return cds_buffer_read(loaded, file) != cds_error
+        || cds_buffer_cds_get_length(*loaded) != 0;
+}
+
+static int test_serialize(void) {
+    printf("Testing saving and loading buffers.\n");
+    FILE *file = tmpfile();
+    FILE *truncated = tmpfile();
+    cds_buffer_t buffer = cds_buffer_new();
+    cds_buffer_t loaded = cds_buffer_new();
+    int status = file == NULL
+        || truncated == NULL
+        || CDS_IS_ERROR(cds_buffer_init(&buffer, sizeof(int)))
+        || CDS_IS_ERROR(cds_buffer_init(&loaded, sizeof(int)));
+    int number = 0;
+    for (number = 0; number < 500 && !status; ++number)
+        status = CDS_IS_ERROR(cds_buffer_push_back(&buffer, &number));
+    status = status || round_trip(buffer, &loaded, file);
+    // A ring whose elements wrap around the end of its block.
+    cds_buffer_free(buffer, NULL);
+    buffer = cds_buffer_new();
+    status = status
+        || fill_numbers(&buffer, true)
+        || round_trip(buffer, &loaded, file);
+    long size = status ? 0 : ftell(file);
+    // Copy all but the last byte to cut the elements short.
+    char byte = 0;
+    long offset = 0;
+    rewind(file);
+    for (; offset < size - 1 && !status; ++offset) {
+        status = fread(&byte, 1, 1, file) != 1
+            || fwrite(&byte, 1, 1, truncated) != 1;
+    }
+    status = status
+        || fflush(truncated) != 0
+        || load_rejected(truncated, &loaded);
+    // Change the last element so that the checksum fails.
+    int zero = 0;
+    status = status
+        || round_trip(buffer, &loaded, file)
+        || patch_file(file, size - (long) sizeof(int), &zero, sizeof(int))
+        || load_rejected(file, &loaded);
+    // Claim far more elements than the file holds. This must be caught
+    // before the buffer tries to allocate them.
+    uint64_t length = (uint64_t) 1 << 40;
+    size_t reserved = status ? 0 : cds_buffer_cds_get_reserved(loaded);
+    status = status
+        || patch_file(
+            file,
+            (long) offsetof(cds_serial_header_t, length),
+            &length,
+            sizeof(length)
+        )
+        || load_rejected(file, &loaded)
+        || cds_buffer_cds_get_reserved(loaded) != reserved;
+    if (file != NULL)
+        fclose(file);
+    if (truncated != NULL)
+        fclose(truncated);
+    cds_buffer_free(buffer, NULL);
+    cds_buffer_free(loaded, NULL);
+    return status;
+}
+
+/**
+ * A floor larger than the buffer stops it from shrinking, so every time the
+ * length falls past the shrink percentage counts as one avoided shrink, no
+ * matter how many more elements are popped afterwards.
+ */
+static int test_shrinks_avoided(void) {
+    printf("Testing avoided shrinks.\n");
+    cds_growth_policy_t policy = CDS_DEFAULT_GROWTH_POLICY;
+    policy.shrink_floor = 1 << 20;
+    cds_buffer_t generic = cds_buffer_new();
+    cds_buffer_t typed = cds_buffer_new();
+    if (CDS_IS_ERROR(
+            cds_buffer_init_with_policy(&generic, sizeof(int), &policy)
+        )
+        || CDS_IS_ERROR(
+            cds_buffer_init_with_policy(&typed, sizeof(int), &policy)
+        )) {
+        cds_buffer_free(generic, NULL);
+        cds_buffer_free(typed, NULL);
+        return 1;
+    }
+    int number = 0;
+    for (; number < 100; ++number) {
+        cds_buffer_push_back(&generic, &number);
+        int_buffer_push_back(&typed, number);
+    }
+    size_t threshold = cds_growth_policy_shrink_threshold(
+        &policy,
+        cds_buffer_cds_get_reserved(generic)
+    );
+    int status = 0;
+    // Removals above the threshold never count.
+    while (cds_buffer_cds_get_length(generic) > threshold) {
+        cds_buffer_pop_back(&generic, NULL);
+        int_buffer_pop_back(&typed, NULL);
+    }
+    status = cds_buffer_cds_get_shrinks_avoided(generic) != 0
+        || cds_buffer_cds_get_shrinks_avoided(typed) != 0;
+    while (cds_buffer_cds_get_length(generic) > 0) {
+        cds_buffer_pop_back(&generic, NULL);
+        int_buffer_pop_back(&typed, NULL);
+    }
+    status = status
+        || cds_buffer_cds_get_shrinks_avoided(generic) != 1
+        || cds_buffer_cds_get_shrinks_avoided(typed) != 1
+        || cds_buffer_cds_get_reserved(generic)
+            != cds_buffer_cds_get_reserved(typed);
+    cds_buffer_free(generic, NULL);
+    cds_buffer_free(typed, NULL);
+    return status;
+}
+
+static int test_shared(void) {
+    printf("Testing shared dynbuffer.\n");
+    cds_buffer_t original = cds_buffer_new();
+    if (CDS_IS_ERROR(cds_buffer_init(&original, sizeof(int))))
+        return 1;
+    int number = 0;
+    for (; number < 100; ++number)
+        cds_buffer_push_back(&original, &number);
+    cds_buffer_t reader = cds_buffer_share(original);
+    cds_buffer_t writer = cds_buffer_share(original);
+    int status = reader != original || !cds_buffer_is_shared(original);
+    // Changing the buffer gives the writer its own copy.
+    number = -1;
+    cds_buffer_insert(&writer, 0, &number);
+    cds_buffer_remove(&writer, 50, NULL);
+    status = status
+        || writer == original
+        || cds_buffer_cds_get_length(original) != 100
+        || cds_buffer_cds_get_length(writer) != 100
+        || *(int *) cds_buffer_get(original, 0) != 0
+        || *(int *) cds_buffer_get(writer, 0) != -1
+        || *(int *) cds_buffer_get(writer, 50) != 50;
+    cds_buffer_free(original, NULL);
+    // The reader is now the only owner, so changing it copies nothing.
+    status = status || cds_buffer_is_shared(reader);
+    cds_buffer_pop_back(&reader, NULL);
+    status = status
+        || reader != original
+        || cds_buffer_cds_get_length(reader) != 99;
+    printf("Shared buffers %s.\n", status ? "differ" : "match");
+    cds_buffer_free(reader, NULL);
+    cds_buffer_free(writer, NULL);
+    return status;
+}
+
 int main(int argc, char **argv) {
     printf("Testing dynbuffer.\n");
 
@@ -135,6 +922,36 @@ int main(int argc, char **argv) {
     }
     */
 
+    if (test_ring_queue() != 0)
+        goto errored;
+
+    if (test_mapped_file() != 0)
+        goto errored;
+
+    if (test_shared() != 0)
+        goto errored;
+
+    if (test_emplace() != 0)
+        goto errored;
+
+    if (test_append_move() != 0)
+        goto errored;
+
+    if (test_shrinks_avoided() != 0)
+        goto errored;
+
+    if (test_random_ranges(false) != 0 || test_random_ranges(true) != 0)
+        goto errored;
+
+    if (test_aligned_moves() != 0)
+        goto errored;
+
+    if (test_filters(false) != 0 || test_filters(true) != 0)
+        goto errored;
+
+    if (test_serialize() != 0)
+        goto errored;
+
     goto success;
 
 success:
@@ -0,0 +1,211 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <CDataStructures.h>
+
+#define KEY_RANGE 5000
+#define BATCHES 20
+#define BENCHMARK_LENGTH 1000000
+#define LOOKUPS 2000000
+
+typedef struct _expected_t {
+    int64_t value;
+    bool present;
+} expected_t;
+
+static double now(void) {
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (double) time.tv_sec + (double) time.tv_nsec / 1e9;
+}
+
+static cds_ordering_t compare_int32(cds_ptr_t a, cds_ptr_t b) {
+    return cds_int32_compare_pointers(a, b);
+}
+
+static cds_ordering_t compare_name(cds_ptr_t a, cds_ptr_t b) {
+    int result = memcmp(a, b, 3);
+    return result < 0 ? cds_lesser : result > 0 ? cds_greater : cds_equal;
+}
+
+/**
+ * Check every entry, the order of the keys and a lookup of every key in the
+ * key range against the expected entries.
+ */
+static int check(cds_flatmap_t *map, expected_t *expected) {
+    size_t count = 0;
+    size_t index = 0;
+    int32_t key = 0;
+    for (; key < KEY_RANGE; key++) {
+        int64_t *value = cds_flatmap_find(map, &key);
+        if (expected[key].present != (value != NULL)
+            || (value != NULL && *value != expected[key].value))
+            return 1;
+        count += expected[key].present;
+    }
+    if (cds_flatmap_length(map) != count)
+        return 1;
+    for (index = 1; index < count; index++) {
+        if (compare_int32(
+            cds_flatmap_key_at(map, index - 1),
+            cds_flatmap_key_at(map, index)
+        ) >= 0)
+            return 1;
+    }
+    return 0;
+}
+
+static void random_entries(
+    int32_t *keys,
+    int64_t *values,
+    size_t count,
+    expected_t *expected
+) {
+    size_t index = 0;
+    for (; index < count; index++) {
+        keys[index] = rand() % KEY_RANGE;
+        values[index] = (int64_t) rand() * 1000 + (int64_t) index;
+        expected[keys[index]].value = values[index];
+        expected[keys[index]].present = true;
+    }
+}
+
+static int test_map(void) {
+    static int32_t keys[KEY_RANGE];
+    static int64_t values[KEY_RANGE];
+    static expected_t expected[KEY_RANGE];
+    cds_flatmap_t map;
+    if (CDS_IS_ERROR(cds_flatmap_init(
+        &map,
+        sizeof(int32_t),
+        sizeof(int64_t),
+        compare_int32
+    )))
+        return 1;
+    int status = map.value_offset != 8 || map.entries.type_size != 16;
+    random_entries(keys, values, KEY_RANGE / 2, expected);
+    status = status
+        || CDS_IS_ERROR(cds_flatmap_build(&map, keys, values, KEY_RANGE / 2))
+        || check(&map, expected);
+    int batch = 0;
+    for (; batch < BATCHES && !status; batch++) {
+        size_t count = (size_t) rand() % 300;
+        random_entries(keys, values, count, expected);
+        status = CDS_IS_ERROR(
+            cds_flatmap_insert_batch(&map, keys, values, count)
+        );
+        // Single inserts and removals in between the batches.
+        int32_t key = rand() % KEY_RANGE;
+        int64_t value = -batch;
+        int64_t removed = 0;
+        status = status || CDS_IS_ERROR(cds_flatmap_insert(&map, &key, &value));
+        expected[key].value = value;
+        expected[key].present = true;
+        key = rand() % KEY_RANGE;
+        if (expected[key].present) {
+            status = status
+                || CDS_IS_ERROR(cds_flatmap_remove(&map, &key, &removed))
+                || removed != expected[key].value;
+            expected[key].present = false;
+        } else {
+            status = status
+                || cds_flatmap_remove(&map, &key, NULL) != cds_index_error;
+        }
+        status = status || check(&map, expected);
+    }
+    int32_t past = KEY_RANGE;
+    status = status
+        || cds_flatmap_lower_bound(&map, &past) != cds_flatmap_length(&map)
+        || CDS_IS_ERROR(cds_flatmap_build(&map, keys, values, 0))
+        || cds_flatmap_length(&map) != 0
+        || cds_flatmap_contains(&map, &keys[0]);
+    cds_flatmap_destroy(&map, NULL, NULL);
+    return status;
+}
+
+/**
+ * Keys of 3 bytes with no values make a sorted set.
+ */
+static int test_set(void) {
+    static const char names[] = "catdogcowdogantcat";
+    cds_flatmap_t set;
+    if (CDS_IS_ERROR(cds_flatmap_init(&set, 3, 0, compare_name)))
+        return 1;
+    int status = CDS_IS_ERROR(
+        cds_flatmap_build(&set, (cds_ptr_t) names, NULL, 6)
+    );
+    status = status
+        || cds_flatmap_length(&set) != 4
+        || set.entries.type_size != 3
+        || memcmp(cds_flatmap_key_at(&set, 0), "antcatcowdog", 12) != 0
+        || !cds_flatmap_contains(&set, "cow")
+        || cds_flatmap_contains(&set, "cab")
+        || cds_flatmap_lower_bound(&set, "cab") != 1;
+    cds_flatmap_destroy(&set, NULL, NULL);
+    return status;
+}
+
+static void benchmark(void) {
+    cds_flatmap_t map;
+    cds_vector_t keys;
+    if (CDS_IS_ERROR(cds_flatmap_init(
+        &map,
+        sizeof(int32_t),
+        sizeof(int32_t),
+        compare_int32
+    )))
+        return;
+    if (CDS_IS_ERROR(cds_vector_init(&keys, sizeof(int32_t)))
+        || CDS_IS_ERROR(cds_vector_resize_uninit(&keys, BENCHMARK_LENGTH))) {
+        cds_flatmap_destroy(&map, NULL, NULL);
+        return;
+    }
+    int32_t *numbers = (int32_t *) keys.buffer;
+    size_t index = 0;
+    for (; index < BENCHMARK_LENGTH; index++)
+        numbers[index] = rand();
+    double start = now();
+    cds_flatmap_build(&map, numbers, numbers, BENCHMARK_LENGTH);
+    double build_time = now() - start;
+    size_t found = 0;
+    start = now();
+    for (index = 0; index < LOOKUPS; index++)
+        found += cds_flatmap_find(&map, &numbers[index % BENCHMARK_LENGTH])
+            != NULL;
+    double branchless_time = now() - start;
+    start = now();
+    for (index = 0; index < LOOKUPS; index++) {
+        found += cds_lower_bound(
+            map.entries.buffer,
+            map.entries.length,
+            map.entries.type_size,
+            &numbers[index % BENCHMARK_LENGTH],
+            compare_int32
+        ) < map.entries.length;
+    }
+    printf(
+        "Build %lu entries in %.4fs. %lu lookups: flat map %.4fs, "
+        "cds_lower_bound %.4fs (%lu found)\n",
+        (unsigned long) cds_flatmap_length(&map),
+        build_time,
+        (unsigned long) LOOKUPS,
+        branchless_time,
+        now() - start,
+        (unsigned long) found
+    );
+    cds_vector_destroy(&keys, NULL);
+    cds_flatmap_destroy(&map, NULL, NULL);
+}
+
+int main(int argc, char **argv) {
+    printf("Test flatmap.\n");
+    srand(5);
+    if (test_map() || test_set()) {
+        printf("Errored out.\n");
+        return 1;
+    }
+    benchmark();
+    printf("Success.\n");
+    return 0;
+}
@@ -0,0 +1,91 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <CDataStructures.h>
+
+static void print_text(cds_gapbuffer_t *text) {
+    size_t index = 0;
+    size_t length = cds_gapbuffer_length(text);
+    for (; index < length; index++) {
+        if (index == cds_gapbuffer_cursor(text))
+            putchar('|');
+        putchar(*(char *) cds_gapbuffer_get(text, index));
+    }
+    if (length == cds_gapbuffer_cursor(text))
+        putchar('|');
+    putchar('\n');
+}
+
+static int check_text(cds_gapbuffer_t *text, const char *expected) {
+    size_t length = strlen(expected);
+    size_t index = 0;
+    if (cds_gapbuffer_length(text) != length)
+        return 1;
+    for (; index < length; index++) {
+        if (*(char *) cds_gapbuffer_get(text, index) != expected[index])
+            return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    printf("Test gap buffer.\n");
+    cds_gapbuffer_t text;
+    if (CDS_IS_ERROR(cds_gapbuffer_init(&text, sizeof(char)))) {
+        printf("Could not initialise gap buffer.\n");
+        return 1;
+    }
+
+    const char *hello = "Hello world!";
+    cds_gapbuffer_insert_range(&text, (cds_ptr_t) hello, strlen(hello));
+    print_text(&text);
+
+    cds_gapbuffer_move_cursor(&text, 5);
+    cds_gapbuffer_insert(&text, ",");
+    print_text(&text);
+
+    cds_gapbuffer_move_cursor(&text, 12);
+    cds_gapbuffer_erase_before(&text, 5, NULL);
+    cds_gapbuffer_insert_range(&text, "there", 5);
+    print_text(&text);
+
+    cds_gapbuffer_move_cursor(&text, 0);
+    cds_gapbuffer_erase_after(&text, 1, NULL);
+    cds_gapbuffer_insert(&text, "J");
+    print_text(&text);
+    if (check_text(&text, "Jello, there!")) {
+        printf("Text does not match.\n");
+        cds_gapbuffer_destroy(&text, NULL);
+        return 1;
+    }
+
+    // Type a long line in the middle to make the gap buffer grow.
+    cds_gapbuffer_move_cursor(&text, 7);
+    size_t index = 0;
+    for (; index < 1000; index++) {
+        char letter = 'a' + (char) (index % 26);
+        if (CDS_IS_ERROR(cds_gapbuffer_insert(&text, &letter))) {
+            printf("Could not insert letter.\n");
+            cds_gapbuffer_destroy(&text, NULL);
+            return 1;
+        }
+    }
+    cds_gapbuffer_erase_before(&text, 1000, NULL);
+    if (check_text(&text, "Jello, there!")) {
+        printf("Text does not match after growing.\n");
+        cds_gapbuffer_destroy(&text, NULL);
+        return 1;
+    }
+
+    cds_buffer_t buffer = NULL;
+    cds_gapbuffer_release(&text, &buffer);
+    printf(
+        "Exported %zu characters: %.*s\n",
+        cds_buffer_cds_get_length(buffer),
+        (int) cds_buffer_cds_get_length(buffer),
+        (char *) buffer
+    );
+    cds_buffer_free(buffer, NULL);
+    printf("Success.\n");
+    return 0;
+}
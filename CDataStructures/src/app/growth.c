@@ -0,0 +1,148 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <CDataStructures.h>
+
+typedef struct _triple_t {
+    int32_t a;
+    int32_t b;
+    int32_t c;
+} triple_t;
+
+/**
+ * Grow by half, reserve at least 10 elements, round every allocation up to
+ * 64 bytes and shrink below a quarter of the capacity.
+ */
+static const cds_growth_policy_t POLICY = {
+    .growth_percent = 150,
+    .min_capacity = 10,
+    .size_class = 64,
+    .shrink_percent = 25,
+    .shrink_floor = 0
+};
+
+/**
+ * The capacities a vector of 12-byte elements goes through, worked out by
+ * hand: each is 1.5 times the last, rounded up so that the elements fill a
+ * multiple of 64 bytes.
+ */
+static const size_t EXPECTED[] = {10, 16, 26, 42, 64, 96, 144, 218};
+
+#define EXPECTED_COUNT (sizeof(EXPECTED) / sizeof(EXPECTED[0]))
+
+static int test_vector(void) {
+    printf("Testing growth policy on a vector.\n");
+    cds_vector_t vector;
+    if (CDS_IS_ERROR(
+        cds_vector_init_with_policy(&vector, sizeof(triple_t), &POLICY)
+    ))
+        return 1;
+    triple_t triple = {1, 2, 3};
+    size_t seen = 0;
+    size_t capacity = 0;
+    int status = 0;
+    while (seen < EXPECTED_COUNT && !status) {
+        if (vector.capacity != capacity) {
+            capacity = vector.capacity;
+            printf("Length %lu: capacity %lu\n",
+                (unsigned long) vector.length,
+                (unsigned long) capacity
+            );
+            status = capacity != EXPECTED[seen++];
+        }
+        status = status || CDS_IS_ERROR(cds_vector_push_back(&vector, &triple));
+    }
+    // Popping keeps the capacity until the length drops below a quarter of
+    // it, then leaves room for one growth step.
+    capacity = vector.capacity;
+    while (!status && vector.length > 0) {
+        size_t length = vector.length - 1;
+        status = CDS_IS_ERROR(cds_vector_pop_back(&vector, NULL));
+        if (length >= capacity / 4) {
+            status = status || vector.capacity != capacity;
+        } else {
+            size_t shrunk = cds_growth_policy_grow(
+                &POLICY,
+                length,
+                length,
+                sizeof(triple_t),
+                0
+            );
+            status = status || vector.capacity != shrunk;
+            printf("Shrunk to %lu at length %lu\n",
+                (unsigned long) vector.capacity,
+                (unsigned long) length
+            );
+            break;
+        }
+    }
+    cds_vector_destroy(&vector, NULL);
+    return status;
+}
+
+static int test_buffer(void) {
+    printf("Testing growth policy on a dynbuffer.\n");
+    cds_buffer_t buffer = cds_buffer_new();
+    if (CDS_IS_ERROR(
+        cds_buffer_init_with_policy(&buffer, sizeof(triple_t), &POLICY)
+    )) {
+        cds_buffer_free(buffer, NULL);
+        return 1;
+    }
+    size_t header = sizeof(cds_buffer_header_t);
+    triple_t triple = {4, 5, 6};
+    size_t reserved = 0;
+    size_t grown = 0;
+    int status = 0;
+    while (grown < EXPECTED_COUNT && !status) {
+        status = CDS_IS_ERROR(cds_buffer_push_back(&buffer, &triple));
+        size_t new_reserved = cds_buffer_cds_get_reserved(buffer);
+        if (new_reserved == reserved)
+            continue;
+        // The block, header included, is rounded up to its size class, so
+        // the bytes left over up to the next multiple of 64 cannot fit
+        // another element.
+        size_t bytes = header + new_reserved * sizeof(triple_t);
+        size_t left = (POLICY.size_class - bytes % POLICY.size_class)
+            % POLICY.size_class;
+        status = status
+            || cds_buffer_cds_get_bytes_allocated(buffer) != bytes
+            || left >= sizeof(triple_t)
+            || new_reserved < POLICY.min_capacity
+            || new_reserved < reserved + reserved / 2;
+        reserved = new_reserved;
+        grown++;
+    }
+    printf("Reserved %lu after %lu growth steps\n",
+        (unsigned long) reserved,
+        (unsigned long) grown
+    );
+    while (!status && cds_buffer_cds_get_length(buffer) > 0) {
+        size_t length = cds_buffer_cds_get_length(buffer) - 1;
+        status = CDS_IS_ERROR(cds_buffer_pop_back(&buffer, NULL));
+        if (length >= reserved / 4) {
+            status = status || cds_buffer_cds_get_reserved(buffer) != reserved;
+        } else {
+            status = status || cds_buffer_cds_get_reserved(buffer)
+                != cds_growth_policy_grow(
+                    &POLICY,
+                    length,
+                    length,
+                    sizeof(triple_t),
+                    header
+                );
+            break;
+        }
+    }
+    cds_buffer_free(buffer, NULL);
+    return status;
+}
+
+int main(int argc, char **argv) {
+    printf("Test growth.\n");
+    if (test_vector() || test_buffer()) {
+        printf("Errored out.\n");
+        return 1;
+    }
+    printf("Success.\n");
+    return 0;
+}
@@ -0,0 +1,180 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <CDataStructures.h>
+
+#define MAX_LENGTH 300
+#define LONG_LENGTH 20000
+#define TRIALS 200
+#define BENCHMARK_LENGTH 16000000
+
+typedef struct _results_t {
+    uint64_t sum;
+    uint64_t min;
+    uint64_t max;
+    size_t find;
+    size_t count;
+    uint64_t add;
+    uint64_t scale;
+} results_t;
+
+static double now(void) {
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (double) time.tv_sec + (double) time.tv_nsec / 1e9;
+}
+
+/**
+ * Run every kernel for one type over the same small numbers. `add` and
+ * `scale` are summed afterwards so that the whole array is compared. Arrays
+ * start at odd offsets so that the vector loads are unaligned.
+ */
+#define RUN_KERNELS(stn, ltn) \
+    static results_t run_##stn( \
+        const ltn *array, \
+        ltn *scratch, \
+        size_t length, \
+        ltn value \
+    ) { \
+        results_t results; \
+        ltn extreme = 0; \
+        memset(&results, 0, sizeof(results)); \
+        results.sum = (uint64_t) CDS_SMASH_PUBLIC(stn, sum)(array, length); \
+        if (!CDS_IS_ERROR(CDS_SMASH_PUBLIC(stn, min)(array, length, &extreme))) \
+            results.min = (uint64_t) extreme; \
+        if (!CDS_IS_ERROR(CDS_SMASH_PUBLIC(stn, max)(array, length, &extreme))) \
+            results.max = (uint64_t) extreme; \
+        results.find = CDS_SMASH_PUBLIC(stn, find)(array, length, value); \
+        results.count = CDS_SMASH_PUBLIC(stn, count)(array, length, value); \
+        memcpy(scratch, array, length * sizeof(ltn)); \
+        CDS_SMASH_PUBLIC(stn, add)(scratch, array, length); \
+        results.add = (uint64_t) CDS_SMASH_PUBLIC(stn, sum)(scratch, length); \
+        CDS_SMASH_PUBLIC(stn, scale)(scratch, length, value); \
+        results.scale = (uint64_t) CDS_SMASH_PUBLIC(stn, sum)(scratch, length); \
+        return results; \
+    } \
+    \
+    static int compare_##stn( \
+        cds_kernel_isa_t isa, \
+        const ltn *array, \
+        ltn *scratch, \
+        size_t length, \
+        ltn value \
+    ) { \
+        cds_kernel_set_isa(cds_kernel_scalar); \
+        results_t expected = run_##stn(array, scratch, length, value); \
+        cds_kernel_set_isa(isa); \
+        results_t actual = run_##stn(array, scratch, length, value); \
+        if (memcmp(&expected, &actual, sizeof(results_t)) != 0) { \
+            printf( \
+                "%s %s kernels differ from scalar at length %lu.\n", \
+                cds_kernel_isa_name(isa), \
+                #stn, \
+                (unsigned long) length \
+            ); \
+            return 1; \
+        } \
+        return 0; \
+    } \
+    \
+    static int check_##stn(cds_kernel_isa_t isa) { \
+        ltn array[MAX_LENGTH + 3]; \
+        ltn scratch[MAX_LENGTH + 3]; \
+        static ltn long_array[LONG_LENGTH + 1]; \
+        static ltn long_scratch[LONG_LENGTH + 1]; \
+        int trial = 0; \
+        size_t index = 0; \
+        for (; trial < TRIALS; trial++) { \
+            size_t length = (size_t) rand() % MAX_LENGTH; \
+            size_t offset = (size_t) rand() % 3; \
+            ltn value = (ltn) (rand() % 9 - 4); \
+            for (index = 0; index < length; index++) \
+                array[offset + index] = (ltn) (rand() % 7 - 3); \
+            if (compare_##stn( \
+                isa, \
+                array + offset, \
+                scratch + offset, \
+                length, \
+                value \
+            )) \
+                return 1; \
+        } \
+        /* Long enough to go through several blocks of count, with half of \
+         * the elements matching so that 8-bit counters would wrap. 8-bit \
+         * types also take values from their whole range, so that sum, add \
+         * and scale wrap around. */ \
+        ltn value = (ltn) (sizeof(ltn) == 1 ? 100 + rand() % 100 : 3); \
+        for (index = 0; index < LONG_LENGTH; index++) { \
+            if (index % 2 == 0) \
+                long_array[1 + index] = value; \
+            else if (sizeof(ltn) == 1) \
+                long_array[1 + index] = (ltn) rand(); \
+            else \
+                long_array[1 + index] = (ltn) (rand() % 7 - 3); \
+        } \
+        return compare_##stn( \
+            isa, \
+            long_array + 1, \
+            long_scratch + 1, \
+            LONG_LENGTH, \
+            value \
+        ); \
+    }
+
+CDS_INTEGER_TYPES(RUN_KERNELS)
+
+#define CHECK_KERNELS(stn, ltn) || check_##stn(isa)
+
+static void benchmark(cds_kernel_isa_t isa, int32_t *numbers) {
+    cds_kernel_set_isa(isa);
+    double start = now();
+    int32_t sum = cds_int32_sum(numbers, BENCHMARK_LENGTH);
+    double sum_time = now() - start;
+    start = now();
+    size_t found = cds_int32_find(numbers, BENCHMARK_LENGTH, -1);
+    printf(
+        "%-7s sum %d in %.4fs, find %lu in %.4fs\n",
+        cds_kernel_isa_name(isa),
+        sum,
+        sum_time,
+        (unsigned long) found,
+        now() - start
+    );
+}
+
+int main(int argc, char **argv) {
+    printf("Test kernels.\n");
+    cds_kernel_isa_t selected = cds_kernel_get_isa();
+    printf("Selected %s kernels.\n", cds_kernel_isa_name(selected));
+    cds_vector_t vector;
+    if (CDS_IS_ERROR(cds_vector_init(&vector, sizeof(int32_t)))
+        || CDS_IS_ERROR(cds_vector_resize_uninit(&vector, BENCHMARK_LENGTH))) {
+        printf("Could not initialise vector.\n");
+        return 1;
+    }
+    int32_t *numbers = (int32_t *) vector.buffer;
+    size_t index = 0;
+    for (; index < BENCHMARK_LENGTH; index++)
+        numbers[index] = (int32_t) (index % 5);
+    numbers[BENCHMARK_LENGTH - 1] = -1;
+    srand(7);
+    int status = 0;
+    cds_kernel_isa_t isa = cds_kernel_scalar;
+    for (; isa <= cds_kernel_avx512; isa = (cds_kernel_isa_t) (isa + 1)) {
+        if (!cds_kernel_isa_supported(isa)) {
+            printf("%s is not supported.\n", cds_kernel_isa_name(isa));
+            continue;
+        }
+        status = status CDS_INTEGER_TYPES(CHECK_KERNELS);
+        benchmark(isa, numbers);
+    }
+    cds_kernel_set_isa(selected);
+    cds_vector_destroy(&vector, NULL);
+    if (status) {
+        printf("Errored out.\n");
+        return 1;
+    }
+    printf("Success.\n");
+    return 0;
+}
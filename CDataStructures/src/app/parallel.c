@@ -0,0 +1,161 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <CDataStructures.h>
+
+#define LENGTH 8000000
+
+static double now(void) {
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (double) time.tv_sec + (double) time.tv_nsec / 1e9;
+}
+
+static void add_double(cds_ptr_t accumulator, cds_ptr_t element) {
+    *(double *) accumulator += *(double *) element;
+}
+
+static void add_int64(cds_ptr_t accumulator, cds_ptr_t element) {
+    *(int64_t *) accumulator += *(int64_t *) element;
+}
+
+static void scale_double(cds_ptr_t element, cds_ptr_t context) {
+    *(double *) element *= *(double *) context;
+}
+
+static cds_ordering_t compare_int32(cds_ptr_t a, cds_ptr_t b) {
+    return cds_int32_compare_pointers(a, b);
+}
+
+static int fill(cds_vector_t *vector, size_t type_size) {
+    if (CDS_IS_ERROR(cds_vector_init(vector, type_size))
+        || CDS_IS_ERROR(cds_vector_resize_uninit(vector, LENGTH)))
+        return 1;
+    return 0;
+}
+
+/**
+ * Sum the same doubles on pools of different sizes. Floating point addition
+ * is not associative, so this only gives the same answer every time because
+ * the chunks do not depend on the number of threads.
+ */
+static int test_reduce(cds_thread_pool_t *pools, size_t pool_count) {
+    cds_vector_t vector;
+    if (fill(&vector, sizeof(double)))
+        return 1;
+    double *numbers = (double *) vector.buffer;
+    size_t index = 0;
+    for (; index < LENGTH; index++)
+        numbers[index] = 1.0 / (double) (index + 1);
+    cds_span_t span;
+    cds_span_from_vector(&vector, 0, vector.length, &span);
+    double two = 2.0;
+    double zero = 0.0;
+    double expected = 0.0;
+    int status = 0;
+    if (CDS_IS_ERROR(cds_par_for_each(NULL, span, scale_double, &two))
+        || numbers[1] != 1.0)
+        status = 1;
+    for (index = 0; index < pool_count && !status; index++) {
+        double sum = 0.0;
+        double start = now();
+        if (CDS_IS_ERROR(
+            cds_par_reduce(&pools[index], span, &zero, add_double, &sum)
+        )) {
+            status = 1;
+            break;
+        }
+        printf(
+            "Sum on %lu threads: %.17g in %.4fs\n",
+            (unsigned long) pools[index].thread_count,
+            sum,
+            now() - start
+        );
+        if (index == 0)
+            expected = sum;
+        else if (memcmp(&sum, &expected, sizeof(double)) != 0)
+            status = 1;
+    }
+    cds_vector_destroy(&vector, NULL);
+    return status;
+}
+
+static int test_scan(cds_thread_pool_t *pool) {
+    cds_vector_t vector;
+    if (fill(&vector, sizeof(int64_t)))
+        return 1;
+    int64_t *numbers = (int64_t *) vector.buffer;
+    size_t index = 0;
+    for (; index < LENGTH; index++)
+        numbers[index] = (int64_t) (index % 7) - 3;
+    cds_span_t span;
+    cds_span_from_vector(&vector, 0, vector.length, &span);
+    int64_t zero = 0;
+    double start = now();
+    int status = CDS_IS_ERROR(
+        cds_par_inclusive_scan(pool, span, &zero, add_int64)
+    );
+    printf("Scan: %.4fs\n", now() - start);
+    int64_t running = 0;
+    for (index = 0; index < LENGTH && !status; index++) {
+        running += (int64_t) (index % 7) - 3;
+        if (numbers[index] != running)
+            status = 1;
+    }
+    cds_vector_destroy(&vector, NULL);
+    return status;
+}
+
+static int test_sort(cds_thread_pool_t *pool) {
+    cds_vector_t vector;
+    cds_vector_t copy;
+    if (fill(&vector, sizeof(int32_t)) || fill(&copy, sizeof(int32_t)))
+        return 1;
+    srand(42);
+    size_t index = 0;
+    for (; index < LENGTH; index++)
+        ((int32_t *) vector.buffer)[index] = rand() - RAND_MAX / 2;
+    memcpy(copy.buffer, vector.buffer, LENGTH * sizeof(int32_t));
+    cds_span_t span;
+    cds_span_from_vector(&vector, 0, vector.length, &span);
+    double start = now();
+    int status = CDS_IS_ERROR(cds_par_sort(pool, span, compare_int32));
+    double parallel_time = now() - start;
+    start = now();
+    status = status || CDS_IS_ERROR(cds_vector_sort(&copy, compare_int32));
+    printf(
+        "Sort: parallel %.4fs, cds_vector_sort %.4fs\n",
+        parallel_time,
+        now() - start
+    );
+    status = status
+        || !cds_span_is_sorted(span, compare_int32)
+        || memcmp(vector.buffer, copy.buffer, LENGTH * sizeof(int32_t)) != 0;
+    cds_vector_destroy(&vector, NULL);
+    cds_vector_destroy(&copy, NULL);
+    return status;
+}
+
+int main(int argc, char **argv) {
+    printf("Test parallel.\n");
+    cds_thread_pool_t pools[3];
+    if (CDS_IS_ERROR(cds_thread_pool_init(&pools[0], 1))
+        || CDS_IS_ERROR(cds_thread_pool_init(&pools[1], 3))
+        || CDS_IS_ERROR(cds_thread_pool_init(&pools[2], 0))) {
+        printf("Could not start thread pools.\n");
+        return 1;
+    }
+    int status = test_reduce(pools, 3)
+        || test_scan(&pools[1])
+        || test_sort(&pools[1]);
+    size_t index = 0;
+    for (; index < 3; index++)
+        cds_thread_pool_destroy(&pools[index]);
+    if (status) {
+        printf("Errored out.\n");
+        return 1;
+    }
+    printf("Success.\n");
+    return 0;
+}
@@ -0,0 +1,202 @@
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <CDataStructures.h>
+
+typedef struct _record_t {
+    int32_t key;
+    char payload[96];
+} record_t;
+
+static cds_ordering_t compare_int32(cds_ptr_t a, cds_ptr_t b) {
+    return cds_int32_compare_pointers(a, b);
+}
+
+static cds_ordering_t compare_record(cds_ptr_t a, cds_ptr_t b) {
+    return cds_int32_compare_pointers(
+        &((record_t *) a)->key,
+        &((record_t *) b)->key
+    );
+}
+
+static void fill(int32_t *array, size_t length, int pattern) {
+    size_t index = 0;
+    for (; index < length; index++) {
+        switch (pattern) {
+            case 0: array[index] = rand(); break;
+            case 1: array[index] = (int32_t) index; break;
+            case 2: array[index] = (int32_t) (length - index); break;
+            case 3: array[index] = 7; break;
+            case 4: array[index] = rand() % 4; break;
+            case 5: array[index] = (int32_t) (index % 17); break;
+            case 6:
+                array[index] = (int32_t) (
+                    index < length / 2 ? index : length - index
+                );
+                break;
+            default:
+                array[index] = (int32_t) index;
+                if (rand() % 64 == 0)
+                    array[index] = rand();
+                break;
+        }
+    }
+}
+
+static int test_patterns(void) {
+    size_t lengths[] = {0, 1, 2, 3, 10, 23, 24, 25, 100, 129, 1000, 100000};
+    size_t l = 0;
+    for (; l < sizeof(lengths) / sizeof(lengths[0]); l++) {
+        size_t length = lengths[l];
+        int32_t *array = malloc((length + 1) * sizeof(int32_t));
+        int pattern = 0;
+        for (; pattern < 8; pattern++) {
+            fill(array, length, pattern);
+            if (CDS_IS_ERROR(cds_sort(
+                array,
+                length,
+                sizeof(int32_t),
+                compare_int32
+            )) || !cds_is_sorted(
+                array,
+                length,
+                sizeof(int32_t),
+                compare_int32
+            )) {
+                printf("Pattern %d of length %zu not sorted.\n", pattern, length);
+                free(array);
+                return 1;
+            }
+        }
+        free(array);
+    }
+    printf("All patterns sorted.\n");
+    return 0;
+}
+
+static int test_records(void) {
+    size_t length = 5000;
+    record_t *records = malloc(length * sizeof(record_t));
+    size_t index = 0;
+    for (; index < length; index++) {
+        records[index].key = rand() % 1000;
+        sprintf(records[index].payload, "%d", records[index].key);
+    }
+    cds_sort(records, length, sizeof(record_t), compare_record);
+    for (index = 0; index < length; index++) {
+        if ((index > 0 && records[index - 1].key > records[index].key)
+            || atoi(records[index].payload) != records[index].key) {
+            printf("Records not sorted at %zu.\n", index);
+            free(records);
+            return 1;
+        }
+    }
+    free(records);
+    printf("Records sorted.\n");
+    return 0;
+}
+
+static int test_containers(void) {
+    cds_buffer_t buffer = cds_buffer_new();
+    cds_vector_t vector;
+    if (CDS_IS_ERROR(cds_buffer_init(&buffer, sizeof(int32_t)))
+        || CDS_IS_ERROR(cds_vector_init(&vector, sizeof(int32_t)))) {
+        printf("Could not initialise containers.\n");
+        return 1;
+    }
+    cds_buffer_set_ring(&buffer, true);
+    int32_t number = 0;
+    for (; number < 200; number++) {
+        int32_t value = (number * 37) % 50;
+        cds_buffer_push_front(&buffer, &value);
+        cds_vector_push_back(&vector, &value);
+    }
+    cds_buffer_sort(&buffer, compare_int32);
+    cds_vector_sort(&vector, compare_int32);
+    int32_t key = 25;
+    size_t lower = cds_buffer_lower_bound(buffer, &key, compare_int32);
+    size_t upper = cds_buffer_upper_bound(buffer, &key, compare_int32);
+    printf("Buffer: 25 is in [%zu, %zu)\n", lower, upper);
+    if (lower != cds_vector_lower_bound(&vector, &key, compare_int32)
+        || upper != cds_vector_upper_bound(&vector, &key, compare_int32)
+        || lower != 100 || upper != 104) {
+        printf("Bounds are wrong.\n");
+        cds_buffer_free(buffer, NULL);
+        cds_vector_destroy(&vector, NULL);
+        return 1;
+    }
+    cds_buffer_free(buffer, NULL);
+    cds_vector_destroy(&vector, NULL);
+    return 0;
+}
+
+typedef struct _event_t {
+    uint32_t id;
+    int64_t timestamp;
+} event_t;
+
+static int test_radix(void) {
+    size_t length = 100000;
+    int64_t *numbers = malloc(length * sizeof(int64_t));
+    event_t *events = malloc(length * sizeof(event_t));
+    size_t index = 0;
+    for (; index < length; index++) {
+        numbers[index] = ((int64_t) rand() - RAND_MAX / 2) * rand();
+        events[index].id = (uint32_t) index;
+        events[index].timestamp = rand() % 1000 - 500;
+    }
+    cds_int64_radix_sort(numbers, length, sizeof(int64_t), 0);
+    cds_int64_radix_sort(
+        events,
+        length,
+        sizeof(event_t),
+        offsetof(event_t, timestamp)
+    );
+    for (index = 1; index < length; index++) {
+        // The radix sort is stable, so equal timestamps keep the order of
+        // their IDs.
+        if (numbers[index - 1] > numbers[index]
+            || events[index - 1].timestamp > events[index].timestamp
+            || (events[index - 1].timestamp == events[index].timestamp
+                && events[index - 1].id > events[index].id)) {
+            printf("Radix sort failed at %zu.\n", index);
+            free(numbers);
+            free(events);
+            return 1;
+        }
+    }
+    free(numbers);
+    free(events);
+
+    cds_vector_t vector;
+    if (CDS_IS_ERROR(cds_vector_init(&vector, sizeof(int8_t))))
+        return 1;
+    int8_t value = -100;
+    for (; value < 100; value += 7) {
+        int8_t flipped = -value;
+        cds_vector_push_back(&vector, &flipped);
+    }
+    cds_vector_radix_sort_int8(&vector, 0);
+    for (index = 0; index < vector.length; index++)
+        printf("%d ", *(int8_t *) cds_vector_get(&vector, index));
+    printf("\n");
+    cds_vector_destroy(&vector, NULL);
+    printf("Radix sorted.\n");
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    printf("Test sort.\n");
+    srand((uint32_t) time(NULL));
+    if (test_patterns()
+        || test_records()
+        || test_containers()
+        || test_radix()) {
+        printf("Errored out.\n");
+        return 1;
+    }
+    printf("Success.\n");
+    return 0;
+}
@@ -0,0 +1,80 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <CDataStructures.h>
+
+static cds_ordering_t compare_int32(cds_ptr_t a, cds_ptr_t b) {
+    return cds_int32_compare_pointers(a, b);
+}
+
+static bool is_separator(cds_ptr_t element, cds_ptr_t context) {
+    return *(int32_t *) element == *(int32_t *) context;
+}
+
+static void print_span(cds_span_t span) {
+    int32_t *element;
+    CDS_SPAN_FOR_EACH(span, element) {
+        printf("%d ", *element);
+    }
+    printf("\n");
+}
+
+/**
+ * Sort each batch of numbers between separators in place, without copying
+ * any batch out of the vector.
+ */
+static int sort_batches(cds_vector_t *vector) {
+    int32_t separator = 0;
+    cds_span_t rest;
+    if (CDS_IS_ERROR(cds_span_from_vector(vector, 0, vector->length, &rest)))
+        return 1;
+    while (rest.length > 0) {
+        size_t end = cds_span_find_if(rest, is_separator, &separator);
+        cds_span_t batch = cds_span_sub(rest, 0, end);
+        cds_span_sort(batch, compare_int32);
+        if (!cds_span_is_sorted(batch, compare_int32))
+            return 1;
+        print_span(batch);
+        rest = cds_span_skip(rest, end < rest.length ? end + 1 : end);
+    }
+    return 0;
+}
+
+static int search_buffer(void) {
+    cds_buffer_t buffer = cds_buffer_new();
+    if (CDS_IS_ERROR(cds_buffer_init(&buffer, sizeof(int32_t))))
+        return 1;
+    int32_t number = 0;
+    for (; number < 100; number++)
+        cds_buffer_push_back(&buffer, &number);
+    cds_span_t middle;
+    int32_t key = 60;
+    int status = CDS_IS_ERROR(cds_span_from_buffer(buffer, 50, 20, &middle))
+        || cds_span_lower_bound(middle, &key, compare_int32) != 10
+        || cds_span_upper_bound(middle, &key, compare_int32) != 11
+        || *(int32_t *) cds_span_get(middle, 0) != 50
+        || cds_span_from_buffer(buffer, 90, 20, &middle) != cds_index_error;
+    cds_buffer_free(buffer, NULL);
+    printf("Buffer span search %s.\n", status ? "failed" : "succeeded");
+    return status;
+}
+
+int main(int argc, char **argv) {
+    printf("Test span.\n");
+    int32_t numbers[] = {5, 3, 9, 0, 7, 1, 0, 0, 4, 8, 2, 6};
+    cds_vector_t vector;
+    if (CDS_IS_ERROR(cds_vector_init(&vector, sizeof(int32_t)))) {
+        printf("Could not initialise vector.\n");
+        return 1;
+    }
+    size_t index = 0;
+    for (; index < sizeof(numbers) / sizeof(numbers[0]); index++)
+        cds_vector_push_back(&vector, &numbers[index]);
+    int status = sort_batches(&vector) || search_buffer();
+    cds_vector_destroy(&vector, NULL);
+    if (status) {
+        printf("Errored out.\n");
+        return 1;
+    }
+    printf("Success.\n");
+    return 0;
+}
@@ -89,4 +89,5 @@ int main(int argc, char **argv) {
     } else {
         printf("Unknown status code: %" PRId64 "\n", loc);
     }
+    return loc == -1 ? 0 : 1;
 }
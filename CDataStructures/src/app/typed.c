@@ -0,0 +1,104 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <CDataStructures.h>
+
+typedef struct _point_t {
+    double x;
+    double y;
+} point_t;
+
+CDS_DEFINE_VECTOR(point_vector, point_t)
+CDS_DEFINE_BUFFER(point_buffer, point_t)
+
+#define LENGTH 10000000
+
+static double seconds_since(clock_t start) {
+    return (double) (clock() - start) / CLOCKS_PER_SEC;
+}
+
+static int test_points(void) {
+    cds_vector_t vector;
+    cds_buffer_t buffer = cds_buffer_new();
+    if (CDS_IS_ERROR(point_vector_init(&vector))
+        || CDS_IS_ERROR(point_buffer_init(&buffer))) {
+        printf("Could not initialise containers.\n");
+        return 1;
+    }
+    cds_buffer_set_ring(&buffer, true);
+    size_t index = 0;
+    for (; index < 1000; index++) {
+        point_t point = {(double) index, -(double) index};
+        point_vector_push_back(&vector, point);
+        // Mix typed and generic functions on the same container.
+        if (index % 2 == 0)
+            point_buffer_push_back(&buffer, point);
+        else
+            cds_buffer_push_front(&buffer, &point);
+    }
+    point_t origin = {0.0, 0.0};
+    point_vector_insert(&vector, 0, origin);
+    point_t last;
+    point_buffer_pop_back(&buffer, &last);
+    if (vector.length != 1001
+        || point_vector_get(&vector, 1000)->x != 999.0
+        || point_vector_get(&vector, 0)->y != 0.0
+        || last.x != 998.0
+        || point_buffer_get(buffer, 0)->x != 999.0
+        || cds_buffer_get(buffer, 0) != point_buffer_get(buffer, 0)) {
+        printf("Typed containers do not match.\n");
+        cds_vector_destroy(&vector, NULL);
+        cds_buffer_free(buffer, NULL);
+        return 1;
+    }
+    cds_vector_destroy(&vector, NULL);
+    cds_buffer_free(buffer, NULL);
+    printf("Typed containers match.\n");
+    return 0;
+}
+
+static int compare_speed(void) {
+    cds_vector_t generic;
+    cds_vector_t typed;
+    if (CDS_IS_ERROR(cds_vector_init(&generic, sizeof(int32_t)))
+        || CDS_IS_ERROR(cds_int32_vector_init(&typed))) {
+        printf("Could not initialise vectors.\n");
+        return 1;
+    }
+    clock_t start = clock();
+    int32_t number = 0;
+    for (; number < LENGTH; number++)
+        cds_vector_push_back(&generic, &number);
+    double generic_time = seconds_since(start);
+    start = clock();
+    for (number = 0; number < LENGTH; number++)
+        cds_int32_vector_push_back(&typed, number);
+    double typed_time = seconds_since(start);
+    printf(
+        "Pushing %d integers: generic %.3fs, typed %.3fs\n",
+        LENGTH,
+        generic_time,
+        typed_time
+    );
+    int64_t sum = 0;
+    int32_t value;
+    while (cds_int32_vector_pop_back(&typed, &value) == cds_ok)
+        sum += value;
+    cds_vector_destroy(&generic, NULL);
+    cds_vector_destroy(&typed, NULL);
+    if (sum != (int64_t) LENGTH * (LENGTH - 1) / 2) {
+        printf("Sum is wrong.\n");
+        return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    printf("Test typed containers.\n");
+    if (test_points() || compare_speed()) {
+        printf("Errored out.\n");
+        return 1;
+    }
+    printf("Success.\n");
+    return 0;
+}
@@ -1,6 +1,10 @@
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <CDataStructures.h>
 
+#define LARGE_LENGTH ((size_t) 2 << 20)
+
 int main(int argc, char **argv) {
     printf("Test vector.\n");
     cds_vector_t *vector = cds_vector_new();
@@ -58,6 +62,213 @@ int main(int argc, char **argv) {
         printf("Number: %x\n", number);
     }
 
+    printf("Reserve space for 1000 more numbers.\n");
+    if (CDS_IS_ERROR(cds_vector_reserve(vector, 1000))) {
+        printf("Could not reserve space.\n");
+        goto errored;
+    }
+    printf("Capacity: %zu\n", cds_vector_capacity(vector));
+
+    printf("Shrink vector to fit.\n");
+    if (CDS_IS_ERROR(cds_vector_shrink_to_fit(vector))) {
+        printf("Could not shrink vector.\n");
+        goto errored;
+    }
+    printf("Capacity: %zu\n", cds_vector_capacity(vector));
+    printf("Memory allocated: %zu\n", vector->_bytes_allocated);
+
+    printf("Save and load vector.\n");
+    FILE *file = tmpfile();
+    cds_vector_t loaded;
+    if (file == NULL
+        || CDS_IS_ERROR(cds_vector_init(&loaded, sizeof(int32_t)))) {
+        printf("Could not open temporary file.\n");
+        goto errored;
+    }
+    if (CDS_IS_ERROR(cds_vector_write(vector, file))) {
+        printf("Could not save vector.\n");
+        fclose(file);
+        cds_vector_destroy(&loaded, NULL);
+        goto errored;
+    }
+    rewind(file);
+    cds_status_t status = cds_vector_read(&loaded, file);
+    fclose(file);
+    if (CDS_IS_ERROR(status)
+        || loaded.length != vector->length
+        || memcmp(loaded.buffer, vector->buffer, loaded.length * 4) != 0) {
+        printf("Could not load vector.\n");
+        cds_vector_destroy(&loaded, NULL);
+        goto errored;
+    }
+    printf("Loaded %zu numbers.\n", loaded.length);
+    // A file which ends inside the header is rejected and leaves the vector
+    // empty.
+    file = tmpfile();
+    status = cds_ok;
+    if (file != NULL && fwrite("CDSB", 1, 4, file) == 4) {
+        rewind(file);
+        status = cds_vector_read(&loaded, file);
+    }
+    if (file != NULL)
+        fclose(file);
+    size_t loaded_length = loaded.length;
+    cds_vector_destroy(&loaded, NULL);
+    if (status != cds_error || loaded_length != 0) {
+        printf("Loaded a truncated vector.\n");
+        goto errored;
+    }
+
+    printf("Test small vector.\n");
+    cds_small_vector_t small;
+    if (CDS_IS_ERROR(cds_small_vector_init(&small, sizeof(int32_t)))) {
+        printf("Could not initialise small vector.\n");
+        goto errored;
+    }
+    for (i = 0; i < 32; ++i) {
+        if (CDS_IS_ERROR(cds_vector_push_back(&small.vector, &i))) {
+            printf("Could not add numbers.\n");
+            cds_vector_destroy(&small.vector, NULL);
+            goto errored;
+        }
+        if (i == 0 || i == 15 || i == 16)
+            printf(
+                "Length: %zu Inline: %d\n",
+                small.vector.length,
+                cds_vector_is_inline(&small.vector)
+            );
+    }
+    while (small.vector.length > 4)
+        cds_vector_pop_back(&small.vector, NULL);
+    cds_vector_shrink_to_fit(&small.vector);
+    printf(
+        "Length: %zu Inline: %d\n",
+        small.vector.length,
+        cds_vector_is_inline(&small.vector)
+    );
+    for (index = 0; index < small.vector.length; index++) {
+        int32_t number = *(int32_t*) cds_vector_get(&small.vector, index);
+        printf("Number: %x\n", number);
+    }
+    cds_vector_destroy(&small.vector, NULL);
+
+    printf("Emplace numbers in place.\n");
+    size_t old_length = vector->length;
+    for (i = 0; i < 4; ++i) {
+        int32_t *slot = cds_vector_emplace_back(vector);
+        if (slot == NULL) {
+            printf("Could not emplace number.\n");
+            goto errored;
+        }
+        *slot = i * 0x100;
+    }
+    if (CDS_IS_ERROR(cds_vector_resize_uninit(vector, vector->length + 4))) {
+        printf("Could not resize vector.\n");
+        goto errored;
+    }
+    for (index = 0; index < 4; index++)
+        ((int32_t *) vector->buffer)[old_length + 4 + index] = -1;
+    for (index = old_length; index < vector->length; index++) {
+        int32_t number = *(int32_t*) cds_vector_get(vector, index);
+        printf("Number: %x\n", number);
+    }
+
+    printf("Move vectors without copying.\n");
+    cds_vector_t source;
+    cds_vector_t target;
+    cds_vector_init_with_allocator(
+        &source, sizeof(int32_t), NULL, &CDS_MALLOC_ALLOCATOR
+    );
+    cds_vector_init_with_allocator(
+        &target, sizeof(int32_t), NULL, &CDS_MALLOC_ALLOCATOR
+    );
+    int32_t *array = (int32_t *) malloc(64 * sizeof(int32_t));
+    if (array == NULL) {
+        printf("Could not allocate array.\n");
+        goto errored;
+    }
+    for (index = 0; index < 48; index++)
+        array[index] = (int32_t) index;
+    if (CDS_IS_ERROR(cds_vector_adopt(&source, array, 48, 64))
+        || CDS_IS_ERROR(cds_vector_append_move(&target, &source))
+        || target.buffer != (cds_ptr_t) array
+        || source.length != 0) {
+        printf("Could not steal adopted array.\n");
+        cds_vector_destroy(&source, NULL);
+        cds_vector_destroy(&target, NULL);
+        goto errored;
+    }
+    i = 48;
+    cds_vector_push_back(&source, &i);
+    cds_vector_swap(&source, &target);
+    size_t released_length = 0;
+    size_t released_capacity = 0;
+    array = (int32_t *) cds_vector_release(
+        &source, &released_length, &released_capacity
+    );
+    cds_vector_destroy(&target, NULL);
+    if (array == NULL
+        || released_length != 48
+        || released_capacity != 64
+        || array[47] != 47) {
+        printf("Could not release array.\n");
+        free(array);
+        goto errored;
+    }
+    printf("Released %zu numbers.\n", released_length);
+    free(array);
+
+    // Arrays this large are mapped by the default allocator, so they can
+    // only be handed over through malloc.
+    printf("Hand over large arrays.\n");
+    cds_vector_t large;
+    cds_vector_init(&large, sizeof(int32_t));
+    array = (int32_t *) malloc(LARGE_LENGTH * sizeof(int32_t));
+    if (array == NULL) {
+        printf("Could not allocate array.\n");
+        cds_vector_destroy(&large, NULL);
+        goto errored;
+    }
+    for (index = 0; index < LARGE_LENGTH; index++)
+        array[index] = (int32_t) index;
+    if (CDS_IS_ERROR(
+            cds_vector_adopt(&large, array, LARGE_LENGTH, LARGE_LENGTH)
+        )
+        || CDS_IS_ERROR(cds_vector_push_back(&large, &i))
+        || large.allocator != &CDS_MALLOC_ALLOCATOR
+        || ((int32_t *) large.buffer)[LARGE_LENGTH - 1]
+            != (int32_t) (LARGE_LENGTH - 1)) {
+        printf("Could not adopt large array.\n");
+        cds_vector_destroy(&large, NULL);
+        goto errored;
+    }
+    cds_vector_destroy(&large, NULL);
+    cds_vector_init(&large, sizeof(int32_t));
+    if (CDS_IS_ERROR(cds_vector_resize_uninit(&large, LARGE_LENGTH))) {
+        printf("Could not resize vector.\n");
+        cds_vector_destroy(&large, NULL);
+        goto errored;
+    }
+    ((int32_t *) large.buffer)[LARGE_LENGTH - 1] = -1;
+    array = (int32_t *) cds_vector_release(
+        &large, &released_length, &released_capacity
+    );
+    if (array == NULL
+        || released_length != LARGE_LENGTH
+        || array[LARGE_LENGTH - 1] != -1) {
+        printf("Could not release large array.\n");
+        free(array);
+        goto errored;
+    }
+    // The array must now be safe to grow and free with the C library.
+    array = (int32_t *) realloc(array, 2 * LARGE_LENGTH * sizeof(int32_t));
+    if (array == NULL || array[LARGE_LENGTH - 1] != -1) {
+        printf("Could not grow released array.\n");
+        free(array);
+        goto errored;
+    }
+    free(array);
+
     printf("Success.\n");
     cds_vector_free(vector, NULL);
     return 0;
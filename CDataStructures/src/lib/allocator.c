@@ -0,0 +1,264 @@
+// mremap is a GNU extension.
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <string.h>
+#include <CDataStructures/allocator.h>
+#ifdef CDS_HAVE_MREMAP
+#   include <sys/mman.h>
+#   include <unistd.h>
+#endif
+
+const cds_large_block_config_t CDS_DEFAULT_LARGE_BLOCK_CONFIG = {
+    .mmap_threshold = CDS_DEFAULT_MMAP_THRESHOLD,
+    .hugepage_threshold = CDS_DEFAULT_HUGEPAGE_THRESHOLD
+};
+
+#define _CONFIG(context) ((context) == NULL \
+    ? &CDS_DEFAULT_LARGE_BLOCK_CONFIG \
+    : (const cds_large_block_config_t *) (context))
+
+#ifdef CDS_HAVE_MREMAP
+/**
+ * @brief The header in front of every block from the default allocator,
+ * which records whether the block is a mapping. Its size keeps the block
+ * after it aligned like memory from `malloc`.
+ */
+typedef union _cds_block_header_t {
+    /**
+     * @brief The length of the mapping the block lives in, or 0 if it came
+     * from `malloc`.
+     */
+    size_t mapped_bytes;
+    long double _align;
+    cds_ptr_t _pointer;
+} _cds_block_header_t;
+
+#define _BLOCK_HEADER(pointer) \
+    ((_cds_block_header_t *) (pointer) - 1)
+
+CDS_INLINE
+bool _cds_is_large_block(const cds_large_block_config_t *config, size_t size) {
+    return config->mmap_threshold != 0 && size >= config->mmap_threshold;
+}
+
+CDS_INLINE
+size_t _cds_page_round(size_t size) {
+    size_t page = (size_t) sysconf(_SC_PAGESIZE);
+    return (size + page - 1) & ~(page - 1);
+}
+
+CDS_PRIVATE
+void _cds_advise_large_block(
+    const cds_large_block_config_t *config,
+    cds_ptr_t pointer,
+    size_t size
+) {
+#   ifdef MADV_HUGEPAGE
+    if (config->hugepage_threshold != 0 && size >= config->hugepage_threshold)
+        madvise(pointer, size, MADV_HUGEPAGE);
+#   else
+    (void) config;
+    (void) pointer;
+    (void) size;
+#   endif
+}
+
+CDS_PRIVATE
+cds_ptr_t _cds_map_large_block(
+    const cds_large_block_config_t *config,
+    size_t size
+) {
+    size_t mapped_bytes = _cds_page_round(size);
+    _cds_block_header_t *header = mmap(
+        NULL,
+        mapped_bytes,
+        PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS,
+        -1,
+        0
+    );
+    if (header == MAP_FAILED)
+        return NULL;
+    header->mapped_bytes = mapped_bytes;
+    _cds_advise_large_block(config, header, mapped_bytes);
+    return header + 1;
+}
+#endif
+
+CDS_PRIVATE
+cds_ptr_t _cds_default_alloc(cds_ptr_t context, size_t size) {
+#ifdef CDS_HAVE_MREMAP
+    const cds_large_block_config_t *config = _CONFIG(context);
+    if (size > SIZE_MAX - sizeof(_cds_block_header_t))
+        return NULL;
+    size += sizeof(_cds_block_header_t);
+    if (_cds_is_large_block(config, size))
+        return _cds_map_large_block(config, size);
+    _cds_block_header_t *header = malloc(size);
+    if (header == NULL)
+        return NULL;
+    header->mapped_bytes = 0;
+    return header + 1;
+#else
+    (void) context;
+    return malloc(size);
+#endif
+}
+
+CDS_PRIVATE
+void _cds_default_free(cds_ptr_t context, cds_ptr_t pointer, size_t size) {
+    (void) context;
+    (void) size;
+#ifdef CDS_HAVE_MREMAP
+    if (pointer == NULL)
+        return;
+    // The header says how the block was allocated, so a wrong size cannot
+    // send a block to the wrong function.
+    _cds_block_header_t *header = _BLOCK_HEADER(pointer);
+    if (header->mapped_bytes != 0) {
+        munmap(header, header->mapped_bytes);
+        return;
+    }
+    free(header);
+#else
+    free(pointer);
+#endif
+}
+
+CDS_PRIVATE
+cds_ptr_t _cds_default_realloc(
+    cds_ptr_t context,
+    cds_ptr_t pointer,
+    size_t old_size,
+    size_t new_size
+) {
+#ifdef CDS_HAVE_MREMAP
+    const cds_large_block_config_t *config = _CONFIG(context);
+    _cds_block_header_t *header = _BLOCK_HEADER(pointer);
+    if (new_size > SIZE_MAX - sizeof(_cds_block_header_t))
+        return NULL;
+    size_t total = new_size + sizeof(_cds_block_header_t);
+    bool new_large = _cds_is_large_block(config, total);
+    if (header->mapped_bytes != 0 && new_large) {
+        size_t old_pages = header->mapped_bytes;
+        size_t new_pages = _cds_page_round(total);
+        if (old_pages == new_pages)
+            return pointer;
+        // The kernel moves the pages instead of copying their contents.
+        _cds_block_header_t *moved = mremap(
+            header,
+            old_pages,
+            new_pages,
+            MREMAP_MAYMOVE
+        );
+        if (moved == MAP_FAILED)
+            return NULL;
+        moved->mapped_bytes = new_pages;
+        if (new_pages > old_pages)
+            _cds_advise_large_block(config, moved, new_pages);
+        return moved + 1;
+    } else if (header->mapped_bytes != 0 || new_large) {
+        // The block moves between malloc and a mapping.
+        cds_ptr_t moved = _cds_default_alloc(context, new_size);
+        if (moved == NULL)
+            return NULL;
+        memcpy(moved, pointer, old_size < new_size ? old_size : new_size);
+        _cds_default_free(context, pointer, old_size);
+        return moved;
+    }
+    header = realloc(header, total);
+    return header == NULL ? NULL : header + 1;
+#else
+    (void) context;
+    (void) old_size;
+    return realloc(pointer, new_size);
+#endif
+}
+
+const cds_allocator_t CDS_DEFAULT_ALLOCATOR = {
+    .alloc = _cds_default_alloc,
+    .realloc = _cds_default_realloc,
+    .free = _cds_default_free,
+    .context = NULL
+};
+
+CDS_PRIVATE
+cds_ptr_t _cds_malloc_alloc(cds_ptr_t context, size_t size) {
+    (void) context;
+    return malloc(size);
+}
+
+CDS_PRIVATE
+cds_ptr_t _cds_malloc_realloc(
+    cds_ptr_t context,
+    cds_ptr_t pointer,
+    size_t old_size,
+    size_t new_size
+) {
+    (void) context;
+    (void) old_size;
+    return realloc(pointer, new_size);
+}
+
+CDS_PRIVATE
+void _cds_malloc_free(cds_ptr_t context, cds_ptr_t pointer, size_t size) {
+    (void) context;
+    (void) size;
+    free(pointer);
+}
+
+const cds_allocator_t CDS_MALLOC_ALLOCATOR = {
+    .alloc = _cds_malloc_alloc,
+    .realloc = _cds_malloc_realloc,
+    .free = _cds_malloc_free,
+    .context = NULL
+};
+
+CDS_PUBLIC
+cds_allocator_t cds_large_block_allocator(
+    const cds_large_block_config_t *config
+) {
+    cds_allocator_t allocator = CDS_DEFAULT_ALLOCATOR;
+    allocator.context = (cds_ptr_t) config;
+    return allocator;
+}
+
+#define _ALLOCATOR(self) ((self) == NULL ? &CDS_DEFAULT_ALLOCATOR : (self))
+
+CDS_PUBLIC
+cds_ptr_t cds_allocator_alloc(const cds_allocator_t *self, size_t size) {
+    self = _ALLOCATOR(self);
+    return self->alloc(self->context, size);
+}
+
+CDS_PUBLIC
+cds_ptr_t cds_allocator_realloc(
+    const cds_allocator_t *self,
+    cds_ptr_t pointer,
+    size_t old_size,
+    size_t new_size
+) {
+    self = _ALLOCATOR(self);
+    if (pointer == NULL)
+        return self->alloc(self->context, new_size);
+    if (self->realloc != NULL)
+        return self->realloc(self->context, pointer, old_size, new_size);
+    cds_ptr_t new = self->alloc(self->context, new_size);
+    if (new == NULL)
+        return NULL;
+    memcpy(new, pointer, old_size < new_size ? old_size : new_size);
+    self->free(self->context, pointer, old_size);
+    return new;
+}
+
+CDS_PUBLIC
+void cds_allocator_free(
+    const cds_allocator_t *self,
+    cds_ptr_t pointer,
+    size_t size
+) {
+    if (pointer == NULL)
+        return;
+    self = _ALLOCATOR(self);
+    self->free(self->context, pointer, size);
+}
@@ -0,0 +1,176 @@
+#include <string.h>
+#include <CDataStructures/appender.h>
+
+#define _HEAD(self) cds_buffer_get_data((self)->buffer)->header
+
+/**
+ * @brief Grow the buffer so that it has at least `required` slots. Slots
+ * claimed by other threads in the meantime are included so that they do not
+ * all have to grow the buffer one after another.
+ */
+CDS_PRIVATE
+cds_status_t _cds_appender_grow(cds_appender_t *self, size_t required) {
+    CDS_NEW_STATUS = cds_ok;
+    if (pthread_rwlock_wrlock(&self->lock) != 0)
+        return cds_error;
+    if (self->capacity < required) {
+        size_t claimed = __atomic_load_n(&self->claimed, __ATOMIC_RELAXED);
+        if (claimed > required)
+            required = claimed;
+        size_t length = _HEAD(self).length;
+        size_t capacity = cds_growth_policy_grow(
+            _HEAD(self).policy,
+            self->capacity,
+            required,
+            _HEAD(self).type_size,
+            sizeof(cds_buffer_header_t)
+        );
+        status = cds_buffer_reserve(&self->buffer, capacity - length);
+        if (status == cds_alloc_error && capacity > required)
+            status = cds_buffer_reserve(&self->buffer, required - length);
+        self->capacity = _HEAD(self).reserved;
+        if (status == cds_ok && self->capacity < required)
+            status = cds_alloc_error;
+    }
+    pthread_rwlock_unlock(&self->lock);
+    return status;
+}
+
+CDS_PUBLIC
+cds_status_t cds_appender_init(cds_appender_t *self, cds_buffer_t buffer) {
+    CDS_IF_NULL_RETURN_ERROR(self);
+    CDS_IF_NULL_RETURN_ERROR(buffer);
+    CDS_NEW_STATUS = cds_ok;
+    CDS_IF_ERROR_RETURN_STATUS(cds_buffer_set_ring(&buffer, false));
+    if (pthread_rwlock_init(&self->lock, NULL) != 0)
+        return cds_error;
+    self->buffer = buffer;
+    self->type_size = _HEAD(self).type_size;
+    self->capacity = _HEAD(self).reserved;
+    self->start = _HEAD(self).length;
+    self->claimed = self->start;
+    self->committed = self->start;
+    self->lost = 0;
+    self->first_lost = SIZE_MAX;
+    return cds_ok;
+}
+
+/**
+ * @brief Give up slots which were claimed but can never be filled in, so
+ * that `cds_appender_finish` knows where the committed elements end.
+ */
+CDS_PRIVATE
+void _cds_appender_lose(cds_appender_t *self, size_t index, size_t count) {
+    size_t first = __atomic_load_n(&self->first_lost, __ATOMIC_RELAXED);
+    while (index < first) {
+        if (__atomic_compare_exchange_n(
+            &self->first_lost,
+            &first,
+            index,
+            true,
+            __ATOMIC_RELAXED,
+            __ATOMIC_RELAXED
+        ))
+            break;
+    }
+    __atomic_fetch_add(&self->lost, count, __ATOMIC_RELEASE);
+}
+
+CDS_PUBLIC
+cds_status_t cds_appender_claim(
+    cds_appender_t *self,
+    size_t count,
+    cds_ptr_t *slots
+) {
+    CDS_IF_NULL_RETURN_ERROR(self);
+    CDS_IF_NULL_RETURN_ERROR(slots);
+    // Check for overflow before claiming anything, so that a claim which is
+    // too large leaves no gap behind.
+    size_t index = __atomic_load_n(&self->claimed, __ATOMIC_RELAXED);
+    do {
+        if (count > SIZE_MAX - index)
+            return cds_alloc_error;
+    } while (!__atomic_compare_exchange_n(
+        &self->claimed,
+        &index,
+        index + count,
+        true,
+        __ATOMIC_RELAXED,
+        __ATOMIC_RELAXED
+    ));
+    CDS_NEW_STATUS = cds_ok;
+    if (pthread_rwlock_rdlock(&self->lock) != 0) {
+        _cds_appender_lose(self, index, count);
+        return cds_error;
+    }
+    while (index + count > self->capacity) {
+        pthread_rwlock_unlock(&self->lock);
+        CDS_IF_STATUS_ERROR(_cds_appender_grow(self, index + count)) {
+            _cds_appender_lose(self, index, count);
+            return status;
+        }
+        if (pthread_rwlock_rdlock(&self->lock) != 0) {
+            _cds_appender_lose(self, index, count);
+            return cds_error;
+        }
+    }
+    *slots = (cds_byte_t *) self->buffer + index * self->type_size;
+    return cds_ok;
+}
+
+CDS_PUBLIC
+cds_status_t cds_appender_commit(cds_appender_t *self, size_t count) {
+    CDS_IF_NULL_RETURN_ERROR(self);
+    __atomic_fetch_add(&self->committed, count, __ATOMIC_RELEASE);
+    if (pthread_rwlock_unlock(&self->lock) != 0)
+        return cds_error;
+    return cds_ok;
+}
+
+CDS_PUBLIC
+cds_status_t cds_appender_append(
+    cds_appender_t *self,
+    cds_ptr_t src,
+    size_t count
+) {
+    CDS_IF_NULL_RETURN_ERROR(self);
+    if (count == 0)
+        return cds_ok;
+    CDS_IF_NULL_RETURN_ERROR(src);
+    CDS_NEW_STATUS = cds_ok;
+    cds_ptr_t slots = NULL;
+    CDS_IF_ERROR_RETURN_STATUS(cds_appender_claim(self, count, &slots));
+    memcpy(slots, src, count * self->type_size);
+    return cds_appender_commit(self, count);
+}
+
+CDS_PUBLIC
+size_t cds_appender_length(cds_appender_t *self) {
+    if (self == NULL)
+        return 0;
+    return __atomic_load_n(&self->committed, __ATOMIC_ACQUIRE);
+}
+
+CDS_PUBLIC
+cds_status_t cds_appender_finish(cds_appender_t *self, cds_buffer_t *buffer) {
+    CDS_IF_NULL_RETURN_ERROR(self);
+    CDS_IF_NULL_RETURN_ERROR(self->buffer);
+    CDS_IF_NULL_RETURN_ERROR(buffer);
+    size_t claimed = __atomic_load_n(&self->claimed, __ATOMIC_ACQUIRE);
+    size_t committed = __atomic_load_n(&self->committed, __ATOMIC_ACQUIRE);
+    size_t lost = __atomic_load_n(&self->lost, __ATOMIC_ACQUIRE);
+    CDS_NEW_STATUS = cds_ok;
+    if (claimed != committed + lost) {
+        status = cds_error;
+    } else if (lost > 0) {
+        // Every slot in front of the first lost one has been committed.
+        _HEAD(self).length = self->first_lost;
+        status = cds_alloc_error;
+    } else {
+        _HEAD(self).length = committed;
+    }
+    pthread_rwlock_destroy(&self->lock);
+    *buffer = self->buffer;
+    self->buffer = NULL;
+    return status;
+}
@@ -0,0 +1,325 @@
+#include <string.h>
+#include <CDataStructures/bitset.h>
+
+#define _BLOCK_WORDS 8
+#define _WORDS_FOR(bits) \
+    (((bits) + CDS_BITSET_WORD_BITS - 1) / CDS_BITSET_WORD_BITS)
+#define _VALIDATE_BITSET(self) \
+    CDS_IF_NULL_RETURN_ERROR(self); \
+    CDS_IF_NULL_RETURN_ERROR((self)->words);
+
+/**
+ * @brief Clear the bits past the length in the last word.
+ */
+CDS_INLINE void _cds_bitset_clear_tail(cds_bitset_t *self) {
+    size_t used = self->length % CDS_BITSET_WORD_BITS;
+    if (used != 0)
+        self->words[self->length / CDS_BITSET_WORD_BITS]
+            &= ((uint64_t) 1 << used) - 1;
+}
+
+/**
+ * @brief Get the number of set bits before word `offset` of a block from the
+ * packed counts.
+ */
+CDS_INLINE size_t _cds_bitset_in_block(const uint64_t *entry, size_t offset) {
+    if (offset == 0)
+        return 0;
+    return (size_t) ((entry[1] >> (9 * (offset - 1))) & 0x1FF);
+}
+
+CDS_PUBLIC
+cds_status_t cds_bitset_init(cds_bitset_t *self, size_t length) {
+    return cds_bitset_init_with_allocator(self, length, NULL);
+}
+
+CDS_PUBLIC
+cds_status_t cds_bitset_init_with_allocator(
+    cds_bitset_t *self,
+    size_t length,
+    const cds_allocator_t *allocator
+) {
+    CDS_IF_NULL_RETURN_ERROR(self);
+    self->length = length;
+    self->capacity = _WORDS_FOR(length);
+    if (self->capacity == 0)
+        self->capacity = 1;
+    self->allocator = allocator;
+    self->_index = NULL;
+    self->_index_words = 0;
+    self->_ones = 0;
+    self->_indexed = false;
+    self->words = cds_allocator_alloc(
+        allocator,
+        self->capacity * sizeof(uint64_t)
+    );
+    CDS_IF_NULL_RETURN_ALLOC_ERROR(self->words);
+    memset(self->words, 0, self->capacity * sizeof(uint64_t));
+    return cds_ok;
+}
+
+CDS_PUBLIC
+cds_status_t cds_bitset_destroy(cds_bitset_t *self) {
+    if (self == NULL)
+        return cds_warning;
+    cds_allocator_free(
+        self->allocator,
+        self->words,
+        self->capacity * sizeof(uint64_t)
+    );
+    cds_allocator_free(
+        self->allocator,
+        self->_index,
+        self->_index_words * sizeof(uint64_t)
+    );
+    self->words = NULL;
+    self->_index = NULL;
+    self->length = 0;
+    self->capacity = 0;
+    self->_index_words = 0;
+    self->_indexed = false;
+    return cds_ok;
+}
+
+CDS_PUBLIC
+cds_status_t cds_bitset_resize(cds_bitset_t *self, size_t length) {
+    _VALIDATE_BITSET(self);
+    size_t old_words = _WORDS_FOR(self->length);
+    size_t new_words = _WORDS_FOR(length);
+    if (new_words > self->capacity) {
+        uint64_t *words = cds_allocator_realloc(
+            self->allocator,
+            self->words,
+            self->capacity * sizeof(uint64_t),
+            new_words * sizeof(uint64_t)
+        );
+        CDS_IF_NULL_RETURN_ALLOC_ERROR(words);
+        self->words = words;
+        self->capacity = new_words;
+    }
+    if (new_words > old_words) {
+        memset(
+            self->words + old_words,
+            0,
+            (new_words - old_words) * sizeof(uint64_t)
+        );
+    }
+    self->length = length;
+    _cds_bitset_clear_tail(self);
+    self->_indexed = false;
+    return cds_ok;
+}
+
+CDS_PUBLIC
+cds_status_t cds_bitset_fill(cds_bitset_t *self, bool value) {
+    _VALIDATE_BITSET(self);
+    memset(
+        self->words,
+        value ? 0xFF : 0,
+        _WORDS_FOR(self->length) * sizeof(uint64_t)
+    );
+    _cds_bitset_clear_tail(self);
+    self->_indexed = false;
+    return cds_ok;
+}
+
+#define _CDS_BITSET_BULK(name, op) \
+    CDS_PUBLIC \
+    cds_status_t cds_bitset_##name( \
+        cds_bitset_t *self, \
+        const cds_bitset_t *other \
+    ) { \
+        _VALIDATE_BITSET(self); \
+        _VALIDATE_BITSET(other); \
+        if (self->length != other->length) \
+            return cds_error; \
+        uint64_t *dest = self->words; \
+        const uint64_t *src = other->words; \
+        size_t words = _WORDS_FOR(self->length); \
+        size_t index = 0; \
+        for (; index < words; index++) \
+            dest[index] = op; \
+        self->_indexed = false; \
+        return cds_ok; \
+    }
+
+_CDS_BITSET_BULK(and, dest[index] & src[index])
+_CDS_BITSET_BULK(or, dest[index] | src[index])
+_CDS_BITSET_BULK(xor, dest[index] ^ src[index])
+_CDS_BITSET_BULK(andnot, dest[index] & ~src[index])
+
+#undef _CDS_BITSET_BULK
+
+CDS_PUBLIC
+size_t cds_bitset_count(const cds_bitset_t *self) {
+    if (self == NULL || self->words == NULL)
+        return 0;
+    if (self->_indexed)
+        return self->_ones;
+    size_t words = _WORDS_FOR(self->length);
+    size_t ones = 0;
+    size_t index = 0;
+    for (; index < words; index++)
+        ones += (size_t) cds_uint64_popcount(self->words[index]);
+    return ones;
+}
+
+/**
+ * @brief Find the first bit at or after `from` which is set in the words
+ * after they are xored with `flip`.
+ */
+CDS_PRIVATE
+size_t _cds_bitset_find_next(
+    const cds_bitset_t *self,
+    size_t from,
+    uint64_t flip
+) {
+    if (self == NULL)
+        return 0;
+    if (self->words == NULL || from >= self->length)
+        return self->length;
+    size_t words = _WORDS_FOR(self->length);
+    size_t index = from / CDS_BITSET_WORD_BITS;
+    uint64_t word = (self->words[index] ^ flip)
+        & (~(uint64_t) 0 << (from % CDS_BITSET_WORD_BITS));
+    while (word == 0) {
+        if (++index == words)
+            return self->length;
+        word = self->words[index] ^ flip;
+    }
+    size_t found = index * CDS_BITSET_WORD_BITS
+        + (size_t) cds_uint64_trailing_zeros(word);
+    // Flipped tail bits past the length are not real clear bits.
+    return found < self->length ? found : self->length;
+}
+
+CDS_PUBLIC
+size_t cds_bitset_find_next_set(const cds_bitset_t *self, size_t from) {
+    return _cds_bitset_find_next(self, from, 0);
+}
+
+CDS_PUBLIC
+size_t cds_bitset_find_next_clear(const cds_bitset_t *self, size_t from) {
+    return _cds_bitset_find_next(self, from, ~(uint64_t) 0);
+}
+
+CDS_PUBLIC
+cds_status_t cds_bitset_build_index(cds_bitset_t *self) {
+    _VALIDATE_BITSET(self);
+    size_t words = _WORDS_FOR(self->length);
+    size_t blocks = (words + _BLOCK_WORDS - 1) / _BLOCK_WORDS;
+    size_t ones = cds_bitset_count(self);
+    size_t samples = (ones + CDS_BITSET_SELECT_SAMPLE - 1)
+        / CDS_BITSET_SELECT_SAMPLE;
+    size_t needed = 2 * blocks + samples;
+    if (needed == 0)
+        needed = 1;
+    if (needed > self->_index_words) {
+        uint64_t *index = cds_allocator_realloc(
+            self->allocator,
+            self->_index,
+            self->_index_words * sizeof(uint64_t),
+            needed * sizeof(uint64_t)
+        );
+        CDS_IF_NULL_RETURN_ALLOC_ERROR(index);
+        self->_index = index;
+        self->_index_words = needed;
+    }
+    uint64_t *sample = self->_index + 2 * blocks;
+    size_t next_sample = 0;
+    size_t total = 0;
+    size_t block = 0;
+    for (; block < blocks; block++) {
+        uint64_t *entry = self->_index + 2 * block;
+        size_t in_block = 0;
+        size_t offset = 0;
+        entry[0] = (uint64_t) total;
+        entry[1] = 0;
+        for (; offset < _BLOCK_WORDS; offset++) {
+            size_t word = block * _BLOCK_WORDS + offset;
+            if (offset > 0)
+                entry[1] |= (uint64_t) in_block << (9 * (offset - 1));
+            if (word < words)
+                in_block += (size_t) cds_uint64_popcount(self->words[word]);
+        }
+        total += in_block;
+        // Remember this block for every sampled set bit inside it.
+        while (next_sample < total) {
+            sample[next_sample / CDS_BITSET_SELECT_SAMPLE] = (uint64_t) block;
+            next_sample += CDS_BITSET_SELECT_SAMPLE;
+        }
+    }
+    self->_ones = total;
+    self->_indexed = true;
+    return cds_ok;
+}
+
+CDS_PUBLIC
+cds_status_t cds_bitset_rank(
+    const cds_bitset_t *self,
+    size_t index,
+    size_t *result
+) {
+    _VALIDATE_BITSET(self);
+    CDS_IF_NULL_RETURN_ERROR(result);
+    if (!self->_indexed)
+        return cds_error;
+    if (index > self->length)
+        return cds_index_error;
+    if (index == self->length) {
+        *result = self->_ones;
+        return cds_ok;
+    }
+    size_t word = index / CDS_BITSET_WORD_BITS;
+    const uint64_t *entry = self->_index + 2 * (word / _BLOCK_WORDS);
+    uint64_t below = ((uint64_t) 1 << (index % CDS_BITSET_WORD_BITS)) - 1;
+    *result = (size_t) entry[0]
+        + _cds_bitset_in_block(entry, word % _BLOCK_WORDS)
+        + (size_t) cds_uint64_popcount(self->words[word] & below);
+    return cds_ok;
+}
+
+CDS_PUBLIC
+cds_status_t cds_bitset_select(
+    const cds_bitset_t *self,
+    size_t rank,
+    size_t *result
+) {
+    _VALIDATE_BITSET(self);
+    CDS_IF_NULL_RETURN_ERROR(result);
+    if (!self->_indexed)
+        return cds_error;
+    if (rank >= self->_ones)
+        return cds_index_error;
+    size_t words = _WORDS_FOR(self->length);
+    size_t blocks = (words + _BLOCK_WORDS - 1) / _BLOCK_WORDS;
+    const uint64_t *sample = self->_index + 2 * blocks;
+    size_t samples = (self->_ones + CDS_BITSET_SELECT_SAMPLE - 1)
+        / CDS_BITSET_SELECT_SAMPLE;
+    size_t nth = rank / CDS_BITSET_SELECT_SAMPLE;
+    // The last block in [low, high] with no more than `rank` set bits before
+    // it holds the set bit.
+    size_t low = (size_t) sample[nth];
+    size_t high = nth + 1 < samples ? (size_t) sample[nth + 1] : blocks - 1;
+    while (low < high) {
+        size_t middle = low + (high - low + 1) / 2;
+        if ((size_t) self->_index[2 * middle] <= rank)
+            low = middle;
+        else
+            high = middle - 1;
+    }
+    const uint64_t *entry = self->_index + 2 * low;
+    size_t remaining = rank - (size_t) entry[0];
+    size_t offset = 1;
+    while (offset < _BLOCK_WORDS
+        && _cds_bitset_in_block(entry, offset) <= remaining)
+        offset++;
+    offset--;
+    remaining -= _cds_bitset_in_block(entry, offset);
+    size_t word = low * _BLOCK_WORDS + offset;
+    *result = word * CDS_BITSET_WORD_BITS + (size_t) cds_uint64_select(
+        self->words[word],
+        (int32_t) remaining
+    );
+    return cds_ok;
+}
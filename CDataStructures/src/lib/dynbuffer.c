@@ -2,12 +2,22 @@
 #include <stdlib.h>
 #include <string.h>
 #include <CDataStructures/dynbuffer.h>
+#ifdef CDS_HAVE_MMAP
+#   include <fcntl.h>
+#   include <sys/mman.h>
+#   include <sys/stat.h>
+#   include <unistd.h>
+#endif
 
 #define _HEAD(self) (*self)->header
 #define _VALIDATE_BUF(buffer) \
     CDS_IF_NULL_RETURN_ERROR(buffer); \
     self = cds_buffer_get_data(buffer); \
     CDS_IF_NULL_RETURN_ERROR(self);
+#define _UNIQUE_BUF(buffer) \
+    if (CDS_IS_ERROR(_cds_buffer_make_unique(&self, true))) \
+        return cds_alloc_error; \
+    *(buffer) = cds_buffer_get_inner(self);
 
 #ifdef CDS_USE_ALLOC_LIB
 const cds_alloc_config_t CDS_BUFFER_DATA_ALLOC_CONFIG = {
@@ -19,19 +29,13 @@ const cds_alloc_config_t CDS_BUFFER_DATA_ALLOC_CONFIG = {
 
 /**
  * @brief Get how many bytes are required to store a buffer of a certain
- * length carrying a certain type of data.
+ * length carrying a certain type of data. Capacities are already rounded by
+ * the growth policy, so this never rounds them again, with or without the
+ * alloc library.
  */
 CDS_PRIVATE
 size_t _cds_buffer_required_bytes(cds_buffer_data_t *self, size_t capacity) {
-#ifdef CDS_USE_ALLOC_LIB
-    return cds_required_space_with_config(
-        capacity,
-        self->header.type_size,
-        CDS_BUFFER_DATA_ALLOC_CONFIG
-    );
-#else
     return self->header.type_size * capacity + sizeof(cds_buffer_header_t);
-#endif
 }
 
 CDS_INLINE
@@ -49,7 +53,369 @@ void _cds_buffer_set_reserved_from_bytes_allocated(cds_buffer_data_t *self) {
 }
 
 /**
- * @brief Reallocate the buffer to a certain number of bytes.
+ * @brief Get the slot in the allocated array where the element at a certain
+ * index is stored. Buffers which are not in ring mode always have a head of
+ * 0, so the slot is the same as the index.
+ */
+CDS_INLINE
+size_t _cds_buffer_slot(cds_buffer_data_t *self, size_t index) {
+    size_t slot = self->header.head + index;
+    if (slot >= self->header.reserved)
+        slot -= self->header.reserved;
+    return slot;
+}
+
+CDS_PRIVATE
+cds_ptr_t _cds_buffer_get(cds_buffer_data_t *self, size_t index) {
+    return ((cds_byte_t *) cds_buffer_get_inner(self))
+        + (_cds_buffer_slot(self, index) * self->header.type_size);
+}
+
+CDS_INLINE
+bool _cds_buffer_is_ring(cds_buffer_data_t *self) {
+    return (self->header.flags & cds_buffer_ring) != 0;
+}
+
+/**
+ * @brief Check whether the elements of a ring buffer wrap around the end of
+ * the allocated array.
+ */
+CDS_INLINE
+bool _cds_buffer_is_wrapped(cds_buffer_data_t *self) {
+    return self->header.head + self->header.length > self->header.reserved;
+}
+
+CDS_PRIVATE
+void _cds_buffer_reverse_bytes(cds_byte_t *start, size_t count) {
+    cds_byte_t *end = start + count;
+    while (start + 1 < end) {
+        cds_byte_t temp = *start;
+        *start++ = *--end;
+        *end = temp;
+    }
+}
+
+/**
+ * @brief Move the elements of a ring buffer so that the first element is at
+ * the start of the allocated array and the elements no longer wrap around.
+ */
+CDS_PRIVATE
+void _cds_buffer_linearize(cds_buffer_data_t *self) {
+    size_t head = self->header.head;
+    if (head == 0)
+        return;
+    size_t type_size = self->header.type_size;
+    cds_byte_t *start = cds_buffer_get_inner(self);
+    if (!_cds_buffer_is_wrapped(self)) {
+        memmove(start, start + head * type_size, self->header.length * type_size);
+        self->header.head = 0;
+        return;
+    }
+    // The elements are split into 2 segments: [head, reserved) at the end of
+    // the array followed by [0, tail) at the front of the array.
+    size_t back = self->header.reserved - head;
+    size_t front = self->header.length - back;
+    size_t smaller = back < front ? back : front;
+    const cds_allocator_t *allocator = self->header.allocator;
+    cds_byte_t *temp = cds_allocator_alloc(allocator, smaller * type_size);
+    if (temp == NULL) {
+        // Rotate the whole array in place if no scratch memory is available.
+        _cds_buffer_reverse_bytes(start, head * type_size);
+        _cds_buffer_reverse_bytes(
+            start + head * type_size,
+            back * type_size
+        );
+        _cds_buffer_reverse_bytes(start, self->header.reserved * type_size);
+    } else if (back <= front) {
+        memcpy(temp, start + head * type_size, back * type_size);
+        memmove(start + back * type_size, start, front * type_size);
+        memcpy(start, temp, back * type_size);
+        cds_allocator_free(allocator, temp, smaller * type_size);
+    } else {
+        memcpy(temp, start, front * type_size);
+        memmove(start, start + head * type_size, back * type_size);
+        memcpy(start + back * type_size, temp, front * type_size);
+        cds_allocator_free(allocator, temp, smaller * type_size);
+    }
+    self->header.head = 0;
+}
+
+/**
+ * @brief Get the pointer to the start of the memory block allocated for the
+ * buffer. This is in front of the header if the header had to be padded to
+ * align the elements.
+ */
+CDS_INLINE
+cds_byte_t *_cds_buffer_raw(cds_buffer_data_t *self) {
+    return ((cds_byte_t *) self) - self->header.padding;
+}
+
+/**
+ * @brief Get how many bytes the header has to be placed after the start of a
+ * memory block so that the elements after it are aligned.
+ */
+CDS_INLINE
+size_t _cds_buffer_padding_for(cds_byte_t *raw, size_t alignment) {
+    if (alignment <= 1)
+        return 0;
+    size_t misalignment = (size_t)
+        ((uintptr_t) (raw + sizeof(cds_buffer_header_t)) % alignment);
+    return misalignment == 0 ? 0 : alignment - misalignment;
+}
+
+/**
+ * @brief Get the number of bytes allocated on top of `bytes_allocated` so that
+ * the header can be shifted to align the elements.
+ */
+CDS_INLINE
+size_t _cds_buffer_slack(size_t alignment) {
+    return alignment > 1 ? alignment - 1 : 0;
+}
+
+CDS_INLINE
+bool _cds_buffer_is_mapped(cds_buffer_data_t *self) {
+    return (self->header.flags & cds_buffer_mapped) != 0;
+}
+
+#ifdef CDS_HAVE_MMAP
+/**
+ * @brief Get the offset of the first element in the file backing a mapped
+ * buffer. The private memory in front of the elements is as large as the
+ * file's header, so this is where the elements start in memory too.
+ */
+CDS_INLINE
+size_t _cds_buffer_file_offset(cds_buffer_data_t *self) {
+    return self->header.padding + sizeof(cds_buffer_header_t);
+}
+
+/**
+ * @brief Map `data_bytes` bytes of a file starting `offset` bytes into it,
+ * right after `offset` bytes of private memory whose end holds the header.
+ * Keeping the header out of the file means that the descriptor, reference
+ * count and other fields which only make sense in this process are never
+ * seen or overwritten by another process mapping the same file.
+ *
+ * @return cds_buffer_data_t* The buffer, whose header is uninitialised. NULL
+ * if the memory could not be mapped.
+ */
+CDS_PRIVATE
+cds_buffer_data_t *_cds_buffer_map_region(
+    int fd,
+    size_t offset,
+    size_t data_bytes,
+    bool shared
+) {
+    if (data_bytes > SIZE_MAX - offset)
+        return NULL;
+    cds_byte_t *raw = mmap(
+        NULL,
+        offset + data_bytes,
+        PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS,
+        -1,
+        0
+    );
+    if (raw == MAP_FAILED)
+        return NULL;
+    if (data_bytes > 0 && mmap(
+        raw + offset,
+        data_bytes,
+        PROT_READ | PROT_WRITE,
+        (shared ? MAP_SHARED : MAP_PRIVATE) | MAP_FIXED,
+        fd,
+        (off_t) offset
+    ) == MAP_FAILED) {
+        munmap(raw, offset + data_bytes);
+        return NULL;
+    }
+    return (cds_buffer_data_t *) (raw + offset - sizeof(cds_buffer_header_t));
+}
+
+/**
+ * @brief Write the fields describing the elements of a mapped buffer to the
+ * start of its file.
+ */
+CDS_PRIVATE
+cds_status_t _cds_buffer_write_file_header(cds_buffer_data_t *self) {
+    cds_buffer_file_header_t file = {
+        .magic = CDS_BUFFER_FILE_MAGIC,
+        .version = CDS_BUFFER_FILE_VERSION,
+        .endian_marker = CDS_SERIAL_ENDIAN_MARKER,
+        .header_size = _cds_buffer_file_offset(self),
+        .type_size = self->header.type_size,
+        .length = self->header.length,
+        .head = self->header.head,
+        .flags = self->header.flags & cds_buffer_ring
+    };
+    if (pwrite(self->header.fd, &file, sizeof(file), 0)
+        != (ssize_t) sizeof(file))
+        return cds_error;
+    return cds_ok;
+}
+#endif
+
+/**
+ * @brief Grow a memory-mapped buffer to `bytes` by extending its file and
+ * mapping it again. Mapped buffers never give memory back, as the file would
+ * have to be truncated and remapped just to save address space.
+ */
+CDS_PRIVATE
+cds_status_t _cds_buffer_remap(cds_buffer_data_t **self, size_t bytes) {
+#ifdef CDS_HAVE_MMAP
+    size_t old_bytes = _HEAD(self).bytes_allocated;
+    if (bytes <= old_bytes)
+        return cds_ok;
+    // Private mappings are copies of the file which cannot be extended.
+    if ((_HEAD(self).flags & cds_buffer_mapped_shared) == 0)
+        return cds_alloc_error;
+    int fd = _HEAD(self).fd;
+    size_t offset = _cds_buffer_file_offset(*self);
+    size_t header = sizeof(cds_buffer_header_t);
+    if (bytes - header > SIZE_MAX - offset
+        || ftruncate(fd, (off_t) (offset + bytes - header)) != 0)
+        return cds_alloc_error;
+    cds_buffer_data_t *map = _cds_buffer_map_region(
+        fd,
+        offset,
+        bytes - header,
+        true
+    );
+    if (map == NULL) {
+        ftruncate(fd, (off_t) (offset + old_bytes - header));
+        return cds_alloc_error;
+    }
+    map->header = _HEAD(self);
+    munmap(_cds_buffer_raw(*self), offset + old_bytes - header);
+    *self = map;
+    _HEAD(self).bytes_allocated = bytes;
+    return cds_ok;
+#else
+    return cds_alloc_error;
+#endif
+}
+
+/**
+ * @brief Free the memory block storing the buffer. Writable mapped buffers
+ * write their length back to their file first.
+ */
+CDS_PRIVATE
+void _cds_buffer_free_data(cds_buffer_data_t *self) {
+#ifdef CDS_HAVE_MMAP
+    if (_cds_buffer_is_mapped(self)) {
+        int fd = self->header.fd;
+        if ((self->header.flags & cds_buffer_mapped_shared) != 0)
+            _cds_buffer_write_file_header(self);
+        munmap(
+            _cds_buffer_raw(self),
+            self->header.padding + self->header.bytes_allocated
+        );
+        close(fd);
+        return;
+    }
+#endif
+    cds_allocator_free(
+        self->header.allocator,
+        _cds_buffer_raw(self),
+        self->header.bytes_allocated
+            + _cds_buffer_slack(self->header.alignment)
+    );
+}
+
+/**
+ * @brief Move the buffer into a new memory block from `allocator` whose
+ * elements are aligned to `alignment`, then free the old memory block.
+ */
+CDS_PRIVATE
+cds_status_t _cds_buffer_move_data(
+    cds_buffer_data_t **self,
+    const cds_allocator_t *allocator,
+    size_t alignment
+) {
+    if (_cds_buffer_is_mapped(*self))
+        return cds_error;
+    size_t bytes = _HEAD(self).bytes_allocated;
+    size_t slack = _cds_buffer_slack(alignment);
+    if (bytes > SIZE_MAX - slack)
+        return cds_alloc_error;
+    cds_byte_t *raw = cds_allocator_alloc(allocator, bytes + slack);
+    CDS_IF_NULL_RETURN_ALLOC_ERROR(raw);
+    size_t padding = _cds_buffer_padding_for(raw, alignment);
+    cds_buffer_data_t *new = (cds_buffer_data_t *) (raw + padding);
+    memcpy(new, *self, bytes);
+    _cds_buffer_free_data(*self);
+    *self = new;
+    _HEAD(self).allocator = allocator;
+    _HEAD(self).alignment = alignment;
+    _HEAD(self).padding = padding;
+    return cds_ok;
+}
+
+CDS_INLINE
+size_t _cds_buffer_refcount(cds_buffer_data_t *self) {
+#ifdef __GNUC__
+    return __atomic_load_n(&self->header.refcount, __ATOMIC_ACQUIRE);
+#else
+    return self->header.refcount;
+#endif
+}
+
+/**
+ * @brief Drop one reference to a shared buffer and check whether it was the
+ * last one.
+ */
+CDS_INLINE
+bool _cds_buffer_release(cds_buffer_data_t *self) {
+#ifdef __GNUC__
+    return __atomic_sub_fetch(&self->header.refcount, 1, __ATOMIC_ACQ_REL)
+        == 0;
+#else
+    return --(self->header.refcount) == 0;
+#endif
+}
+
+/**
+ * @brief Give the caller its own copy of a shared buffer and drop its
+ * reference to the shared one. If `keep_elements` is false, the copy is an
+ * empty buffer with the same settings instead.
+ */
+CDS_PRIVATE
+cds_status_t _cds_buffer_make_unique(
+    cds_buffer_data_t **self,
+    bool keep_elements
+) {
+    if (_cds_buffer_refcount(*self) <= 1)
+        return cds_ok;
+    size_t alignment = _HEAD(self).alignment;
+    size_t bytes = keep_elements
+        ? _HEAD(self).bytes_allocated
+        : sizeof(cds_buffer_data_t);
+    size_t slack = _cds_buffer_slack(alignment);
+    if (bytes > SIZE_MAX - slack)
+        return cds_alloc_error;
+    cds_byte_t *raw = cds_allocator_alloc(_HEAD(self).allocator, bytes + slack);
+    CDS_IF_NULL_RETURN_ALLOC_ERROR(raw);
+    size_t padding = _cds_buffer_padding_for(raw, alignment);
+    cds_buffer_data_t *copy = (cds_buffer_data_t *) (raw + padding);
+    memcpy(copy, *self, keep_elements ? bytes : sizeof(cds_buffer_header_t));
+    copy->header.padding = padding;
+    copy->header.refcount = 1;
+    if (!keep_elements) {
+        copy->header.bytes_allocated = bytes;
+        copy->header.length = 0;
+        copy->header.reserved = 0;
+        copy->header.head = 0;
+    }
+    // The other owners may have let go of the buffer in the meantime.
+    if (_cds_buffer_release(*self))
+        _cds_buffer_free_data(*self);
+    *self = copy;
+    return cds_ok;
+}
+
+/**
+ * @brief Reallocate the buffer to a certain number of bytes. If the buffer
+ * has an alignment, some slack is allocated on top of `bytes` so that the
+ * header can be shifted forward to keep the elements aligned.
  */
 CDS_PRIVATE
 cds_status_t _cds_buffer_realloc_data(
@@ -61,12 +427,35 @@ cds_status_t _cds_buffer_realloc_data(
     printf("[_cds_buffer_realloc_data] amount of bytes required: %zu\n", bytes);
     printf("[_cds_buffer_realloc_data] old: %p\n", *self);
 #endif
-    cds_buffer_data_t *new = realloc(*self, bytes);
-    CDS_IF_NULL_RETURN_ALLOC_ERROR(new);
+    if (_cds_buffer_is_mapped(*self))
+        return _cds_buffer_remap(self, bytes);
+    size_t alignment = _HEAD(self).alignment;
+    size_t old_padding = _HEAD(self).padding;
+    size_t old_bytes = _HEAD(self).bytes_allocated;
+    size_t slack = _cds_buffer_slack(alignment);
+    if (bytes > SIZE_MAX - slack)
+        return cds_alloc_error;
+    cds_byte_t *raw = cds_allocator_realloc(
+        _HEAD(self).allocator,
+        _cds_buffer_raw(*self),
+        old_bytes + slack,
+        bytes + slack
+    );
+    CDS_IF_NULL_RETURN_ALLOC_ERROR(raw);
+    size_t padding = _cds_buffer_padding_for(raw, alignment);
+    if (padding != old_padding) {
+        memmove(
+            raw + padding,
+            raw + old_padding,
+            old_bytes < bytes ? old_bytes : bytes
+        );
+    }
+    cds_buffer_data_t *new = (cds_buffer_data_t *) (raw + padding);
 #ifdef CDS_DEBUG
     printf("[_cds_buffer_realloc_data] new: %p\n", new);
 #endif
     *self = new;
+    _HEAD(self).padding = padding;
     _HEAD(self).bytes_allocated = bytes;
 #ifdef CDS_DEBUG
     printf(" <-- [_cds_buffer_realloc_data]\n");
@@ -74,41 +463,6 @@ cds_status_t _cds_buffer_realloc_data(
     return cds_ok;
 }
 
-#ifdef CDS_USE_ALLOC_LIB
-CDS_PRIVATE
-cds_status_t _cds_buffer_realloc_eager(
-    cds_buffer_data_t **self,
-    size_t length
-) {
-    size_t bytes = _cds_buffer_required_bytes(*self, length);
-    CDS_NEW_STATUS = _cds_buffer_realloc_data(self, bytes);
-    if (!CDS_IS_ERROR(status)) {
-        _HEAD(self).length = length;
-        _cds_buffer_set_reserved_from_bytes_allocated(*self);
-    }
-    return status;
-}
-
-CDS_PRIVATE
-cds_status_t _cds_buffer_realloc_lazy(
-    cds_buffer_data_t **self,
-    size_t length
-) {
-    size_t bytes = _cds_buffer_required_bytes(*self, length);
-    if (bytes > _HEAD(self).bytes_allocated) {
-        CDS_NEW_STATUS = _cds_buffer_realloc_data(self, bytes);
-        if (!CDS_IS_ERROR(status)) {
-            _HEAD(self).length = length;
-            _cds_buffer_set_reserved_from_bytes_allocated(*self);
-        }
-        return status;
-    } else {
-        _HEAD(self).length = length;
-        return cds_ok;
-    }
-}
-#endif
-
 CDS_PRIVATE
 cds_status_t _cds_buffer_reserve(
     cds_buffer_data_t **self,
@@ -116,62 +470,72 @@ cds_status_t _cds_buffer_reserve(
 ) {
     CDS_NEW_STATUS = cds_ok;
     size_t current = _HEAD(self).reserved;
+    if (new_capacity > (SIZE_MAX - sizeof(cds_buffer_data_t))
+        / _HEAD(self).type_size)
+        return cds_alloc_error;
     if (new_capacity > current) {
+        bool wrapped = _cds_buffer_is_wrapped(*self);
         CDS_IF_ERROR_RETURN_STATUS(_cds_buffer_realloc_data(
             self,
             _cds_buffer_required_bytes(*self, new_capacity)
         ));
-        _HEAD(self).reserved = new_capacity;
+        _cds_buffer_set_reserved_from_bytes_allocated(*self);
+        if (wrapped) {
+            // Move the segment at the end of the old array to the end of the
+            // new array so that the elements stay in order.
+            size_t type_size = _HEAD(self).type_size;
+            size_t back = current - _HEAD(self).head;
+            size_t new_head = _HEAD(self).reserved - back;
+            cds_byte_t *start = cds_buffer_get_inner(*self);
+            memmove(
+                start + new_head * type_size,
+                start + _HEAD(self).head * type_size,
+                back * type_size
+            );
+            _HEAD(self).head = new_head;
+        }
     } else if (new_capacity < current) {
         return cds_alloc_error;
     }
     return status;
 }
 
+/**
+ * @brief Grow the buffer according to its growth policy so that it can hold
+ * at least `required` elements. If the policy asks for more memory than can
+ * be allocated, only `required` elements are reserved instead.
+ */
 CDS_PRIVATE
-cds_status_t _cds_buffer_increase_reserved(cds_buffer_data_t **self) {
-#ifdef CDS_DEBUG
-    printf(" --> [_cds_buffer_increase_reserved]\n");
-#endif
-    size_t extra = _HEAD(self).reserved;
-#ifdef CDS_DEBUG
-    printf("[_cds_buffer_increase_reserved] Amount of space already inside: %zu\n", extra);
-#endif
-    if (extra == 0)
-        return _cds_buffer_reserve(self, 1);
-    CDS_NEW_STATUS = cds_ok;
-    while (extra > 0) {
-        size_t new_capacity = _HEAD(self).reserved + extra;
+cds_status_t _cds_buffer_grow(cds_buffer_data_t **self, size_t required) {
 #ifdef CDS_DEBUG
-        printf("[_cds_buffer_increase_reserved] Trying new capacity: %zu\n", new_capacity);
+    printf(" --> [_cds_buffer_grow]\n");
 #endif
-        switch (status = _cds_buffer_reserve(self, new_capacity)) {
-            case cds_ok:
+    size_t new_capacity = cds_growth_policy_grow(
+        _HEAD(self).policy,
+        _HEAD(self).reserved,
+        required,
+        _HEAD(self).type_size,
+        sizeof(cds_buffer_header_t)
+    );
 #ifdef CDS_DEBUG
-                printf(" <-- [_cds_buffer_increase_reserved] Successfully reserved\n");
+    printf("[_cds_buffer_grow] Trying new capacity: %zu\n", new_capacity);
 #endif
-                return cds_ok;
-            case cds_alloc_error:
-                extra >>= 1;
-                continue;
-            default:
-                return status;
-        }
-    }
+    CDS_NEW_STATUS = _cds_buffer_reserve(self, new_capacity);
+    if (status == cds_alloc_error && new_capacity > required)
+        status = _cds_buffer_reserve(self, required);
 #ifdef CDS_DEBUG
-    printf(" <-- [_cds_buffer_increase_reserved] Error\n");
+    printf(" <-- [_cds_buffer_grow]\n");
 #endif
-    return cds_error;
+    return status;
 }
 
 CDS_PRIVATE
 cds_status_t _cds_buffer_fit(cds_buffer_data_t **self) {
+    _cds_buffer_linearize(*self);
     size_t length = _HEAD(self).length;
     size_t old_reserved = _HEAD(self).reserved;
     if (length < old_reserved) {
-        size_t required = length == 0
-            ? 1
-            : _cds_buffer_required_bytes(*self, length);
+        size_t required = _cds_buffer_required_bytes(*self, length);
         CDS_NEW_STATUS = cds_ok;
         CDS_IF_ERROR_RETURN_STATUS(_cds_buffer_realloc_data(
             self,
@@ -187,23 +551,70 @@ cds_status_t _cds_buffer_fit(cds_buffer_data_t **self) {
     }
 }
 
+/**
+ * @brief Give memory back after the buffer has shrunk from `old_length` to
+ * `length` elements, but only if the growth policy says the buffer has become
+ * small enough compared to its capacity. Shrinking only past a threshold and
+ * leaving room to grow again afterwards stops buffers whose length oscillates
+ * around a certain size from reallocating over and over again.
+ *
+ * A shrink counts as avoided when the length falls past the policy's shrink
+ * percentage but the buffer keeps its memory anyway, e.g. because of the
+ * shrink floor.
+ */
+CDS_PRIVATE
+void _cds_buffer_shrink(
+    cds_buffer_data_t **self,
+    size_t old_length,
+    size_t length
+) {
+    size_t reserved = _HEAD(self).reserved;
+    if (length >= reserved)
+        return;
+    const cds_growth_policy_t *policy = _HEAD(self).policy;
+    size_t type_size = _HEAD(self).type_size;
+    size_t threshold = cds_growth_policy_shrink_threshold(policy, reserved);
+    bool crossed = length < threshold && old_length >= threshold;
+    if (!cds_growth_policy_should_shrink(policy, length, reserved, type_size)) {
+        if (crossed)
+            ++(_HEAD(self).shrinks_avoided);
+        return;
+    }
+    size_t capacity = cds_growth_policy_shrink(
+        policy,
+        length,
+        type_size,
+        sizeof(cds_buffer_header_t)
+    );
+    if (capacity >= reserved) {
+        if (crossed)
+            ++(_HEAD(self).shrinks_avoided);
+        return;
+    }
+#ifdef CDS_DEBUG
+    printf("[_cds_buffer_shrink] Shrinking to capacity: %zu\n", capacity);
+#endif
+    _cds_buffer_linearize(*self);
+    // Failing to give memory back is not an error, the buffer is still
+    // intact in that case.
+    if (!CDS_IS_ERROR(_cds_buffer_realloc_data(
+        self,
+        _cds_buffer_required_bytes(*self, capacity)
+    )))
+        _cds_buffer_set_reserved_from_bytes_allocated(*self);
+}
+
 CDS_PRIVATE
 cds_status_t _cds_buffer_set_length(cds_buffer_data_t **self, size_t length) {
 #ifdef CDS_DEBUG
     printf(" --> [_cds_buffer_set_length]\n");
 #endif
-#ifdef CDS_USE_ALLOC_LIB
-#   ifdef CDS_DEBUG
-    printf(" <-- [_cds_buffer_set_length] realloc_lazy\n");
-#   endif
-    return _cds_buffer_realloc_lazy(self, length);
-#else
     if (length > _HEAD(self).reserved) {
 #ifdef CDS_DEBUG
         printf("[_cds_buffer_set_length] More space required\n");
 #endif
         CDS_NEW_STATUS = cds_ok;
-        CDS_IF_ERROR_RETURN_STATUS(_cds_buffer_increase_reserved(self));
+        CDS_IF_ERROR_RETURN_STATUS(_cds_buffer_grow(self, length));
         _HEAD(self).length = length;
 #ifdef CDS_DEBUG
         printf("[_cds_buffer_set_length] New length: %zu\n", _HEAD(self).length);
@@ -211,20 +622,16 @@ cds_status_t _cds_buffer_set_length(cds_buffer_data_t **self, size_t length) {
 #endif
         return status;
     } else {
+        size_t old_length = _HEAD(self).length;
         _HEAD(self).length = length;
+        if (length < old_length)
+            _cds_buffer_shrink(self, old_length, length);
 #ifdef CDS_DEBUG
         printf("[_cds_buffer_set_length] New length: %zu\n", _HEAD(self).length);
         printf(" <-- [_cds_buffer_set_length] No more space required\n");
 #endif
         return cds_ok;
     }
-#endif
-}
-
-CDS_PRIVATE
-cds_ptr_t _cds_buffer_get(cds_buffer_data_t *self, size_t index) {
-    return ((cds_byte_t *) cds_buffer_get_inner(self))
-        + (index * self->header.type_size);
 }
 
 CDS_PRIVATE
@@ -238,14 +645,71 @@ cds_status_t _cds_buffer_destroy(
             clean_element(_cds_buffer_get(*self, index));
         }
     }
+    // The buffer keeps the capacity the growth policy allows it to keep so
+    // that it can be refilled without reallocating.
     CDS_NEW_STATUS = cds_ok;
     CDS_IF_ERROR_RETURN_STATUS(_cds_buffer_set_length(self, 0));
-    CDS_IF_ERROR_RETURN_STATUS(_cds_buffer_fit(self));
+    _HEAD(self).head = 0;
     return status;
 }
 
+/**
+ * @brief Copy `count` elements from `src` into the buffer starting at a
+ * certain index. The copy is split in 2 if the destination wraps around the
+ * end of a ring buffer.
+ */
+CDS_PRIVATE
+void _cds_buffer_copy_in(
+    cds_buffer_data_t *self,
+    size_t index,
+    const cds_byte_t *src,
+    size_t count
+) {
+    if (count == 0)
+        return;
+    size_t type_size = self->header.type_size;
+    size_t slot = _cds_buffer_slot(self, index);
+    size_t first = self->header.reserved - slot;
+    if (first > count)
+        first = count;
+    cds_byte_t *start = cds_buffer_get_inner(self);
+    memcpy(start + slot * type_size, src, first * type_size);
+    memcpy(start, src + first * type_size, (count - first) * type_size);
+}
+
+/**
+ * @brief Copy `count` elements starting from a certain index in the buffer
+ * to `dest`.
+ */
+CDS_PRIVATE
+void _cds_buffer_copy_out(
+    cds_buffer_data_t *self,
+    size_t index,
+    cds_byte_t *dest,
+    size_t count
+) {
+    if (count == 0)
+        return;
+    size_t type_size = self->header.type_size;
+    size_t slot = _cds_buffer_slot(self, index);
+    size_t first = self->header.reserved - slot;
+    if (first > count)
+        first = count;
+    cds_byte_t *start = cds_buffer_get_inner(self);
+    memcpy(dest, start + slot * type_size, first * type_size);
+    memcpy(dest + first * type_size, start, (count - first) * type_size);
+}
+
+/**
+ * @brief Shift the elements from `index` onwards `count` places to the right.
+ * The buffer must be linear and have room for `count` more elements.
+ */
 CDS_PRIVATE
-cds_status_t _cds_buffer_make_gap(cds_buffer_data_t *self, size_t index) {
+cds_status_t _cds_buffer_make_gap(
+    cds_buffer_data_t *self,
+    size_t index,
+    size_t count
+) {
 #ifdef CDS_DEBUG
     printf(" --> [_cds_buffer_make_gap]\n");
 #endif
@@ -263,7 +727,7 @@ cds_status_t _cds_buffer_make_gap(cds_buffer_data_t *self, size_t index) {
     printf("[_cds_buffer_make_gap] Block size: %zu\n", block_size);
 #endif
     cds_byte_t *old_location = _cds_buffer_get(self, index);
-    cds_byte_t *new_location = old_location + self->header.type_size;
+    cds_byte_t *new_location = old_location + count * self->header.type_size;
     memmove(new_location, old_location, block_size);
 #ifdef CDS_DEBUG
     printf(" <-- [_cds_buffer_make_gap]\n");
@@ -271,116 +735,276 @@ cds_status_t _cds_buffer_make_gap(cds_buffer_data_t *self, size_t index) {
     return cds_ok;
 }
 
+/**
+ * @brief Shift the elements after the `count` elements starting at `index`
+ * to the left, overwriting those `count` elements. The buffer must be linear.
+ */
 CDS_PRIVATE
-cds_status_t _cds_buffer_close_gap(cds_buffer_data_t *self, size_t index) {
-    if (index >= self->header.length)
+cds_status_t _cds_buffer_close_gap(
+    cds_buffer_data_t *self,
+    size_t index,
+    size_t count
+) {
+    if (index + count > self->header.length)
         return cds_error;
-    size_t block_size = (self->header.length - index - 1)
+    size_t block_size = (self->header.length - index - count)
         * self->header.type_size;
     cds_byte_t *new_location = _cds_buffer_get(self, index);
-    cds_byte_t *old_location = new_location + self->header.type_size;
+    cds_byte_t *old_location = new_location + count * self->header.type_size;
     memmove(new_location, old_location, block_size);
     return cds_ok;
 }
 
 CDS_PRIVATE
-cds_status_t _cds_buffer_insert(
+cds_status_t _cds_buffer_insert_range(
     cds_buffer_data_t **self,
     size_t index,
-    cds_ptr_t src
+    const cds_byte_t *src,
+    size_t count
 ) {
 #ifdef CDS_DEBUG
-    printf(" --> [_cds_buffer_insert]\n");
+    printf(" --> [_cds_buffer_insert_range]\n");
 #endif
-    if (index > _HEAD(self).length) {
+    size_t old_length = _HEAD(self).length;
+    if (index > old_length) {
 #ifdef CDS_DEBUG
-        printf(" <-- [_cds_buffer_insert] Index out of bounds\n");
+        printf(" <-- [_cds_buffer_insert_range] Index out of bounds\n");
 #endif
         return cds_index_error;
     }
+    if (count == 0)
+        return cds_ok;
+    if (count > SIZE_MAX - old_length)
+        return cds_alloc_error;
 
     CDS_NEW_STATUS = cds_ok;
 
 #ifdef CDS_DEBUG
-    printf("[_cds_buffer_insert] Setting length\n");
+    printf("[_cds_buffer_insert_range] Setting length\n");
 #endif
     CDS_IF_ERROR_RETURN_STATUS(_cds_buffer_set_length(
         self,
-        _HEAD(self).length + 1
+        old_length + count
     ));
 #ifdef CDS_DEBUG
-    printf("[_cds_buffer_insert] Location of buffer: %p\n", *self);
+    printf("[_cds_buffer_insert_range] Location of buffer: %p\n", *self);
 #endif
+    if (_cds_buffer_is_ring(*self) && index == 0 && old_length > 0) {
+        // Ring buffers grow towards the front by moving the head backwards.
+        size_t head = _HEAD(self).head;
+        _HEAD(self).head = head >= count
+            ? head - count
+            : head + _HEAD(self).reserved - count;
+    } else if (index < old_length) {
 #ifdef CDS_DEBUG
-    printf("[_cds_buffer_insert] Making gap\n");
+        printf("[_cds_buffer_insert_range] Making gap\n");
 #endif
-    --(_HEAD(self).length);
-    CDS_IF_ERROR_RETURN_STATUS(_cds_buffer_make_gap(*self, index));
-    ++(_HEAD(self).length);
+        _cds_buffer_linearize(*self);
+        _HEAD(self).length = old_length;
+        status = _cds_buffer_make_gap(*self, index, count);
+        _HEAD(self).length = old_length + count;
+        CDS_IF_ERROR_RETURN_STATUS(status);
+    }
 #ifdef CDS_DEBUG
-    printf("[_cds_buffer_insert] Copying new element into buffer\n");
+    printf("[_cds_buffer_insert_range] Copying new elements into buffer\n");
 #endif
-    memcpy(_cds_buffer_get(*self, index), src, _HEAD(self).type_size);
+    _cds_buffer_copy_in(*self, index, src, count);
 
 #ifdef CDS_DEBUG
-    printf(" <-- [_cds_buffer_insert]\n");
+    printf(" <-- [_cds_buffer_insert_range]\n");
 #endif
     return status;
 }
 
 CDS_PRIVATE
-cds_status_t _cds_buffer_remove(
+cds_status_t _cds_buffer_remove_range(
     cds_buffer_data_t **self,
     size_t index,
-    cds_ptr_t dest
+    size_t count,
+    cds_byte_t *dest
 ) {
-    if (index >= _HEAD(self).length) {
+    size_t length = _HEAD(self).length;
+    if (index > length || count > length - index) {
         return cds_index_error;
     }
+    if (count == 0)
+        return cds_ok;
     CDS_NEW_STATUS = cds_ok;
     if (dest != NULL) {
-        memcpy(dest, _cds_buffer_get(*self, index), _HEAD(self).type_size);
+        _cds_buffer_copy_out(*self, index, dest, count);
+    }
+    if (count == length) {
+        _HEAD(self).head = 0;
+    } else if (_cds_buffer_is_ring(*self) && index == 0) {
+        // Ring buffers shrink from the front by moving the head forwards.
+        _HEAD(self).head = _cds_buffer_slot(*self, count);
+    } else if (index + count < length) {
+        _cds_buffer_linearize(*self);
+        CDS_IF_ERROR_RETURN_STATUS(_cds_buffer_close_gap(*self, index, count));
     }
-    CDS_IF_ERROR_RETURN_STATUS(_cds_buffer_close_gap(*self, index));
     CDS_IF_ERROR_RETURN_STATUS(_cds_buffer_set_length(
         self,
-        _HEAD(self).length - 1
+        length - count
     ));
     return status;
 }
 
-CDS_PUBLIC
-size_t cds_buffer_required_bytes(cds_buffer_data_t *self, size_t length) {
-    if (self == NULL)
-        return cds_null_error;
-    else
-        return _cds_buffer_required_bytes(self, length);
+CDS_PRIVATE
+cds_status_t _cds_buffer_insert(
+    cds_buffer_data_t **self,
+    size_t index,
+    cds_ptr_t src
+) {
+    return _cds_buffer_insert_range(self, index, src, 1);
 }
 
-CDS_PUBLIC
-cds_buffer_t cds_buffer_new(void) {
-#ifdef CDS_DEBUG
-    printf(" --> [cds_buffer_new]\n");
-#endif
-    cds_buffer_data_t *self = malloc(sizeof(cds_buffer_data_t));
-#ifdef CDS_DEBUG
-    printf("[cds_buffer_new] Malloced!\n");
-#endif
-    if (self == NULL) {
-#ifdef CDS_DEBUG
-        printf(" <-- [cds_buffer_new] Failed!\n");
-#endif
+CDS_PRIVATE
+cds_status_t _cds_buffer_remove(
+    cds_buffer_data_t **self,
+    size_t index,
+    cds_ptr_t dest
+) {
+    return _cds_buffer_remove_range(self, index, 1, dest);
+}
+
+CDS_PRIVATE
+cds_status_t _cds_buffer_swap_remove(
+    cds_buffer_data_t **self,
+    size_t index,
+    cds_ptr_t dest
+) {
+    size_t length = _HEAD(self).length;
+    if (index >= length)
+        return cds_index_error;
+    size_t type_size = _HEAD(self).type_size;
+    cds_ptr_t element = _cds_buffer_get(*self, index);
+    if (dest != NULL)
+        memcpy(dest, element, type_size);
+    if (index != length - 1)
+        memcpy(element, _cds_buffer_get(*self, length - 1), type_size);
+    return _cds_buffer_set_length(self, length - 1);
+}
+
+/**
+ * @brief Compact the buffer in one pass, keeping the elements for which
+ * `predicate` returns `keep`.
+ */
+CDS_PRIVATE
+cds_status_t _cds_buffer_filter(
+    cds_buffer_data_t **self,
+    cds_predicate_f predicate,
+    cds_ptr_t context,
+    bool keep,
+    cds_free_f clean_element
+) {
+    size_t length = _HEAD(self).length;
+    size_t type_size = _HEAD(self).type_size;
+    size_t read = 0;
+    size_t write = 0;
+    for (; read < length; ++read) {
+        cds_ptr_t element = _cds_buffer_get(*self, read);
+        if (predicate(element, context) == keep) {
+            // Elements before the first discarded one stay where they are.
+            if (write != read)
+                memcpy(_cds_buffer_get(*self, write), element, type_size);
+            ++write;
+        } else if (clean_element != NULL) {
+            clean_element(element);
+        }
+    }
+    if (write == length)
+        return cds_ok;
+    if (write == 0)
+        _HEAD(self).head = 0;
+    return _cds_buffer_set_length(self, write);
+}
+
+/**
+ * @brief Binary search a sorted buffer, accessing the elements through
+ * `_cds_buffer_get` so that wrapped ring buffers can be searched in place.
+ * Returns the first element not lesser than `key`, or the first element
+ * greater than `key` if `upper` is true.
+ */
+CDS_PRIVATE
+size_t _cds_buffer_bound(
+    cds_buffer_data_t *self,
+    cds_ptr_t key,
+    cds_compare_f compare,
+    bool upper
+) {
+    size_t first = 0;
+    size_t length = self->header.length;
+    while (length > 0) {
+        size_t half = length / 2;
+        cds_ptr_t element = _cds_buffer_get(self, first + half);
+        bool go_right = upper
+            ? compare(key, element) >= 0
+            : compare(element, key) < 0;
+        if (go_right) {
+            first += half + 1;
+            length -= half + 1;
+        } else {
+            length = half;
+        }
+    }
+    return first;
+}
+
+CDS_PUBLIC
+size_t cds_buffer_required_bytes(cds_buffer_data_t *self, size_t length) {
+    if (self == NULL)
+        return cds_null_error;
+    else
+        return _cds_buffer_required_bytes(self, length);
+}
+
+CDS_PUBLIC
+cds_buffer_t cds_buffer_new(void) {
+    return cds_buffer_new_with_allocator(NULL);
+}
+
+CDS_PUBLIC
+cds_buffer_t cds_buffer_new_with_allocator(const cds_allocator_t *allocator) {
+#ifdef CDS_DEBUG
+    printf(" --> [cds_buffer_new]\n");
+#endif
+    cds_buffer_data_t *self = cds_allocator_alloc(
+        allocator,
+        sizeof(cds_buffer_data_t)
+    );
+#ifdef CDS_DEBUG
+    printf("[cds_buffer_new] Malloced!\n");
+#endif
+    if (self == NULL) {
+#ifdef CDS_DEBUG
+        printf(" <-- [cds_buffer_new] Failed!\n");
+#endif
         return NULL;
     }
 #ifdef CDS_DEBUG
     printf(" <-- [cds_buffer_new] Returning...\n");
 #endif
-    self->header.bytes_allocated = 0;
+    self->header.bytes_allocated = sizeof(cds_buffer_data_t);
+    self->header.allocator = allocator;
+    self->header.alignment = 0;
+    self->header.padding = 0;
+    self->header.flags = 0;
+    self->header.fd = -1;
+    self->header.refcount = 1;
     return cds_buffer_get_inner(self);
 }
 
 CDS_PUBLIC
 cds_status_t cds_buffer_init(cds_buffer_t *buffer, size_t type_size) {
+    return cds_buffer_init_with_policy(buffer, type_size, NULL);
+}
+
+CDS_PUBLIC
+cds_status_t cds_buffer_init_with_policy(
+    cds_buffer_t *buffer,
+    size_t type_size,
+    const cds_growth_policy_t *policy
+) {
 #ifdef CDS_DEBUG
     printf(" --> [cds_buffer_init]\n");
 #endif
@@ -391,9 +1015,18 @@ cds_status_t cds_buffer_init(cds_buffer_t *buffer, size_t type_size) {
     printf("[cds_buffer_init] NULL pointer checks successful\n");
 #endif
     cds_buffer_data_t *self = cds_buffer_get_data(*buffer);
+    // The other owners keep the old elements.
+    if (CDS_IS_ERROR(_cds_buffer_make_unique(&self, false)))
+        return cds_alloc_error;
+    *buffer = cds_buffer_get_inner(self);
     self->header.type_size = type_size;
     self->header.length = 0;
     self->header.reserved = 0;
+    self->header.policy = policy;
+    self->header.head = 0;
+    // Whether the buffer is memory-mapped is not up to the caller.
+    self->header.flags &= cds_buffer_mapped | cds_buffer_mapped_shared;
+    self->header.shrinks_avoided = 0;
 #ifdef CDS_DEBUG
     printf(" <-- [cds_buffer_init] Setting everything to 0\n");
 #endif
@@ -402,12 +1035,65 @@ cds_status_t cds_buffer_init(cds_buffer_t *buffer, size_t type_size) {
     return cds_ok;
 }
 
+CDS_PUBLIC
+cds_status_t cds_buffer_init_aligned(
+    cds_buffer_t *buffer,
+    size_t type_size,
+    size_t alignment
+) {
+    CDS_IF_ZERO_RETURN_ERROR(alignment);
+    if (alignment > CDS_BUFFER_MAX_ALIGNMENT
+        || (alignment & (alignment - 1)) != 0)
+        return cds_error;
+    CDS_NEW_STATUS = cds_ok;
+    CDS_IF_ERROR_RETURN_STATUS(cds_buffer_init(buffer, type_size));
+    cds_buffer_data_t *self = cds_buffer_get_data(*buffer);
+    // Move the header so that the elements after it are aligned.
+    CDS_IF_ERROR_RETURN_STATUS(_cds_buffer_move_data(
+        &self,
+        self->header.allocator,
+        alignment
+    )) else {
+        *buffer = cds_buffer_get_inner(self);
+    }
+    return status;
+}
+
+CDS_PUBLIC
+cds_status_t cds_buffer_init_with_allocator(
+    cds_buffer_t *buffer,
+    size_t type_size,
+    const cds_allocator_t *allocator
+) {
+    CDS_NEW_STATUS = cds_ok;
+    CDS_IF_ERROR_RETURN_STATUS(cds_buffer_init(buffer, type_size));
+    cds_buffer_data_t *self = cds_buffer_get_data(*buffer);
+    if (self->header.allocator == allocator)
+        return cds_ok;
+    // Move the (empty) buffer into memory owned by the new allocator.
+    CDS_IF_ERROR_RETURN_STATUS(_cds_buffer_move_data(
+        &self,
+        allocator,
+        self->header.alignment
+    )) else {
+        *buffer = cds_buffer_get_inner(self);
+    }
+    return status;
+}
+
 CDS_PUBLIC
 cds_status_t cds_buffer_destroy(cds_buffer_t *buffer, cds_free_f clean_element) {
     CDS_IF_NULL_RETURN_ERROR(buffer);
     cds_buffer_data_t *self;
     _VALIDATE_BUF(*buffer);
     CDS_IF_NULL_RETURN_ERROR(self);
+    if (_cds_buffer_refcount(self) > 1) {
+        // The other owners still use the elements, so they are not cleaned.
+        if (CDS_IS_ERROR(_cds_buffer_make_unique(&self, false)))
+            return cds_alloc_error;
+        *buffer = cds_buffer_get_inner(self);
+        return cds_ok;
+    }
     CDS_NEW_STATUS = cds_ok;
     if (!CDS_IS_ERROR(_cds_buffer_destroy(&self, clean_element))) {
         *buffer = cds_buffer_get_inner(self);
@@ -418,18 +1104,128 @@ cds_status_t cds_buffer_destroy(cds_buffer_t *buffer, cds_free_f clean_element)
 CDS_PUBLIC
 cds_status_t cds_buffer_free(cds_buffer_t buffer, cds_free_f clean_element) {
     CDS_NEW_STATUS = cds_ok;
+    cds_buffer_data_t *self = cds_buffer_get_data(buffer);
+    if (self != NULL
+        && _cds_buffer_refcount(self) > 1
+        && !_cds_buffer_release(self))
+        return cds_ok;
+    if (self != NULL && _cds_buffer_is_mapped(self)) {
+        // The elements stay in the file.
+        _cds_buffer_free_data(self);
+        return cds_ok;
+    }
     CDS_IF_ERROR_RETURN_STATUS(cds_buffer_destroy(&buffer, clean_element));
-    free(cds_buffer_get_data(buffer));
+    _cds_buffer_free_data(cds_buffer_get_data(buffer));
     return status;
 }
 
+CDS_PUBLIC
+cds_buffer_t cds_buffer_share(cds_buffer_t buffer) {
+    cds_buffer_data_t *self = cds_buffer_get_data(buffer);
+    if (self == NULL || _cds_buffer_is_mapped(self))
+        return NULL;
+#ifdef __GNUC__
+    __atomic_add_fetch(&self->header.refcount, 1, __ATOMIC_RELAXED);
+#else
+    ++(self->header.refcount);
+#endif
+    return buffer;
+}
+
+CDS_PUBLIC
+bool cds_buffer_is_shared(cds_buffer_t buffer) {
+    cds_buffer_data_t *self = cds_buffer_get_data(buffer);
+    return self != NULL && _cds_buffer_refcount(self) > 1;
+}
+
+CDS_PUBLIC
+cds_status_t cds_buffer_make_unique(cds_buffer_t *buffer) {
+    CDS_IF_NULL_RETURN_ERROR(buffer);
+    cds_buffer_data_t *self;
+    _VALIDATE_BUF(*buffer);
+    _UNIQUE_BUF(buffer);
+    return cds_ok;
+}
+
+CDS_PUBLIC
+cds_status_t cds_buffer_swap(cds_buffer_t *buffer, cds_buffer_t *other) {
+    CDS_IF_NULL_RETURN_ERROR(buffer);
+    CDS_IF_NULL_RETURN_ERROR(other);
+    CDS_IF_NULL_RETURN_ERROR(*buffer);
+    CDS_IF_NULL_RETURN_ERROR(*other);
+    cds_buffer_t swap = *buffer;
+    *buffer = *other;
+    *other = swap;
+    return cds_ok;
+}
+
+CDS_PUBLIC
+cds_status_t cds_buffer_append_move(cds_buffer_t *buffer, cds_buffer_t *other) {
+    CDS_IF_NULL_RETURN_ERROR(buffer);
+    CDS_IF_NULL_RETURN_ERROR(other);
+    cds_buffer_data_t *self;
+    _VALIDATE_BUF(*buffer);
+    CDS_IF_NULL_RETURN_ERROR(*other);
+    cds_buffer_data_t *source = cds_buffer_get_data(*other);
+    if (self == source || _HEAD(&self).type_size != source->header.type_size)
+        return cds_error;
+    size_t count = source->header.length;
+    if (count == 0)
+        return cds_ok;
+    if (_HEAD(&self).length == 0
+        && !_cds_buffer_is_mapped(self)
+        && !_cds_buffer_is_mapped(source))
+        return cds_buffer_swap(buffer, other);
+    if (count > SIZE_MAX - _HEAD(&self).length)
+        return cds_alloc_error;
+    _UNIQUE_BUF(buffer);
+    CDS_NEW_STATUS = cds_ok;
+    // Grow once for both halves, following the growth policy so that
+    // appending many buffers one after the other stays linear.
+    if (_HEAD(&self).length + count > _HEAD(&self).reserved) {
+        CDS_IF_ERROR_RETURN_STATUS(
+            _cds_buffer_grow(&self, _HEAD(&self).length + count)
+        ) else {
+            *buffer = cds_buffer_get_inner(self);
+        }
+    }
+    // The elements of a ring buffer may wrap around the end of its block.
+    size_t head = source->header.head;
+    size_t first = source->header.reserved - head;
+    if (first > count)
+        first = count;
+    CDS_IF_ERROR_RETURN_STATUS(_cds_buffer_insert_range(
+        &self,
+        _HEAD(&self).length,
+        (cds_byte_t *) *other + head * source->header.type_size,
+        first
+    ));
+    if (first < count) {
+        CDS_IF_ERROR_RETURN_STATUS(_cds_buffer_insert_range(
+            &self,
+            _HEAD(&self).length,
+            *other,
+            count - first
+        ));
+    }
+    *buffer = cds_buffer_get_inner(self);
+    // A shared buffer is detached from the other owners instead of having
+    // its elements copied just to be thrown away.
+    if (_cds_buffer_refcount(source) > 1)
+        return cds_buffer_destroy(other, NULL);
+    return cds_buffer_resize_uninit(other, 0);
+}
+
 CDS_PUBLIC
 cds_status_t cds_buffer_reserve(cds_buffer_t *buffer, size_t amount) {
     CDS_IF_NULL_RETURN_ERROR(buffer);
     cds_buffer_data_t *self;
     _VALIDATE_BUF(*buffer);
+    _UNIQUE_BUF(buffer);
     CDS_IF_NULL_RETURN_ERROR(self);
 
+    if (amount > SIZE_MAX - self->header.length)
+        return cds_alloc_error;
     size_t needed = self->header.length + amount;
     CDS_NEW_STATUS = cds_ok;
     CDS_IF_ERROR_RETURN_STATUS(_cds_buffer_reserve(&self, needed)) else {
@@ -443,6 +1239,7 @@ cds_status_t cds_buffer_compact(cds_buffer_t *buffer) {
     CDS_IF_NULL_RETURN_ERROR(buffer);
     cds_buffer_data_t *self;
     _VALIDATE_BUF(*buffer);
+    _UNIQUE_BUF(buffer);
     CDS_IF_NULL_RETURN_ERROR(self);
 
     CDS_NEW_STATUS = cds_ok;
@@ -462,6 +1259,7 @@ cds_status_t cds_buffer_insert(
     CDS_IF_NULL_RETURN_ERROR(src);
     cds_buffer_data_t *self;
     _VALIDATE_BUF(*buffer);
+    _UNIQUE_BUF(buffer);
     CDS_IF_NULL_RETURN_ERROR(self);
     CDS_NEW_STATUS = _cds_buffer_insert(&self, index, src);
     CDS_IF_ERROR_RETURN_STATUS(status) else {
@@ -484,6 +1282,7 @@ cds_status_t cds_buffer_push_back(cds_buffer_t *buffer, cds_ptr_t src) {
     CDS_IF_NULL_RETURN_ERROR(src);
     cds_buffer_data_t *self;
     _VALIDATE_BUF(*buffer);
+    _UNIQUE_BUF(buffer);
     CDS_IF_NULL_RETURN_ERROR(self);
 #ifdef CDS_DEBUG
     printf("[cds_buffer_push_back] Validation checks successful\n");
@@ -500,6 +1299,37 @@ cds_status_t cds_buffer_push_back(cds_buffer_t *buffer, cds_ptr_t src) {
     return status;
 }
 
+CDS_PUBLIC
+cds_ptr_t cds_buffer_emplace_back(cds_buffer_t *buffer) {
+    if (buffer == NULL)
+        return NULL;
+    cds_buffer_data_t *self = cds_buffer_get_data(*buffer);
+    if (self == NULL || CDS_IS_ERROR(_cds_buffer_make_unique(&self, true)))
+        return NULL;
+    *buffer = cds_buffer_get_inner(self);
+    size_t length = self->header.length;
+    if (length == SIZE_MAX
+        || CDS_IS_ERROR(_cds_buffer_set_length(&self, length + 1)))
+        return NULL;
+    *buffer = cds_buffer_get_inner(self);
+    return _cds_buffer_get(self, length);
+}
+
+CDS_PUBLIC
+cds_status_t cds_buffer_resize_uninit(cds_buffer_t *buffer, size_t length) {
+    CDS_IF_NULL_RETURN_ERROR(buffer);
+    cds_buffer_data_t *self;
+    _VALIDATE_BUF(*buffer);
+    _UNIQUE_BUF(buffer);
+    CDS_NEW_STATUS = cds_ok;
+    CDS_IF_ERROR_RETURN_STATUS(_cds_buffer_set_length(&self, length)) else {
+        *buffer = cds_buffer_get_inner(self);
+    }
+    if (length == 0)
+        self->header.head = 0;
+    return status;
+}
+
 CDS_PUBLIC
 cds_status_t cds_buffer_remove(
     cds_buffer_t *buffer,
@@ -509,6 +1339,7 @@ cds_status_t cds_buffer_remove(
     CDS_IF_NULL_RETURN_ERROR(buffer);
     cds_buffer_data_t *self;
     _VALIDATE_BUF(*buffer);
+    _UNIQUE_BUF(buffer);
     CDS_IF_NULL_RETURN_ERROR(self);
     CDS_NEW_STATUS = cds_ok;
     CDS_IF_ERROR_RETURN_STATUS(_cds_buffer_remove(&self, index, dest)) else {
@@ -527,6 +1358,7 @@ cds_status_t cds_buffer_pop_back(cds_buffer_t *buffer, cds_ptr_t dest) {
     CDS_IF_NULL_RETURN_ERROR(buffer);
     cds_buffer_data_t *self;
     _VALIDATE_BUF(*buffer);
+    _UNIQUE_BUF(buffer);
     CDS_IF_NULL_RETURN_ERROR(self);
     CDS_NEW_STATUS = cds_ok;
     CDS_IF_ERROR_RETURN_STATUS(_cds_buffer_remove(
@@ -538,3 +1370,414 @@ cds_status_t cds_buffer_pop_back(cds_buffer_t *buffer, cds_ptr_t dest) {
     }
     return status;
 }
+
+CDS_PUBLIC
+cds_status_t cds_buffer_swap_remove(
+    cds_buffer_t *buffer,
+    size_t index,
+    cds_ptr_t dest
+) {
+    CDS_IF_NULL_RETURN_ERROR(buffer);
+    cds_buffer_data_t *self;
+    _VALIDATE_BUF(*buffer);
+    _UNIQUE_BUF(buffer);
+    CDS_IF_NULL_RETURN_ERROR(self);
+    CDS_NEW_STATUS = cds_ok;
+    CDS_IF_ERROR_RETURN_STATUS(_cds_buffer_swap_remove(
+        &self,
+        index,
+        dest
+    )) else {
+        *buffer = cds_buffer_get_inner(self);
+    }
+    return status;
+}
+
+CDS_PUBLIC
+cds_status_t cds_buffer_retain(
+    cds_buffer_t *buffer,
+    cds_predicate_f predicate,
+    cds_ptr_t context,
+    cds_free_f clean_element
+) {
+    CDS_IF_NULL_RETURN_ERROR(buffer);
+    CDS_IF_NULL_RETURN_ERROR(predicate);
+    cds_buffer_data_t *self;
+    _VALIDATE_BUF(*buffer);
+    _UNIQUE_BUF(buffer);
+    CDS_IF_NULL_RETURN_ERROR(self);
+    CDS_NEW_STATUS = cds_ok;
+    CDS_IF_ERROR_RETURN_STATUS(_cds_buffer_filter(
+        &self,
+        predicate,
+        context,
+        true,
+        clean_element
+    )) else {
+        *buffer = cds_buffer_get_inner(self);
+    }
+    return status;
+}
+
+CDS_PUBLIC
+cds_status_t cds_buffer_remove_if(
+    cds_buffer_t *buffer,
+    cds_predicate_f predicate,
+    cds_ptr_t context,
+    cds_free_f clean_element
+) {
+    CDS_IF_NULL_RETURN_ERROR(buffer);
+    CDS_IF_NULL_RETURN_ERROR(predicate);
+    cds_buffer_data_t *self;
+    _VALIDATE_BUF(*buffer);
+    _UNIQUE_BUF(buffer);
+    CDS_IF_NULL_RETURN_ERROR(self);
+    CDS_NEW_STATUS = cds_ok;
+    CDS_IF_ERROR_RETURN_STATUS(_cds_buffer_filter(
+        &self,
+        predicate,
+        context,
+        false,
+        clean_element
+    )) else {
+        *buffer = cds_buffer_get_inner(self);
+    }
+    return status;
+}
+
+CDS_PUBLIC
+cds_ptr_t cds_buffer_get(cds_buffer_t buffer, size_t index) {
+    cds_buffer_data_t *self = cds_buffer_get_data(buffer);
+    if (self == NULL || index >= self->header.length)
+        return NULL;
+    return _cds_buffer_get(self, index);
+}
+
+CDS_PUBLIC
+bool cds_buffer_is_ring(cds_buffer_t buffer) {
+    cds_buffer_data_t *self = cds_buffer_get_data(buffer);
+    return self != NULL && _cds_buffer_is_ring(self);
+}
+
+CDS_PUBLIC
+cds_status_t cds_buffer_set_ring(cds_buffer_t *buffer, bool enabled) {
+    CDS_IF_NULL_RETURN_ERROR(buffer);
+    cds_buffer_data_t *self;
+    _VALIDATE_BUF(*buffer);
+    _UNIQUE_BUF(buffer);
+    if (enabled) {
+        self->header.flags |= cds_buffer_ring;
+    } else {
+        _cds_buffer_linearize(self);
+        self->header.flags &= ~((cds_flag_t) cds_buffer_ring);
+    }
+    return cds_ok;
+}
+
+CDS_PUBLIC
+cds_status_t cds_buffer_linearize(cds_buffer_t *buffer) {
+    CDS_IF_NULL_RETURN_ERROR(buffer);
+    cds_buffer_data_t *self;
+    _VALIDATE_BUF(*buffer);
+    _UNIQUE_BUF(buffer);
+    _cds_buffer_linearize(self);
+    return cds_ok;
+}
+
+CDS_PUBLIC
+cds_status_t cds_buffer_extend(
+    cds_buffer_t *buffer,
+    cds_ptr_t src,
+    size_t count
+) {
+    CDS_IF_NULL_RETURN_ERROR(buffer);
+    CDS_IF_NULL_RETURN_ERROR(src);
+    cds_buffer_data_t *self;
+    _VALIDATE_BUF(*buffer);
+    _UNIQUE_BUF(buffer);
+    CDS_NEW_STATUS = _cds_buffer_insert_range(
+        &self,
+        self->header.length,
+        src,
+        count
+    );
+    CDS_IF_ERROR_RETURN_STATUS(status) else {
+        *buffer = cds_buffer_get_inner(self);
+    }
+    return status;
+}
+
+CDS_PUBLIC
+cds_status_t cds_buffer_insert_range(
+    cds_buffer_t *buffer,
+    size_t index,
+    cds_ptr_t src,
+    size_t count
+) {
+    CDS_IF_NULL_RETURN_ERROR(buffer);
+    CDS_IF_NULL_RETURN_ERROR(src);
+    cds_buffer_data_t *self;
+    _VALIDATE_BUF(*buffer);
+    _UNIQUE_BUF(buffer);
+    CDS_NEW_STATUS = _cds_buffer_insert_range(&self, index, src, count);
+    CDS_IF_ERROR_RETURN_STATUS(status) else {
+        *buffer = cds_buffer_get_inner(self);
+    }
+    return status;
+}
+
+CDS_PUBLIC
+cds_status_t cds_buffer_remove_range(
+    cds_buffer_t *buffer,
+    size_t index,
+    size_t count,
+    cds_ptr_t dest
+) {
+    CDS_IF_NULL_RETURN_ERROR(buffer);
+    cds_buffer_data_t *self;
+    _VALIDATE_BUF(*buffer);
+    _UNIQUE_BUF(buffer);
+    CDS_NEW_STATUS = cds_ok;
+    CDS_IF_ERROR_RETURN_STATUS(_cds_buffer_remove_range(
+        &self,
+        index,
+        count,
+        dest
+    )) else {
+        *buffer = cds_buffer_get_inner(self);
+    }
+    return status;
+}
+
+CDS_PUBLIC
+cds_status_t cds_buffer_sort(cds_buffer_t *buffer, cds_compare_f compare) {
+    CDS_IF_NULL_RETURN_ERROR(buffer);
+    CDS_IF_NULL_RETURN_ERROR(compare);
+    cds_buffer_data_t *self;
+    _VALIDATE_BUF(*buffer);
+    _UNIQUE_BUF(buffer);
+    _cds_buffer_linearize(self);
+    return cds_sort(
+        *buffer,
+        self->header.length,
+        self->header.type_size,
+        compare
+    );
+}
+
+CDS_PUBLIC
+size_t cds_buffer_lower_bound(
+    cds_buffer_t buffer,
+    cds_ptr_t key,
+    cds_compare_f compare
+) {
+    cds_buffer_data_t *self = cds_buffer_get_data(buffer);
+    if (self == NULL || compare == NULL)
+        return 0;
+    return _cds_buffer_bound(self, key, compare, false);
+}
+
+CDS_PUBLIC
+size_t cds_buffer_upper_bound(
+    cds_buffer_t buffer,
+    cds_ptr_t key,
+    cds_compare_f compare
+) {
+    cds_buffer_data_t *self = cds_buffer_get_data(buffer);
+    if (self == NULL || compare == NULL)
+        return 0;
+    return _cds_buffer_bound(self, key, compare, true);
+}
+
+#define _CDS_BUFFER_RADIX_SORT_DEFINE(stn, ltn) \
+    CDS_PUBLIC cds_status_t \
+    cds_buffer_radix_sort_##stn(cds_buffer_t *buffer, size_t key_offset) { \
+        CDS_IF_NULL_RETURN_ERROR(buffer); \
+        cds_buffer_data_t *self; \
+        _VALIDATE_BUF(*buffer); \
+        _UNIQUE_BUF(buffer); \
+        _cds_buffer_linearize(self); \
+        return CDS_SMASH_PUBLIC(stn, radix_sort)( \
+            *buffer, \
+            self->header.length, \
+            self->header.type_size, \
+            key_offset \
+        ); \
+    }
+
+CDS_INTEGER_TYPES(_CDS_BUFFER_RADIX_SORT_DEFINE)
+
+#undef _CDS_BUFFER_RADIX_SORT_DEFINE
+
+CDS_PUBLIC
+cds_buffer_t cds_buffer_map_file(
+    const char *path,
+    size_t type_size,
+    cds_flag_t flags
+) {
+#ifdef CDS_HAVE_MMAP
+    if (path == NULL || type_size == 0)
+        return NULL;
+    bool writable = (flags & cds_buffer_map_writable) != 0;
+    bool create = (flags & cds_buffer_map_create) != 0;
+    if (create && !writable)
+        return NULL;
+    size_t page = (size_t) sysconf(_SC_PAGESIZE);
+    int fd = open(
+        path,
+        writable ? (O_RDWR | (create ? O_CREAT : 0)) : O_RDONLY,
+        0666
+    );
+    if (fd < 0)
+        return NULL;
+    struct stat info;
+    if (fstat(fd, &info) != 0)
+        goto failed;
+    size_t bytes = (size_t) info.st_size;
+    cds_buffer_file_header_t file;
+    if (bytes == 0) {
+        // An empty file becomes an empty buffer whose header takes a page.
+        if (!writable)
+            goto failed;
+        cds_buffer_file_header_t empty = {
+            .magic = CDS_BUFFER_FILE_MAGIC,
+            .version = CDS_BUFFER_FILE_VERSION,
+            .endian_marker = CDS_SERIAL_ENDIAN_MARKER,
+            .header_size = page,
+            .type_size = type_size,
+            .length = 0,
+            .head = 0,
+            .flags = 0
+        };
+        file = empty;
+        bytes = page;
+        if (pwrite(fd, &file, sizeof(file), 0) != (ssize_t) sizeof(file)
+            || ftruncate(fd, (off_t) bytes) != 0)
+            goto failed;
+    } else if (bytes < sizeof(file)
+        || pread(fd, &file, sizeof(file), 0) != (ssize_t) sizeof(file)) {
+        goto failed;
+    }
+    if (file.magic != CDS_BUFFER_FILE_MAGIC
+        || file.version != CDS_BUFFER_FILE_VERSION
+        || file.endian_marker != CDS_SERIAL_ENDIAN_MARKER
+        || file.type_size != type_size
+        || file.header_size < sizeof(file)
+        || file.header_size < sizeof(cds_buffer_header_t)
+        || file.header_size % page != 0
+        || file.header_size > bytes)
+        goto failed;
+    size_t offset = (size_t) file.header_size;
+    size_t reserved = (bytes - offset) / type_size;
+    if (file.length > reserved
+        || (reserved > 0 ? file.head >= reserved : file.head != 0))
+        goto failed;
+    // Read-only buffers are private copy-on-write mappings, so they can still
+    // be modified in memory without touching the file.
+    cds_buffer_data_t *self = _cds_buffer_map_region(
+        fd,
+        offset,
+        bytes - offset,
+        writable
+    );
+    if (self == NULL)
+        goto failed;
+    memset(&self->header, 0, sizeof(cds_buffer_header_t));
+    self->header.type_size = type_size;
+    self->header.length = (size_t) file.length;
+    self->header.reserved = reserved;
+    self->header.bytes_allocated = sizeof(cds_buffer_header_t)
+        + bytes - offset;
+    self->header.head = (size_t) file.head;
+    self->header.padding = offset - sizeof(cds_buffer_header_t);
+    self->header.fd = fd;
+    self->header.refcount = 1;
+    self->header.flags = (file.flags & cds_buffer_ring)
+        | cds_buffer_mapped
+        | (writable ? cds_buffer_mapped_shared : 0);
+    return cds_buffer_get_inner(self);
+
+    failed:
+    close(fd);
+    return NULL;
+#else
+    return NULL;
+#endif
+}
+
+CDS_PUBLIC
+cds_status_t cds_buffer_sync(cds_buffer_t buffer) {
+    cds_buffer_data_t *self;
+    _VALIDATE_BUF(buffer);
+    if (!_cds_buffer_is_mapped(self))
+        return cds_error;
+    if ((self->header.flags & cds_buffer_mapped_shared) == 0)
+        return cds_ok;
+#ifdef CDS_HAVE_MMAP
+    size_t data_bytes = self->header.bytes_allocated
+        - sizeof(cds_buffer_header_t);
+    if (CDS_IS_ERROR(_cds_buffer_write_file_header(self))
+        || (data_bytes > 0 && msync(buffer, data_bytes, MS_SYNC) != 0)
+        || fsync(self->header.fd) != 0)
+        return cds_error;
+    return cds_ok;
+#else
+    return cds_error;
+#endif
+}
+
+CDS_PUBLIC
+bool cds_buffer_is_mapped(cds_buffer_t buffer) {
+    cds_buffer_data_t *self = cds_buffer_get_data(buffer);
+    return self != NULL && _cds_buffer_is_mapped(self);
+}
+
+CDS_PUBLIC
+cds_status_t cds_buffer_write(cds_buffer_t buffer, FILE *file) {
+    cds_buffer_data_t *self;
+    _VALIDATE_BUF(buffer);
+    // The buffer may be shared with readers on other threads, so the 2
+    // halves of a wrapped ring are written where they are.
+    size_t type_size = self->header.type_size;
+    size_t length = self->header.length;
+    size_t first = self->header.reserved - self->header.head;
+    if (first > length)
+        first = length;
+    return cds_serial_write_split(
+        file,
+        (cds_byte_t *) buffer + self->header.head * type_size,
+        first,
+        buffer,
+        length - first,
+        type_size
+    );
+}
+
+CDS_PUBLIC
+cds_status_t cds_buffer_read(cds_buffer_t *buffer, FILE *file) {
+    CDS_IF_NULL_RETURN_ERROR(buffer);
+    cds_buffer_data_t *self;
+    _VALIDATE_BUF(*buffer);
+    _UNIQUE_BUF(buffer);
+    CDS_NEW_STATUS = cds_ok;
+    cds_serial_header_t header;
+    // Drop the old elements without shrinking, so that the memory can be
+    // reused for the new ones.
+    self->header.length = 0;
+    self->header.head = 0;
+    CDS_IF_ERROR_RETURN_STATUS(cds_serial_read_header(
+        file,
+        self->header.type_size,
+        &header
+    ));
+    CDS_IF_ERROR_RETURN_STATUS(_cds_buffer_set_length(
+        &self,
+        (size_t) header.length
+    )) else {
+        *buffer = cds_buffer_get_inner(self);
+    }
+    CDS_IF_STATUS_ERROR(cds_serial_read_elements(file, &header, *buffer)) {
+        self->header.length = 0;
+    }
+    return status;
+}
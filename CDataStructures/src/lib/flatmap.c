@@ -0,0 +1,436 @@
+#include <string.h>
+#include <CDataStructures/flatmap.h>
+
+/**
+ * @brief Runs of this many entries are insertion sorted before they are
+ * merged.
+ */
+#define _CDS_FLATMAP_RUN 16
+
+#define _SIZE(self) ((self)->entries.type_size)
+#define _AT(self, base, index) ((base) + (index) * _SIZE(self))
+#define _ROUND_UP(a, b) (((a) + (b) - 1) / (b) * (b))
+#define _VALIDATE_MAP(self) \
+    CDS_IF_NULL_RETURN_ERROR(self); \
+    CDS_IF_NULL_RETURN_ERROR((self)->entries.buffer);
+
+/**
+ * @brief Guess the alignment of a type from its size, which is the largest
+ * power of 2 dividing the size, up to 16.
+ */
+CDS_INLINE size_t _cds_flatmap_alignment(size_t size) {
+    size_t alignment = size & (~size + 1);
+    if (alignment == 0)
+        return 1;
+    return alignment > 16 ? 16 : alignment;
+}
+
+/**
+ * @brief Write the keys and values into consecutive entries starting at
+ * `base`.
+ */
+CDS_PRIVATE
+void _cds_flatmap_fill(
+    cds_flatmap_t *self,
+    cds_byte_t *base,
+    const cds_byte_t *keys,
+    const cds_byte_t *values,
+    size_t count
+) {
+    size_t index = 0;
+    for (; index < count; index++) {
+        cds_byte_t *entry = _AT(self, base, index);
+        memcpy(entry, keys + index * self->key_size, self->key_size);
+        if (self->value_size > 0) {
+            memcpy(
+                entry + self->value_offset,
+                values + index * self->value_size,
+                self->value_size
+            );
+        }
+    }
+}
+
+/**
+ * @brief Sort entries in place with insertion sort. Equal keys stay in the
+ * same order.
+ */
+CDS_PRIVATE
+void _cds_flatmap_insertion_sort(
+    cds_flatmap_t *self,
+    cds_byte_t *base,
+    size_t count,
+    cds_byte_t *temp
+) {
+    size_t index = 1;
+    for (; index < count; index++) {
+        size_t slot = index;
+        memcpy(temp, _AT(self, base, index), _SIZE(self));
+        while (slot > 0
+            && self->compare(temp, _AT(self, base, slot - 1)) < 0)
+            slot--;
+        if (slot == index)
+            continue;
+        memmove(
+            _AT(self, base, slot + 1),
+            _AT(self, base, slot),
+            (index - slot) * _SIZE(self)
+        );
+        memcpy(_AT(self, base, slot), temp, _SIZE(self));
+    }
+}
+
+/**
+ * @brief Merge 2 sorted runs into `dest`. If keys are equal, the entry from
+ * `left` comes first.
+ */
+CDS_PRIVATE
+void _cds_flatmap_merge(
+    cds_flatmap_t *self,
+    cds_byte_t *left,
+    size_t left_count,
+    cds_byte_t *right,
+    size_t right_count,
+    cds_byte_t *dest
+) {
+    cds_byte_t *left_end = _AT(self, left, left_count);
+    cds_byte_t *right_end = _AT(self, right, right_count);
+    while (left < left_end && right < right_end) {
+        if (self->compare(right, left) < 0) {
+            memcpy(dest, right, _SIZE(self));
+            right += _SIZE(self);
+        } else {
+            memcpy(dest, left, _SIZE(self));
+            left += _SIZE(self);
+        }
+        dest += _SIZE(self);
+    }
+    memcpy(dest, left, (size_t) (left_end - left));
+    dest += left_end - left;
+    memcpy(dest, right, (size_t) (right_end - right));
+}
+
+/**
+ * @brief Merge sort entries so that equal keys stay in the same order.
+ * `scratch` must have room for `count + 1` entries.
+ */
+CDS_PRIVATE
+void _cds_flatmap_sort(
+    cds_flatmap_t *self,
+    cds_byte_t *base,
+    size_t count,
+    cds_byte_t *scratch
+) {
+    cds_byte_t *source = base;
+    cds_byte_t *dest = scratch;
+    size_t width = _CDS_FLATMAP_RUN;
+    size_t low = 0;
+    for (; low < count; low += _CDS_FLATMAP_RUN) {
+        size_t run = count - low < _CDS_FLATMAP_RUN
+            ? count - low
+            : _CDS_FLATMAP_RUN;
+        _cds_flatmap_insertion_sort(
+            self,
+            _AT(self, base, low),
+            run,
+            _AT(self, scratch, count)
+        );
+    }
+    for (; width < count; width *= 2) {
+        cds_byte_t *swap = source;
+        for (low = 0; low < count; low += 2 * width) {
+            size_t middle = count - low < width ? count : low + width;
+            size_t high = count - middle < width ? count : middle + width;
+            _cds_flatmap_merge(
+                self,
+                _AT(self, source, low),
+                middle - low,
+                _AT(self, source, middle),
+                high - middle,
+                _AT(self, dest, low)
+            );
+        }
+        source = dest;
+        dest = swap;
+    }
+    if (source != base)
+        memcpy(base, source, count * _SIZE(self));
+}
+
+/**
+ * @brief Remove all but the last of each run of sorted entries with equal
+ * keys.
+ *
+ * @return size_t The number of entries left.
+ */
+CDS_PRIVATE
+size_t _cds_flatmap_dedup(
+    cds_flatmap_t *self,
+    cds_byte_t *base,
+    size_t count
+) {
+    size_t kept = 0;
+    size_t index = 0;
+    for (; index < count; index++) {
+        if (index + 1 < count
+            && self->compare(
+                _AT(self, base, index),
+                _AT(self, base, index + 1)
+            ) == 0)
+            continue;
+        if (kept != index) {
+            memcpy(
+                _AT(self, base, kept),
+                _AT(self, base, index),
+                _SIZE(self)
+            );
+        }
+        kept++;
+    }
+    return kept;
+}
+
+/**
+ * @brief Make a vector with room to merge sort `count` entries.
+ */
+CDS_PRIVATE
+cds_status_t _cds_flatmap_scratch(
+    cds_flatmap_t *self,
+    cds_vector_t *scratch,
+    size_t count
+) {
+    CDS_NEW_STATUS = cds_vector_init_with_allocator(
+        scratch,
+        _SIZE(self),
+        self->entries.policy,
+        self->entries.allocator
+    );
+    CDS_IF_ERROR_RETURN_STATUS(status);
+    status = cds_vector_resize_uninit(scratch, count + 1);
+    CDS_IF_STATUS_ERROR(status)
+        cds_vector_destroy(scratch, NULL);
+    return status;
+}
+
+CDS_PUBLIC
+cds_status_t cds_flatmap_init(
+    cds_flatmap_t *self,
+    size_t key_size,
+    size_t value_size,
+    cds_compare_f compare
+) {
+    CDS_IF_NULL_RETURN_ERROR(self);
+    CDS_IF_NULL_RETURN_ERROR(compare);
+    CDS_IF_ZERO_RETURN_ERROR(key_size);
+    size_t value_alignment = _cds_flatmap_alignment(value_size);
+    size_t alignment = _cds_flatmap_alignment(key_size);
+    if (value_alignment > alignment)
+        alignment = value_alignment;
+    self->key_size = key_size;
+    self->value_size = value_size;
+    self->value_offset = _ROUND_UP(key_size, value_alignment);
+    self->compare = compare;
+    return cds_vector_init(
+        &self->entries,
+        _ROUND_UP(self->value_offset + value_size, alignment)
+    );
+}
+
+CDS_PUBLIC
+cds_status_t cds_flatmap_destroy(
+    cds_flatmap_t *self,
+    cds_free_f clean_key,
+    cds_free_f clean_value
+) {
+    if (self == NULL)
+        return cds_warning;
+    if (self->entries.buffer != NULL
+        && (clean_key != NULL || clean_value != NULL)) {
+        size_t index = 0;
+        for (; index < self->entries.length; index++) {
+            if (clean_key != NULL)
+                clean_key(cds_flatmap_key_at(self, index));
+            if (clean_value != NULL)
+                clean_value(cds_flatmap_value_at(self, index));
+        }
+    }
+    return cds_vector_destroy(&self->entries, NULL);
+}
+
+CDS_PUBLIC
+size_t cds_flatmap_lower_bound(const cds_flatmap_t *self, cds_ptr_t key) {
+    if (self == NULL || self->entries.buffer == NULL)
+        return 0;
+    cds_byte_t *base = self->entries.buffer;
+    size_t length = self->entries.length;
+    size_t first = 0;
+    if (length == 0)
+        return 0;
+    // The answer is always in [first, first + length], which halves every
+    // step whichever way the comparison goes, so the loop has no branch the
+    // processor can mispredict.
+    while (length > 1) {
+        size_t half = length / 2;
+#ifdef __GNUC__
+        size_t next_half = (length - half) / 2;
+        __builtin_prefetch(_AT(self, base, first + next_half));
+        __builtin_prefetch(_AT(self, base, first + half + next_half));
+#endif
+        first = self->compare(_AT(self, base, first + half), key) < 0
+            ? first + half
+            : first;
+        length -= half;
+    }
+    return first + (self->compare(_AT(self, base, first), key) < 0);
+}
+
+CDS_PUBLIC
+cds_ptr_t cds_flatmap_find(const cds_flatmap_t *self, cds_ptr_t key) {
+    size_t index = cds_flatmap_lower_bound(self, key);
+    if (self == NULL
+        || index >= self->entries.length
+        || self->compare(cds_flatmap_key_at(self, index), key) != 0)
+        return NULL;
+    return cds_flatmap_value_at(self, index);
+}
+
+CDS_PUBLIC
+bool cds_flatmap_contains(const cds_flatmap_t *self, cds_ptr_t key) {
+    return cds_flatmap_find(self, key) != NULL;
+}
+
+CDS_PUBLIC
+cds_status_t cds_flatmap_insert(
+    cds_flatmap_t *self,
+    cds_ptr_t key,
+    cds_ptr_t value
+) {
+    _VALIDATE_MAP(self);
+    CDS_IF_NULL_RETURN_ERROR(key);
+    if (self->value_size > 0 && value == NULL)
+        return cds_null_error;
+    size_t length = self->entries.length;
+    size_t index = cds_flatmap_lower_bound(self, key);
+    if (index == length
+        || self->compare(cds_flatmap_key_at(self, index), key) != 0) {
+        CDS_NEW_STATUS = cds_vector_resize_uninit(&self->entries, length + 1);
+        CDS_IF_ERROR_RETURN_STATUS(status);
+        memmove(
+            cds_flatmap_key_at(self, index + 1),
+            cds_flatmap_key_at(self, index),
+            (length - index) * _SIZE(self)
+        );
+        memcpy(cds_flatmap_key_at(self, index), key, self->key_size);
+    }
+    if (self->value_size > 0)
+        memcpy(cds_flatmap_value_at(self, index), value, self->value_size);
+    return cds_ok;
+}
+
+CDS_PUBLIC
+cds_status_t cds_flatmap_remove(
+    cds_flatmap_t *self,
+    cds_ptr_t key,
+    cds_ptr_t dest
+) {
+    _VALIDATE_MAP(self);
+    CDS_IF_NULL_RETURN_ERROR(key);
+    size_t index = cds_flatmap_lower_bound(self, key);
+    if (index == self->entries.length
+        || self->compare(cds_flatmap_key_at(self, index), key) != 0)
+        return cds_index_error;
+    if (dest != NULL && self->value_size > 0)
+        memcpy(dest, cds_flatmap_value_at(self, index), self->value_size);
+    return cds_vector_remove(&self->entries, index, NULL);
+}
+
+CDS_PUBLIC
+cds_status_t cds_flatmap_build(
+    cds_flatmap_t *self,
+    cds_ptr_t keys,
+    cds_ptr_t values,
+    size_t count
+) {
+    _VALIDATE_MAP(self);
+    if (count > 0) {
+        CDS_IF_NULL_RETURN_ERROR(keys);
+        if (self->value_size > 0 && values == NULL)
+            return cds_null_error;
+    }
+    cds_vector_t scratch;
+    CDS_NEW_STATUS = _cds_flatmap_scratch(self, &scratch, count);
+    CDS_IF_ERROR_RETURN_STATUS(status);
+    status = cds_vector_resize_uninit(&self->entries, count);
+    CDS_IF_STATUS_ERROR(status) {
+        cds_vector_destroy(&scratch, NULL);
+        return status;
+    }
+    cds_byte_t *base = self->entries.buffer;
+    _cds_flatmap_fill(self, base, keys, values, count);
+    _cds_flatmap_sort(self, base, count, scratch.buffer);
+    cds_vector_destroy(&scratch, NULL);
+    return cds_vector_resize_uninit(
+        &self->entries,
+        _cds_flatmap_dedup(self, base, count)
+    );
+}
+
+CDS_PUBLIC
+cds_status_t cds_flatmap_insert_batch(
+    cds_flatmap_t *self,
+    cds_ptr_t keys,
+    cds_ptr_t values,
+    size_t count
+) {
+    _VALIDATE_MAP(self);
+    if (count == 0)
+        return cds_ok;
+    CDS_IF_NULL_RETURN_ERROR(keys);
+    if (self->value_size > 0 && values == NULL)
+        return cds_null_error;
+    size_t old_count = self->entries.length;
+    cds_vector_t scratch;
+    CDS_NEW_STATUS = _cds_flatmap_scratch(self, &scratch, count);
+    CDS_IF_ERROR_RETURN_STATUS(status);
+    status = cds_vector_resize_uninit(&self->entries, old_count + count);
+    CDS_IF_STATUS_ERROR(status) {
+        cds_vector_destroy(&scratch, NULL);
+        return status;
+    }
+    // Sort the new entries after the old ones, then move them out of the
+    // way so that both runs can be merged into the vector from the back.
+    cds_byte_t *base = self->entries.buffer;
+    cds_byte_t *batch = scratch.buffer;
+    _cds_flatmap_fill(self, _AT(self, base, old_count), keys, values, count);
+    _cds_flatmap_sort(self, _AT(self, base, old_count), count, batch);
+    count = _cds_flatmap_dedup(self, _AT(self, base, old_count), count);
+    memcpy(batch, _AT(self, base, old_count), count * _SIZE(self));
+    size_t old_index = old_count;
+    size_t new_index = count;
+    size_t slot = old_count + count;
+    while (new_index > 0) {
+        // New entries go after old entries with the same key so that the
+        // dedup below keeps them.
+        if (old_index > 0 && self->compare(
+            _AT(self, batch, new_index - 1),
+            _AT(self, base, old_index - 1)
+        ) < 0) {
+            memcpy(
+                _AT(self, base, --slot),
+                _AT(self, base, --old_index),
+                _SIZE(self)
+            );
+        } else {
+            memcpy(
+                _AT(self, base, --slot),
+                _AT(self, batch, --new_index),
+                _SIZE(self)
+            );
+        }
+    }
+    cds_vector_destroy(&scratch, NULL);
+    return cds_vector_resize_uninit(
+        &self->entries,
+        _cds_flatmap_dedup(self, base, old_count + count)
+    );
+}
@@ -0,0 +1,251 @@
+#include <string.h>
+#include <CDataStructures/gapbuffer.h>
+
+#define _HEAD(self) cds_buffer_get_data((self)->buffer)->header
+#define _VALIDATE_GAP(self) \
+    CDS_IF_NULL_RETURN_ERROR(self); \
+    CDS_IF_NULL_RETURN_ERROR((self)->buffer);
+
+CDS_INLINE
+cds_byte_t *_cds_gapbuffer_slot(cds_gapbuffer_t *self, size_t slot) {
+    return (cds_byte_t *) self->buffer + slot * _HEAD(self).type_size;
+}
+
+/**
+ * @brief Make the gap at least `count` elements wide. The storage grows
+ * according to the dynbuffer's growth policy and the elements after the gap
+ * are moved to the end of the new storage.
+ */
+CDS_PRIVATE
+cds_status_t _cds_gapbuffer_make_room(cds_gapbuffer_t *self, size_t count) {
+    if (self->gap_end - self->gap_start >= count)
+        return cds_ok;
+    size_t length = _HEAD(self).length;
+    if (count > SIZE_MAX - length)
+        return cds_alloc_error;
+    size_t required = length + count;
+    size_t old_reserved = _HEAD(self).reserved;
+    size_t capacity = cds_growth_policy_grow(
+        _HEAD(self).policy,
+        old_reserved,
+        required,
+        _HEAD(self).type_size,
+        sizeof(cds_buffer_header_t)
+    );
+    CDS_NEW_STATUS = cds_buffer_reserve(&self->buffer, capacity - length);
+    if (status == cds_alloc_error && capacity > required)
+        status = cds_buffer_reserve(&self->buffer, count);
+    CDS_IF_ERROR_RETURN_STATUS(status);
+    size_t tail = old_reserved - self->gap_end;
+    size_t new_gap_end = _HEAD(self).reserved - tail;
+    memmove(
+        _cds_gapbuffer_slot(self, new_gap_end),
+        _cds_gapbuffer_slot(self, self->gap_end),
+        tail * _HEAD(self).type_size
+    );
+    self->gap_end = new_gap_end;
+    return cds_ok;
+}
+
+CDS_PRIVATE
+void _cds_gapbuffer_move_gap(cds_gapbuffer_t *self, size_t position) {
+    size_t type_size = _HEAD(self).type_size;
+    if (position < self->gap_start) {
+        size_t count = self->gap_start - position;
+        self->gap_end -= count;
+        memmove(
+            _cds_gapbuffer_slot(self, self->gap_end),
+            _cds_gapbuffer_slot(self, position),
+            count * type_size
+        );
+    } else if (position > self->gap_start) {
+        size_t count = position - self->gap_start;
+        memmove(
+            _cds_gapbuffer_slot(self, self->gap_start),
+            _cds_gapbuffer_slot(self, self->gap_end),
+            count * type_size
+        );
+        self->gap_end += count;
+    }
+    self->gap_start = position;
+}
+
+CDS_PUBLIC
+cds_status_t cds_gapbuffer_init(cds_gapbuffer_t *self, size_t type_size) {
+    CDS_IF_NULL_RETURN_ERROR(self);
+    CDS_IF_ZERO_RETURN_ERROR(type_size);
+    cds_buffer_t buffer = cds_buffer_new();
+    CDS_IF_NULL_RETURN_ALLOC_ERROR(buffer);
+    CDS_NEW_STATUS = cds_ok;
+    CDS_IF_STATUS_ERROR(cds_buffer_init(&buffer, type_size)) {
+        cds_buffer_free(buffer, NULL);
+        return status;
+    }
+    self->buffer = buffer;
+    self->gap_start = 0;
+    self->gap_end = _HEAD(self).reserved;
+    return cds_ok;
+}
+
+CDS_PUBLIC
+cds_status_t cds_gapbuffer_from_buffer(
+    cds_gapbuffer_t *self,
+    cds_buffer_t buffer
+) {
+    CDS_IF_NULL_RETURN_ERROR(self);
+    CDS_IF_NULL_RETURN_ERROR(buffer);
+    if (cds_buffer_is_mapped(buffer))
+        return cds_error;
+    CDS_NEW_STATUS = cds_ok;
+    CDS_IF_ERROR_RETURN_STATUS(cds_buffer_set_ring(&buffer, false));
+    self->buffer = buffer;
+    self->gap_start = _HEAD(self).length;
+    self->gap_end = _HEAD(self).reserved;
+    return cds_ok;
+}
+
+CDS_PUBLIC
+cds_status_t cds_gapbuffer_destroy(
+    cds_gapbuffer_t *self,
+    cds_free_f clean_element
+) {
+    if (self == NULL)
+        return cds_warning;
+    if (self->buffer == NULL)
+        return cds_ok;
+    CDS_NEW_STATUS = cds_ok;
+    if (clean_element != NULL) {
+        // Close the gap so that the dynbuffer can clean up the elements.
+        _cds_gapbuffer_move_gap(self, _HEAD(self).length);
+    }
+    status = cds_buffer_free(self->buffer, clean_element);
+    self->buffer = NULL;
+    self->gap_start = 0;
+    self->gap_end = 0;
+    return status;
+}
+
+CDS_PUBLIC
+size_t cds_gapbuffer_length(cds_gapbuffer_t *self) {
+    if (self == NULL || self->buffer == NULL)
+        return 0;
+    return _HEAD(self).length;
+}
+
+CDS_PUBLIC
+size_t cds_gapbuffer_cursor(cds_gapbuffer_t *self) {
+    if (self == NULL)
+        return 0;
+    return self->gap_start;
+}
+
+CDS_PUBLIC
+cds_ptr_t cds_gapbuffer_get(cds_gapbuffer_t *self, size_t index) {
+    if (self == NULL || self->buffer == NULL || index >= _HEAD(self).length)
+        return NULL;
+    if (index >= self->gap_start)
+        index += self->gap_end - self->gap_start;
+    return _cds_gapbuffer_slot(self, index);
+}
+
+CDS_PUBLIC
+cds_status_t cds_gapbuffer_move_cursor(
+    cds_gapbuffer_t *self,
+    size_t position
+) {
+    _VALIDATE_GAP(self);
+    if (position > _HEAD(self).length)
+        return cds_index_error;
+    _cds_gapbuffer_move_gap(self, position);
+    return cds_ok;
+}
+
+CDS_PUBLIC
+cds_status_t cds_gapbuffer_insert(cds_gapbuffer_t *self, cds_ptr_t src) {
+    return cds_gapbuffer_insert_range(self, src, 1);
+}
+
+CDS_PUBLIC
+cds_status_t cds_gapbuffer_insert_range(
+    cds_gapbuffer_t *self,
+    cds_ptr_t src,
+    size_t count
+) {
+    _VALIDATE_GAP(self);
+    if (count == 0)
+        return cds_ok;
+    CDS_IF_NULL_RETURN_ERROR(src);
+    CDS_NEW_STATUS = cds_ok;
+    CDS_IF_ERROR_RETURN_STATUS(_cds_gapbuffer_make_room(self, count));
+    memcpy(
+        _cds_gapbuffer_slot(self, self->gap_start),
+        src,
+        count * _HEAD(self).type_size
+    );
+    self->gap_start += count;
+    _HEAD(self).length += count;
+    return cds_ok;
+}
+
+CDS_PUBLIC
+cds_status_t cds_gapbuffer_erase_before(
+    cds_gapbuffer_t *self,
+    size_t count,
+    cds_free_f clean_element
+) {
+    _VALIDATE_GAP(self);
+    if (count > self->gap_start)
+        return cds_index_error;
+    self->gap_start -= count;
+    if (clean_element != NULL) {
+        size_t index = 0;
+        for (; index < count; index++)
+            clean_element(_cds_gapbuffer_slot(self, self->gap_start + index));
+    }
+    _HEAD(self).length -= count;
+    return cds_ok;
+}
+
+CDS_PUBLIC
+cds_status_t cds_gapbuffer_erase_after(
+    cds_gapbuffer_t *self,
+    size_t count,
+    cds_free_f clean_element
+) {
+    _VALIDATE_GAP(self);
+    if (count > _HEAD(self).reserved - self->gap_end)
+        return cds_index_error;
+    if (clean_element != NULL) {
+        size_t index = 0;
+        for (; index < count; index++)
+            clean_element(_cds_gapbuffer_slot(self, self->gap_end + index));
+    }
+    self->gap_end += count;
+    _HEAD(self).length -= count;
+    return cds_ok;
+}
+
+CDS_PUBLIC
+cds_status_t cds_gapbuffer_as_buffer(
+    cds_gapbuffer_t *self,
+    cds_buffer_t *buffer
+) {
+    _VALIDATE_GAP(self);
+    CDS_IF_NULL_RETURN_ERROR(buffer);
+    _cds_gapbuffer_move_gap(self, _HEAD(self).length);
+    *buffer = self->buffer;
+    return cds_ok;
+}
+
+CDS_PUBLIC
+cds_status_t cds_gapbuffer_release(
+    cds_gapbuffer_t *self,
+    cds_buffer_t *buffer
+) {
+    CDS_NEW_STATUS = cds_ok;
+    CDS_IF_ERROR_RETURN_STATUS(cds_gapbuffer_as_buffer(self, buffer));
+    self->buffer = NULL;
+    self->gap_start = 0;
+    self->gap_end = 0;
+    return cds_ok;
+}
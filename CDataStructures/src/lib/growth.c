@@ -0,0 +1,120 @@
+#include <CDataStructures/growth.h>
+
+const cds_growth_policy_t CDS_DEFAULT_GROWTH_POLICY = {
+    .growth_percent = CDS_DEFAULT_GROWTH_PERCENT,
+    .min_capacity = CDATASTRUCTURES_MIN_CAPACITY,
+    .size_class = CDS_DEFAULT_SIZE_CLASS,
+    .shrink_percent = CDS_DEFAULT_SHRINK_PERCENT,
+    .shrink_floor = CDS_DEFAULT_SHRINK_FLOOR
+};
+
+#define _POLICY(self) ((self) == NULL ? &CDS_DEFAULT_GROWTH_POLICY : (self))
+
+/**
+ * @brief Round the capacity up so that the whole allocation fills its size
+ * class.
+ */
+CDS_PRIVATE
+size_t _cds_growth_policy_round(
+    const cds_growth_policy_t *self,
+    size_t capacity,
+    size_t type_size,
+    size_t overhead
+) {
+    if (self->size_class <= 1 || type_size == 0)
+        return capacity;
+    if (capacity > (SIZE_MAX - overhead - self->size_class) / type_size)
+        return capacity;
+    size_t bytes = capacity * type_size + overhead;
+    size_t remainder = bytes % self->size_class;
+    if (remainder != 0)
+        bytes += self->size_class - remainder;
+    return (bytes - overhead) / type_size;
+}
+
+CDS_PUBLIC
+cds_status_t cds_growth_policy_debug(
+    const cds_growth_policy_t *self,
+    FILE *file
+) {
+    CDS_IF_NULL_RETURN_ERROR(self);
+    int count = fprintf(
+        file,
+        "cds_growth_policy_t {\n"
+        "    growth_percent = %zu\n"
+        "    min_capacity = %zu\n"
+        "    size_class = %zu\n"
+        "    shrink_percent = %zu\n"
+        "    shrink_floor = %zu\n"
+        "}",
+        self->growth_percent,
+        self->min_capacity,
+        self->size_class,
+        self->shrink_percent,
+        self->shrink_floor
+    );
+    return count > 0 ? cds_ok : cds_error;
+}
+
+CDS_PUBLIC
+size_t cds_growth_policy_grow(
+    const cds_growth_policy_t *self,
+    size_t capacity,
+    size_t required,
+    size_t type_size,
+    size_t overhead
+) {
+    self = _POLICY(self);
+    size_t grown = capacity;
+    if (self->growth_percent > 100) {
+        if (grown > SIZE_MAX / self->growth_percent)
+            grown = SIZE_MAX;
+        else
+            grown = grown * self->growth_percent / 100;
+    }
+    if (grown < self->min_capacity)
+        grown = self->min_capacity;
+    if (grown < required)
+        grown = required;
+    return _cds_growth_policy_round(self, grown, type_size, overhead);
+}
+
+CDS_PUBLIC
+bool cds_growth_policy_should_shrink(
+    const cds_growth_policy_t *self,
+    size_t length,
+    size_t capacity,
+    size_t type_size
+) {
+    self = _POLICY(self);
+    if (self->shrink_percent == 0 || capacity <= self->min_capacity)
+        return false;
+    if (type_size == 0 || capacity <= self->shrink_floor / type_size)
+        return false;
+    return length < cds_growth_policy_shrink_threshold(self, capacity);
+}
+
+CDS_PUBLIC
+size_t cds_growth_policy_shrink_threshold(
+    const cds_growth_policy_t *self,
+    size_t capacity
+) {
+    self = _POLICY(self);
+    // capacity * shrink_percent / 100 without overflowing on large buffers.
+    return (capacity / 100) * self->shrink_percent
+        + (capacity % 100) * self->shrink_percent / 100;
+}
+
+CDS_PUBLIC
+size_t cds_growth_policy_shrink(
+    const cds_growth_policy_t *self,
+    size_t length,
+    size_t type_size,
+    size_t overhead
+) {
+    self = _POLICY(self);
+    size_t capacity = length;
+    if (type_size != 0 && capacity < self->shrink_floor / type_size)
+        capacity = self->shrink_floor / type_size;
+    return cds_growth_policy_grow(self, capacity, length, type_size, overhead);
+}
@@ -0,0 +1,514 @@
+#include <wchar.h>
+#include <CDataStructures/kernels.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+/**
+ * @brief Defined if the SIMD kernels are built. They use GCC vector
+ * extensions compiled for each instruction set with the `target` attribute,
+ * so the rest of the library does not need any special compiler flags.
+ */
+#   define _CDS_KERNEL_X86
+#endif
+
+/**
+ * @brief The number of vectors `count` goes through before it adds up its
+ * counters, so that counters as narrow as `int8_t` never overflow.
+ */
+#define _CDS_KERNEL_COUNT_BLOCK 127
+
+#if WCHAR_MAX > 0xffff
+#   define _CDS_KERNEL_UWCHAR uint32_t
+#elif WCHAR_MAX > 0xff
+#   define _CDS_KERNEL_UWCHAR uint16_t
+#else
+#   define _CDS_KERNEL_UWCHAR uint8_t
+#endif
+
+/**
+ * @brief The types in `CDS_INTEGER_TYPES`, each with the unsigned type of the
+ * same size. Sums, additions and products are worked out in the unsigned
+ * type, so that they wrap around instead of overflowing, and every version
+ * of a kernel gives the same result.
+ */
+#define _CDS_KERNEL_TYPES(applier) \
+    applier(int8, int8_t, uint8_t) \
+    applier(int16, int16_t, uint16_t) \
+    applier(int32, int32_t, uint32_t) \
+    applier(int64, int64_t, uint64_t) \
+    applier(uint8, uint8_t, uint8_t) \
+    applier(uint16, uint16_t, uint16_t) \
+    applier(uint32, uint32_t, uint32_t) \
+    applier(uint64, uint64_t, uint64_t) \
+    applier(char, char, unsigned char) \
+    applier(size, size_t, size_t) \
+    applier(wchar, wchar_t, _CDS_KERNEL_UWCHAR) \
+    applier(byte, cds_byte_t, unsigned char)
+
+/**
+ * @brief The scalar kernels, which every other version falls back on for the
+ * elements left over after the last full vector.
+ */
+#define _CDS_KERNELS_DEFINE_SCALAR(stn, ltn, uln) \
+    CDS_PRIVATE \
+    ltn _cds_##stn##_sum_scalar(const ltn *array, size_t length) { \
+        uln sum = 0; \
+        size_t index = 0; \
+        for (; index < length; index++) \
+            sum = (uln) (sum + (uln) array[index]); \
+        return (ltn) sum; \
+    } \
+    \
+    CDS_PRIVATE \
+    ltn _cds_##stn##_min_scalar(const ltn *array, size_t length) { \
+        ltn best = array[0]; \
+        size_t index = 1; \
+        for (; index < length; index++) { \
+            if (array[index] < best) \
+                best = array[index]; \
+        } \
+        return best; \
+    } \
+    \
+    CDS_PRIVATE \
+    ltn _cds_##stn##_max_scalar(const ltn *array, size_t length) { \
+        ltn best = array[0]; \
+        size_t index = 1; \
+        for (; index < length; index++) { \
+            if (array[index] > best) \
+                best = array[index]; \
+        } \
+        return best; \
+    } \
+    \
+    CDS_PRIVATE \
+    size_t _cds_##stn##_find_scalar( \
+        const ltn *array, \
+        size_t length, \
+        ltn value \
+    ) { \
+        size_t index = 0; \
+        for (; index < length; index++) { \
+            if (array[index] == value) \
+                return index; \
+        } \
+        return length; \
+    } \
+    \
+    CDS_PRIVATE \
+    size_t _cds_##stn##_count_scalar( \
+        const ltn *array, \
+        size_t length, \
+        ltn value \
+    ) { \
+        size_t count = 0; \
+        size_t index = 0; \
+        for (; index < length; index++) \
+            count += array[index] == value; \
+        return count; \
+    } \
+    \
+    CDS_PRIVATE \
+    void _cds_##stn##_add_scalar(ltn *dest, const ltn *src, size_t length) { \
+        size_t index = 0; \
+        for (; index < length; index++) \
+            dest[index] = (ltn) (uln) ((uln) dest[index] + (uln) src[index]); \
+    } \
+    \
+    CDS_PRIVATE \
+    void _cds_##stn##_scale_scalar(ltn *array, size_t length, ltn factor) { \
+        size_t index = 0; \
+        /* 1u keeps types narrower than int from being promoted to int. */ \
+        for (; index < length; index++) \
+            array[index] = (ltn) (uln) ( \
+                1u * (uln) array[index] * (uln) factor \
+            ); \
+    }
+
+_CDS_KERNEL_TYPES(_CDS_KERNELS_DEFINE_SCALAR)
+
+#undef _CDS_KERNELS_DEFINE_SCALAR
+
+#ifdef _CDS_KERNEL_X86
+
+/**
+ * @brief Define the kernels for one type and one instruction set, using
+ * vectors of `width` bytes. The `_v` type is a vector of elements, the `_u`
+ * type is the same vector at any address in an array, the `_n` type holds
+ * the same bits as unsigned lanes for arithmetic and the `_w` type views a
+ * vector as 64-bit words.
+ */
+#   define _CDS_KERNELS_DEFINE_SIMD(stn, ltn, uln, isa, features, width) \
+    typedef ltn _cds_##stn##_##isa##_v \
+        __attribute__((vector_size(width))); \
+    typedef ltn _cds_##stn##_##isa##_u \
+        __attribute__((vector_size(width), aligned(1), may_alias)); \
+    typedef uln _cds_##stn##_##isa##_n \
+        __attribute__((vector_size(width))); \
+    typedef uint64_t _cds_##stn##_##isa##_w \
+        __attribute__((vector_size(width))); \
+    \
+    __attribute__((target(features))) \
+    CDS_INLINE \
+    _cds_##stn##_##isa##_v _cds_##stn##_load_##isa(const ltn *array) { \
+        return *(const _cds_##stn##_##isa##_u *) array; \
+    } \
+    \
+    __attribute__((target(features))) \
+    CDS_INLINE \
+    _cds_##stn##_##isa##_v _cds_##stn##_splat_##isa(ltn value) { \
+        _cds_##stn##_##isa##_v vector; \
+        size_t lane = 0; \
+        for (; lane < (width) / sizeof(ltn); lane++) \
+            vector[lane] = value; \
+        return vector; \
+    } \
+    \
+    __attribute__((target(features))) \
+    CDS_PRIVATE \
+    ltn _cds_##stn##_sum_##isa(const ltn *array, size_t length) { \
+        const size_t lanes = (width) / sizeof(ltn); \
+        _cds_##stn##_##isa##_n sum = \
+            (_cds_##stn##_##isa##_n) _cds_##stn##_splat_##isa(0); \
+        size_t index = 0; \
+        for (; index + lanes <= length; index += lanes) \
+            sum += (_cds_##stn##_##isa##_n) \
+                _cds_##stn##_load_##isa(array + index); \
+        uln total = (uln) _cds_##stn##_sum_scalar( \
+            array + index, \
+            length - index \
+        ); \
+        size_t lane = 0; \
+        for (; lane < lanes; lane++) \
+            total = (uln) (total + sum[lane]); \
+        return (ltn) total; \
+    } \
+    \
+    __attribute__((target(features))) \
+    CDS_PRIVATE \
+    ltn _cds_##stn##_min_##isa(const ltn *array, size_t length) { \
+        const size_t lanes = (width) / sizeof(ltn); \
+        if (length < lanes) \
+            return _cds_##stn##_min_scalar(array, length); \
+        _cds_##stn##_##isa##_v best = _cds_##stn##_load_##isa(array); \
+        size_t index = lanes; \
+        for (; index + lanes <= length; index += lanes) { \
+            _cds_##stn##_##isa##_v next = _cds_##stn##_load_##isa( \
+                array + index \
+            ); \
+            _cds_##stn##_##isa##_v lesser = \
+                (_cds_##stn##_##isa##_v) (next < best); \
+            best = (next & lesser) | (best & ~lesser); \
+        } \
+        ltn result = best[0]; \
+        size_t lane = 1; \
+        for (; lane < lanes; lane++) { \
+            if (best[lane] < result) \
+                result = best[lane]; \
+        } \
+        for (; index < length; index++) { \
+            if (array[index] < result) \
+                result = array[index]; \
+        } \
+        return result; \
+    } \
+    \
+    __attribute__((target(features))) \
+    CDS_PRIVATE \
+    ltn _cds_##stn##_max_##isa(const ltn *array, size_t length) { \
+        const size_t lanes = (width) / sizeof(ltn); \
+        if (length < lanes) \
+            return _cds_##stn##_max_scalar(array, length); \
+        _cds_##stn##_##isa##_v best = _cds_##stn##_load_##isa(array); \
+        size_t index = lanes; \
+        for (; index + lanes <= length; index += lanes) { \
+            _cds_##stn##_##isa##_v next = _cds_##stn##_load_##isa( \
+                array + index \
+            ); \
+            _cds_##stn##_##isa##_v greater = \
+                (_cds_##stn##_##isa##_v) (next > best); \
+            best = (next & greater) | (best & ~greater); \
+        } \
+        ltn result = best[0]; \
+        size_t lane = 1; \
+        for (; lane < lanes; lane++) { \
+            if (best[lane] > result) \
+                result = best[lane]; \
+        } \
+        for (; index < length; index++) { \
+            if (array[index] > result) \
+                result = array[index]; \
+        } \
+        return result; \
+    } \
+    \
+    __attribute__((target(features))) \
+    CDS_PRIVATE \
+    size_t _cds_##stn##_find_##isa( \
+        const ltn *array, \
+        size_t length, \
+        ltn value \
+    ) { \
+        const size_t lanes = (width) / sizeof(ltn); \
+        _cds_##stn##_##isa##_v needle = _cds_##stn##_splat_##isa(value); \
+        size_t index = 0; \
+        for (; index + lanes <= length; index += lanes) { \
+            _cds_##stn##_##isa##_w equal = (_cds_##stn##_##isa##_w) ( \
+                _cds_##stn##_load_##isa(array + index) == needle \
+            ); \
+            uint64_t any = 0; \
+            size_t word = 0; \
+            for (; word < (width) / sizeof(uint64_t); word++) \
+                any |= equal[word]; \
+            if (any != 0) \
+                break; \
+        } \
+        return index + _cds_##stn##_find_scalar( \
+            array + index, \
+            length - index, \
+            value \
+        ); \
+    } \
+    \
+    __attribute__((target(features))) \
+    CDS_PRIVATE \
+    size_t _cds_##stn##_count_##isa( \
+        const ltn *array, \
+        size_t length, \
+        ltn value \
+    ) { \
+        const size_t lanes = (width) / sizeof(ltn); \
+        _cds_##stn##_##isa##_v needle = _cds_##stn##_splat_##isa(value); \
+        size_t count = 0; \
+        size_t index = 0; \
+        while (index + lanes <= length) { \
+            /* Equal lanes compare to -1, so subtracting counts them. */ \
+            _cds_##stn##_##isa##_n counters = \
+                (_cds_##stn##_##isa##_n) _cds_##stn##_splat_##isa(0); \
+            size_t block = 0; \
+            for (; \
+                block < _CDS_KERNEL_COUNT_BLOCK && index + lanes <= length; \
+                block++, index += lanes) \
+                counters -= (_cds_##stn##_##isa##_n) ( \
+                    _cds_##stn##_load_##isa(array + index) == needle \
+                ); \
+            size_t lane = 0; \
+            for (; lane < lanes; lane++) \
+                count += (size_t) counters[lane]; \
+        } \
+        return count + _cds_##stn##_count_scalar( \
+            array + index, \
+            length - index, \
+            value \
+        ); \
+    } \
+    \
+    __attribute__((target(features))) \
+    CDS_PRIVATE \
+    void _cds_##stn##_add_##isa(ltn *dest, const ltn *src, size_t length) { \
+        const size_t lanes = (width) / sizeof(ltn); \
+        size_t index = 0; \
+        for (; index + lanes <= length; index += lanes) \
+            *(_cds_##stn##_##isa##_u *) (dest + index) = \
+                (_cds_##stn##_##isa##_v) ( \
+                    (_cds_##stn##_##isa##_n) \
+                        _cds_##stn##_load_##isa(dest + index) \
+                    + (_cds_##stn##_##isa##_n) \
+                        _cds_##stn##_load_##isa(src + index) \
+                ); \
+        _cds_##stn##_add_scalar(dest + index, src + index, length - index); \
+    } \
+    \
+    __attribute__((target(features))) \
+    CDS_PRIVATE \
+    void _cds_##stn##_scale_##isa(ltn *array, size_t length, ltn factor) { \
+        const size_t lanes = (width) / sizeof(ltn); \
+        _cds_##stn##_##isa##_n factors = \
+            (_cds_##stn##_##isa##_n) _cds_##stn##_splat_##isa(factor); \
+        size_t index = 0; \
+        for (; index + lanes <= length; index += lanes) \
+            *(_cds_##stn##_##isa##_u *) (array + index) = \
+                (_cds_##stn##_##isa##_v) ( \
+                    (_cds_##stn##_##isa##_n) \
+                        _cds_##stn##_load_##isa(array + index) \
+                    * factors \
+                ); \
+        _cds_##stn##_scale_scalar(array + index, length - index, factor); \
+    }
+
+#   define _CDS_KERNELS_DEFINE_SSE2(stn, ltn, uln) \
+    _CDS_KERNELS_DEFINE_SIMD(stn, ltn, uln, sse2, "sse2", 16)
+#   define _CDS_KERNELS_DEFINE_AVX2(stn, ltn, uln) \
+    _CDS_KERNELS_DEFINE_SIMD(stn, ltn, uln, avx2, "avx2", 32)
+#   define _CDS_KERNELS_DEFINE_AVX512(stn, ltn, uln) \
+    _CDS_KERNELS_DEFINE_SIMD(stn, ltn, uln, avx512, "avx512f,avx512bw", 64)
+
+_CDS_KERNEL_TYPES(_CDS_KERNELS_DEFINE_SSE2)
+_CDS_KERNEL_TYPES(_CDS_KERNELS_DEFINE_AVX2)
+_CDS_KERNEL_TYPES(_CDS_KERNELS_DEFINE_AVX512)
+
+#   undef _CDS_KERNELS_DEFINE_SSE2
+#   undef _CDS_KERNELS_DEFINE_AVX2
+#   undef _CDS_KERNELS_DEFINE_AVX512
+#   undef _CDS_KERNELS_DEFINE_SIMD
+
+#endif
+
+#define _CDS_KERNEL_FIELDS(stn, ltn) \
+    ltn (*stn##_sum)(const ltn *, size_t); \
+    ltn (*stn##_min)(const ltn *, size_t); \
+    ltn (*stn##_max)(const ltn *, size_t); \
+    size_t (*stn##_find)(const ltn *, size_t, ltn); \
+    size_t (*stn##_count)(const ltn *, size_t, ltn); \
+    void (*stn##_add)(ltn *, const ltn *, size_t); \
+    void (*stn##_scale)(ltn *, size_t, ltn);
+
+/**
+ * @brief One version of every kernel.
+ */
+typedef struct _cds_kernel_table_t {
+    CDS_INTEGER_TYPES(_CDS_KERNEL_FIELDS)
+} _cds_kernel_table_t;
+
+#undef _CDS_KERNEL_FIELDS
+
+#define _CDS_KERNEL_ENTRIES(stn, isa) \
+    _cds_##stn##_sum_##isa, \
+    _cds_##stn##_min_##isa, \
+    _cds_##stn##_max_##isa, \
+    _cds_##stn##_find_##isa, \
+    _cds_##stn##_count_##isa, \
+    _cds_##stn##_add_##isa, \
+    _cds_##stn##_scale_##isa,
+
+#define _CDS_KERNEL_ENTRIES_SCALAR(stn, ltn) _CDS_KERNEL_ENTRIES(stn, scalar)
+#define _CDS_KERNEL_ENTRIES_SSE2(stn, ltn) _CDS_KERNEL_ENTRIES(stn, sse2)
+#define _CDS_KERNEL_ENTRIES_AVX2(stn, ltn) _CDS_KERNEL_ENTRIES(stn, avx2)
+#define _CDS_KERNEL_ENTRIES_AVX512(stn, ltn) _CDS_KERNEL_ENTRIES(stn, avx512)
+
+static const _cds_kernel_table_t _cds_kernel_tables[] = {
+    {CDS_INTEGER_TYPES(_CDS_KERNEL_ENTRIES_SCALAR)},
+#ifdef _CDS_KERNEL_X86
+    {CDS_INTEGER_TYPES(_CDS_KERNEL_ENTRIES_SSE2)},
+    {CDS_INTEGER_TYPES(_CDS_KERNEL_ENTRIES_AVX2)},
+    {CDS_INTEGER_TYPES(_CDS_KERNEL_ENTRIES_AVX512)},
+#endif
+};
+
+#undef _CDS_KERNEL_ENTRIES_SCALAR
+#undef _CDS_KERNEL_ENTRIES_SSE2
+#undef _CDS_KERNEL_ENTRIES_AVX2
+#undef _CDS_KERNEL_ENTRIES_AVX512
+#undef _CDS_KERNEL_ENTRIES
+
+static cds_kernel_isa_t _cds_kernel_isa = cds_kernel_scalar;
+static const _cds_kernel_table_t *_cds_kernels = &_cds_kernel_tables[0];
+
+CDS_PUBLIC
+bool cds_kernel_isa_supported(cds_kernel_isa_t isa) {
+    switch (isa) {
+        case cds_kernel_scalar:
+            return true;
+#ifdef _CDS_KERNEL_X86
+        case cds_kernel_sse2:
+            return __builtin_cpu_supports("sse2");
+        case cds_kernel_avx2:
+            return __builtin_cpu_supports("avx2");
+        case cds_kernel_avx512:
+            return __builtin_cpu_supports("avx512f")
+                && __builtin_cpu_supports("avx512bw");
+#endif
+        default:
+            return false;
+    }
+}
+
+CDS_PUBLIC
+cds_kernel_isa_t cds_kernel_get_isa(void) {
+    return _cds_kernel_isa;
+}
+
+CDS_PUBLIC
+cds_status_t cds_kernel_set_isa(cds_kernel_isa_t isa) {
+    if (!cds_kernel_isa_supported(isa))
+        return cds_error;
+    _cds_kernel_isa = isa;
+    _cds_kernels = &_cds_kernel_tables[isa];
+    return cds_ok;
+}
+
+CDS_PUBLIC
+const char *cds_kernel_isa_name(cds_kernel_isa_t isa) {
+    switch (isa) {
+        case cds_kernel_scalar: return "scalar";
+        case cds_kernel_sse2: return "sse2";
+        case cds_kernel_avx2: return "avx2";
+        case cds_kernel_avx512: return "avx512";
+        default: return "unknown";
+    }
+}
+
+#ifdef __GNUC__
+/**
+ * @brief Pick the fastest kernels the processor supports before `main`
+ * runs.
+ */
+__attribute__((constructor))
+CDS_PRIVATE
+void _cds_kernel_select(void) {
+#   ifdef _CDS_KERNEL_X86
+    __builtin_cpu_init();
+#   endif
+    cds_kernel_isa_t isa = cds_kernel_avx512;
+    while (isa != cds_kernel_scalar && !cds_kernel_isa_supported(isa))
+        isa = (cds_kernel_isa_t) (isa - 1);
+    cds_kernel_set_isa(isa);
+}
+#endif
+
+#define _CDS_KERNELS_DEFINE(stn, ltn) \
+    CDS_PUBLIC ltn \
+    CDS_SMASH_PUBLIC(stn, sum)(const ltn *array, size_t length) { \
+        return _cds_kernels->stn##_sum(array, length); \
+    } \
+    \
+    CDS_PUBLIC cds_status_t \
+    CDS_SMASH_PUBLIC(stn, min)(const ltn *array, size_t length, ltn *result) { \
+        CDS_IF_NULL_RETURN_ERROR(result); \
+        CDS_IF_ZERO_RETURN_ERROR(length); \
+        CDS_IF_NULL_RETURN_ERROR(array); \
+        *result = _cds_kernels->stn##_min(array, length); \
+        return cds_ok; \
+    } \
+    \
+    CDS_PUBLIC cds_status_t \
+    CDS_SMASH_PUBLIC(stn, max)(const ltn *array, size_t length, ltn *result) { \
+        CDS_IF_NULL_RETURN_ERROR(result); \
+        CDS_IF_ZERO_RETURN_ERROR(length); \
+        CDS_IF_NULL_RETURN_ERROR(array); \
+        *result = _cds_kernels->stn##_max(array, length); \
+        return cds_ok; \
+    } \
+    \
+    CDS_PUBLIC size_t \
+    CDS_SMASH_PUBLIC(stn, find)(const ltn *array, size_t length, ltn value) { \
+        return _cds_kernels->stn##_find(array, length, value); \
+    } \
+    \
+    CDS_PUBLIC size_t \
+    CDS_SMASH_PUBLIC(stn, count)(const ltn *array, size_t length, ltn value) { \
+        return _cds_kernels->stn##_count(array, length, value); \
+    } \
+    \
+    CDS_PUBLIC void \
+    CDS_SMASH_PUBLIC(stn, add)(ltn *dest, const ltn *src, size_t length) { \
+        _cds_kernels->stn##_add(dest, src, length); \
+    } \
+    \
+    CDS_PUBLIC void \
+    CDS_SMASH_PUBLIC(stn, scale)(ltn *array, size_t length, ltn factor) { \
+        _cds_kernels->stn##_scale(array, length, factor); \
+    }
+
+CDS_INTEGER_TYPES(_CDS_KERNELS_DEFINE)
+
+#undef _CDS_KERNELS_DEFINE
@@ -0,0 +1,577 @@
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <CDataStructures/parallel.h>
+
+/**
+ * @brief Everything the tasks of one parallel algorithm need. Each algorithm
+ * only fills in the fields it uses.
+ */
+typedef struct _cds_par_job_t {
+    cds_byte_t *data;
+    size_t length;
+    size_t type_size;
+    /**
+     * @brief The number of elements in each chunk.
+     */
+    size_t grain;
+    cds_apply_f apply;
+    cds_ptr_t context;
+    cds_combine_f combine;
+    cds_byte_t *identity;
+    /**
+     * @brief One accumulator per chunk.
+     */
+    cds_byte_t *partials;
+    cds_compare_f compare;
+    cds_byte_t *src;
+    cds_byte_t *dest;
+    /**
+     * @brief The length of each sorted run being merged.
+     */
+    size_t width;
+} _cds_par_job_t;
+
+#define _AT(array, index, type_size) ((array) + (index) * (type_size))
+
+/**
+ * @brief Run tasks until none are left. Must be called with `lock` held.
+ */
+CDS_PRIVATE
+void _cds_thread_pool_work(cds_thread_pool_t *self) {
+    while (self->next_task < self->task_count) {
+        size_t index = self->next_task++;
+        cds_task_f task = self->task;
+        cds_ptr_t context = self->context;
+        pthread_mutex_unlock(&self->lock);
+        cds_status_t status = task(context, index);
+        pthread_mutex_lock(&self->lock);
+        if (CDS_IS_ERROR(status) && !CDS_IS_ERROR(self->status))
+            self->status = status;
+        if (++self->finished == self->task_count)
+            pthread_cond_signal(&self->done);
+    }
+}
+
+CDS_PRIVATE
+void *_cds_thread_pool_worker(void *argument) {
+    cds_thread_pool_t *self = argument;
+    pthread_mutex_lock(&self->lock);
+    for (;;) {
+        _cds_thread_pool_work(self);
+        if (self->stopping)
+            break;
+        pthread_cond_wait(&self->wake, &self->lock);
+    }
+    pthread_mutex_unlock(&self->lock);
+    return NULL;
+}
+
+/**
+ * @brief Stop and join the first `started` workers, then free the pool.
+ */
+CDS_PRIVATE
+void _cds_thread_pool_stop(cds_thread_pool_t *self, size_t started) {
+    pthread_mutex_lock(&self->lock);
+    self->stopping = true;
+    pthread_cond_broadcast(&self->wake);
+    pthread_mutex_unlock(&self->lock);
+    size_t index = 0;
+    for (; index < started; index++)
+        pthread_join(self->threads[index], NULL);
+    free(self->threads);
+    self->threads = NULL;
+    pthread_cond_destroy(&self->done);
+    pthread_cond_destroy(&self->wake);
+    pthread_mutex_destroy(&self->lock);
+    pthread_mutex_destroy(&self->submit);
+}
+
+CDS_PRIVATE
+size_t _cds_par_processors(void) {
+#ifdef _SC_NPROCESSORS_ONLN
+    long processors = sysconf(_SC_NPROCESSORS_ONLN);
+    if (processors > 0)
+        return (size_t) processors;
+#endif
+    return 1;
+}
+
+CDS_PRIVATE
+size_t _cds_par_cache_bytes(void) {
+#ifdef _SC_LEVEL2_CACHE_SIZE
+    long bytes = sysconf(_SC_LEVEL2_CACHE_SIZE);
+    if (bytes > 0)
+        return (size_t) bytes;
+#endif
+    return CDS_PAR_CHUNK_BYTES;
+}
+
+CDS_PUBLIC
+cds_status_t cds_thread_pool_init(cds_thread_pool_t *self, size_t threads) {
+    CDS_IF_NULL_RETURN_ERROR(self);
+    if (threads == 0)
+        threads = _cds_par_processors();
+    self->threads = malloc(threads * sizeof(pthread_t));
+    CDS_IF_NULL_RETURN_ALLOC_ERROR(self->threads);
+    self->thread_count = threads;
+    self->chunk_bytes = _cds_par_cache_bytes();
+    self->task = NULL;
+    self->context = NULL;
+    self->task_count = 0;
+    self->next_task = 0;
+    self->finished = 0;
+    self->status = cds_ok;
+    self->stopping = false;
+    pthread_mutex_init(&self->submit, NULL);
+    pthread_mutex_init(&self->lock, NULL);
+    pthread_cond_init(&self->wake, NULL);
+    pthread_cond_init(&self->done, NULL);
+    size_t index = 0;
+    for (; index < threads - 1; index++) {
+        if (pthread_create(
+            &self->threads[index],
+            NULL,
+            _cds_thread_pool_worker,
+            self
+        ) != 0) {
+            _cds_thread_pool_stop(self, index);
+            return cds_error;
+        }
+    }
+    return cds_ok;
+}
+
+CDS_PUBLIC
+cds_status_t cds_thread_pool_destroy(cds_thread_pool_t *self) {
+    CDS_IF_NULL_RETURN_ERROR(self);
+    CDS_IF_NULL_RETURN_ERROR(self->threads);
+    _cds_thread_pool_stop(self, self->thread_count - 1);
+    return cds_ok;
+}
+
+static cds_thread_pool_t _cds_default_pool;
+static cds_status_t _cds_default_pool_status = cds_error;
+static pthread_once_t _cds_default_pool_once = PTHREAD_ONCE_INIT;
+
+CDS_PRIVATE
+void _cds_thread_pool_start_default(void) {
+    _cds_default_pool_status = cds_thread_pool_init(&_cds_default_pool, 0);
+}
+
+CDS_PUBLIC
+cds_thread_pool_t *cds_thread_pool_default(void) {
+    pthread_once(&_cds_default_pool_once, _cds_thread_pool_start_default);
+    if (CDS_IS_ERROR(_cds_default_pool_status))
+        return NULL;
+    return &_cds_default_pool;
+}
+
+CDS_PUBLIC
+cds_status_t cds_thread_pool_run(
+    cds_thread_pool_t *self,
+    cds_task_f task,
+    cds_ptr_t context,
+    size_t count
+) {
+    if (self == NULL)
+        self = cds_thread_pool_default();
+    CDS_IF_NULL_RETURN_ERROR(self);
+    CDS_IF_NULL_RETURN_ERROR(task);
+    if (count == 0)
+        return cds_ok;
+    CDS_NEW_STATUS = cds_ok;
+    if (count == 1 || self->thread_count == 1) {
+        size_t index = 0;
+        for (; index < count; index++) {
+            cds_status_t result = task(context, index);
+            if (CDS_IS_ERROR(result) && !CDS_IS_ERROR(status))
+                status = result;
+        }
+        return status;
+    }
+    pthread_mutex_lock(&self->submit);
+    pthread_mutex_lock(&self->lock);
+    self->task = task;
+    self->context = context;
+    self->task_count = count;
+    self->next_task = 0;
+    self->finished = 0;
+    self->status = cds_ok;
+    pthread_cond_broadcast(&self->wake);
+    _cds_thread_pool_work(self);
+    while (self->finished < self->task_count)
+        pthread_cond_wait(&self->done, &self->lock);
+    status = self->status;
+    self->task_count = 0;
+    self->next_task = 0;
+    pthread_mutex_unlock(&self->lock);
+    pthread_mutex_unlock(&self->submit);
+    return status;
+}
+
+/**
+ * @brief Fill in the fields every job needs and return the number of chunks.
+ */
+CDS_PRIVATE
+size_t _cds_par_job_init(
+    _cds_par_job_t *job,
+    cds_thread_pool_t *pool,
+    cds_span_t span
+) {
+    memset(job, 0, sizeof(*job));
+    job->data = span.data;
+    job->length = span.length;
+    job->type_size = span.type_size;
+    job->grain = pool->chunk_bytes / span.type_size;
+    if (job->grain == 0)
+        job->grain = 1;
+    return (span.length + job->grain - 1) / job->grain;
+}
+
+/**
+ * @brief Get the range of elements [*begin, *end) in a chunk.
+ */
+CDS_INLINE
+void _cds_par_chunk(
+    _cds_par_job_t *job,
+    size_t chunk,
+    size_t *begin,
+    size_t *end
+) {
+    *begin = chunk * job->grain;
+    *end = job->length - *begin < job->grain
+        ? job->length
+        : *begin + job->grain;
+}
+
+CDS_PRIVATE
+cds_status_t _cds_par_for_each_task(cds_ptr_t context, size_t chunk) {
+    _cds_par_job_t *job = context;
+    size_t begin, end;
+    _cds_par_chunk(job, chunk, &begin, &end);
+    cds_byte_t *element = _AT(job->data, begin, job->type_size);
+    cds_byte_t *last = _AT(job->data, end, job->type_size);
+    for (; element < last; element += job->type_size)
+        job->apply(element, job->context);
+    return cds_ok;
+}
+
+CDS_PUBLIC
+cds_status_t cds_par_for_each(
+    cds_thread_pool_t *pool,
+    cds_span_t span,
+    cds_apply_f apply,
+    cds_ptr_t context
+) {
+    CDS_IF_NULL_RETURN_ERROR(apply);
+    CDS_IF_ZERO_RETURN_ERROR(span.type_size);
+    if (span.length == 0)
+        return cds_ok;
+    CDS_IF_NULL_RETURN_ERROR(span.data);
+    if (pool == NULL)
+        pool = cds_thread_pool_default();
+    CDS_IF_NULL_RETURN_ERROR(pool);
+    _cds_par_job_t job;
+    size_t chunks = _cds_par_job_init(&job, pool, span);
+    job.apply = apply;
+    job.context = context;
+    return cds_thread_pool_run(pool, _cds_par_for_each_task, &job, chunks);
+}
+
+/**
+ * @brief Fold the elements of a chunk into its accumulator, starting from
+ * the identity element.
+ */
+CDS_PRIVATE
+cds_status_t _cds_par_reduce_task(cds_ptr_t context, size_t chunk) {
+    _cds_par_job_t *job = context;
+    size_t begin, end;
+    _cds_par_chunk(job, chunk, &begin, &end);
+    cds_byte_t *accumulator = _AT(job->partials, chunk, job->type_size);
+    cds_byte_t *element = _AT(job->data, begin, job->type_size);
+    cds_byte_t *last = _AT(job->data, end, job->type_size);
+    memcpy(accumulator, job->identity, job->type_size);
+    for (; element < last; element += job->type_size)
+        job->combine(accumulator, element);
+    return cds_ok;
+}
+
+CDS_PUBLIC
+cds_status_t cds_par_reduce(
+    cds_thread_pool_t *pool,
+    cds_span_t span,
+    cds_ptr_t identity,
+    cds_combine_f combine,
+    cds_ptr_t result
+) {
+    CDS_IF_NULL_RETURN_ERROR(identity);
+    CDS_IF_NULL_RETURN_ERROR(combine);
+    CDS_IF_NULL_RETURN_ERROR(result);
+    CDS_IF_ZERO_RETURN_ERROR(span.type_size);
+    if (span.length == 0) {
+        memcpy(result, identity, span.type_size);
+        return cds_ok;
+    }
+    CDS_IF_NULL_RETURN_ERROR(span.data);
+    if (pool == NULL)
+        pool = cds_thread_pool_default();
+    CDS_IF_NULL_RETURN_ERROR(pool);
+    _cds_par_job_t job;
+    size_t chunks = _cds_par_job_init(&job, pool, span);
+    job.combine = combine;
+    job.identity = identity;
+    job.partials = malloc(chunks * span.type_size);
+    CDS_IF_NULL_RETURN_ALLOC_ERROR(job.partials);
+    CDS_NEW_STATUS = cds_thread_pool_run(
+        pool,
+        _cds_par_reduce_task,
+        &job,
+        chunks
+    );
+    if (!CDS_IS_ERROR(status)) {
+        // Fold the chunks together in order so that the result does not
+        // depend on which thread finished first.
+        memcpy(result, job.partials, span.type_size);
+        size_t chunk = 1;
+        for (; chunk < chunks; chunk++)
+            combine(result, _AT(job.partials, chunk, span.type_size));
+    }
+    free(job.partials);
+    return status;
+}
+
+/**
+ * @brief Replace each element of a chunk with the fold of itself and every
+ * element before it, where the chunk's accumulator holds the fold of every
+ * chunk before it.
+ */
+CDS_PRIVATE
+cds_status_t _cds_par_scan_task(cds_ptr_t context, size_t chunk) {
+    _cds_par_job_t *job = context;
+    size_t begin, end;
+    _cds_par_chunk(job, chunk, &begin, &end);
+    cds_byte_t *accumulator = _AT(job->partials, chunk, job->type_size);
+    cds_byte_t *element = _AT(job->data, begin, job->type_size);
+    cds_byte_t *last = _AT(job->data, end, job->type_size);
+    for (; element < last; element += job->type_size) {
+        job->combine(accumulator, element);
+        memcpy(element, accumulator, job->type_size);
+    }
+    return cds_ok;
+}
+
+CDS_PUBLIC
+cds_status_t cds_par_inclusive_scan(
+    cds_thread_pool_t *pool,
+    cds_span_t span,
+    cds_ptr_t identity,
+    cds_combine_f combine
+) {
+    CDS_IF_NULL_RETURN_ERROR(identity);
+    CDS_IF_NULL_RETURN_ERROR(combine);
+    CDS_IF_ZERO_RETURN_ERROR(span.type_size);
+    if (span.length == 0)
+        return cds_ok;
+    CDS_IF_NULL_RETURN_ERROR(span.data);
+    if (pool == NULL)
+        pool = cds_thread_pool_default();
+    CDS_IF_NULL_RETURN_ERROR(pool);
+    _cds_par_job_t job;
+    size_t chunks = _cds_par_job_init(&job, pool, span);
+    size_t type_size = span.type_size;
+    job.combine = combine;
+    job.identity = identity;
+    // One accumulator per chunk, plus room for the running total and the
+    // total of the chunk being visited.
+    job.partials = malloc((chunks + 2) * type_size);
+    CDS_IF_NULL_RETURN_ALLOC_ERROR(job.partials);
+    // The total of the last chunk is never needed.
+    CDS_NEW_STATUS = cds_thread_pool_run(
+        pool,
+        _cds_par_reduce_task,
+        &job,
+        chunks - 1
+    );
+    if (!CDS_IS_ERROR(status)) {
+        // Turn the total of each chunk into the total of every chunk before
+        // it. The last chunk only takes the running total, since its own
+        // total was never computed.
+        cds_byte_t *running = _AT(job.partials, chunks, type_size);
+        cds_byte_t *total = _AT(job.partials, chunks + 1, type_size);
+        memcpy(running, identity, type_size);
+        size_t chunk = 0;
+        for (; chunk + 1 < chunks; chunk++) {
+            cds_byte_t *partial = _AT(job.partials, chunk, type_size);
+            memcpy(total, partial, type_size);
+            memcpy(partial, running, type_size);
+            combine(running, total);
+        }
+        memcpy(_AT(job.partials, chunk, type_size), running, type_size);
+        status = cds_thread_pool_run(pool, _cds_par_scan_task, &job, chunks);
+    }
+    free(job.partials);
+    return status;
+}
+
+CDS_PRIVATE
+cds_status_t _cds_par_sort_task(cds_ptr_t context, size_t chunk) {
+    _cds_par_job_t *job = context;
+    size_t begin, end;
+    _cds_par_chunk(job, chunk, &begin, &end);
+    return cds_sort(
+        _AT(job->data, begin, job->type_size),
+        end - begin,
+        job->type_size,
+        job->compare
+    );
+}
+
+/**
+ * @brief Find how many of the first `rank` elements of the merge of 2 sorted
+ * runs come from the first run. Elements of the first run come before equal
+ * elements of the second.
+ */
+CDS_PRIVATE
+size_t _cds_par_co_rank(
+    _cds_par_job_t *job,
+    cds_byte_t *first,
+    size_t first_length,
+    cds_byte_t *second,
+    size_t second_length,
+    size_t rank
+) {
+    size_t type_size = job->type_size;
+    size_t low = rank > second_length ? rank - second_length : 0;
+    size_t high = rank < first_length ? rank : first_length;
+    while (low < high) {
+        size_t taken = low + (high - low) / 2;
+        if (job->compare(
+            _AT(first, taken, type_size),
+            _AT(second, rank - taken - 1, type_size)
+        ) <= 0)
+            low = taken + 1;
+        else
+            high = taken;
+    }
+    return low;
+}
+
+/**
+ * @brief Write one chunk of the merge of the 2 runs which the chunk falls
+ * in from `src` to `dest`. Runs are `width` elements long and the chunks of
+ * a merge never cross into the next pair of runs because `width` is a
+ * multiple of the chunk size.
+ */
+CDS_PRIVATE
+cds_status_t _cds_par_merge_task(cds_ptr_t context, size_t chunk) {
+    _cds_par_job_t *job = context;
+    size_t type_size = job->type_size;
+    size_t begin, end;
+    _cds_par_chunk(job, chunk, &begin, &end);
+    size_t pair = begin - begin % (2 * job->width);
+    size_t middle = job->length - pair < job->width
+        ? job->length
+        : pair + job->width;
+    size_t pair_end = job->length - middle < job->width
+        ? job->length
+        : middle + job->width;
+    cds_byte_t *first = _AT(job->src, pair, type_size);
+    cds_byte_t *second = _AT(job->src, middle, type_size);
+    size_t first_length = middle - pair;
+    size_t second_length = pair_end - middle;
+    size_t index = _cds_par_co_rank(
+        job, first, first_length, second, second_length, begin - pair
+    );
+    size_t first_end = _cds_par_co_rank(
+        job, first, first_length, second, second_length, end - pair
+    );
+    size_t other = begin - pair - index;
+    size_t other_end = end - pair - first_end;
+    cds_byte_t *dest = _AT(job->dest, begin, type_size);
+    while (index < first_end && other < other_end) {
+        cds_byte_t *a = _AT(first, index, type_size);
+        cds_byte_t *b = _AT(second, other, type_size);
+        if (job->compare(b, a) < 0) {
+            memcpy(dest, b, type_size);
+            ++other;
+        } else {
+            memcpy(dest, a, type_size);
+            ++index;
+        }
+        dest += type_size;
+    }
+    memcpy(
+        dest,
+        _AT(first, index, type_size),
+        (first_end - index) * type_size
+    );
+    dest += (first_end - index) * type_size;
+    memcpy(
+        dest,
+        _AT(second, other, type_size),
+        (other_end - other) * type_size
+    );
+    return cds_ok;
+}
+
+CDS_PRIVATE
+cds_status_t _cds_par_copy_task(cds_ptr_t context, size_t chunk) {
+    _cds_par_job_t *job = context;
+    size_t begin, end;
+    _cds_par_chunk(job, chunk, &begin, &end);
+    memcpy(
+        _AT(job->dest, begin, job->type_size),
+        _AT(job->src, begin, job->type_size),
+        (end - begin) * job->type_size
+    );
+    return cds_ok;
+}
+
+CDS_PUBLIC
+cds_status_t cds_par_sort(
+    cds_thread_pool_t *pool,
+    cds_span_t span,
+    cds_compare_f compare
+) {
+    CDS_IF_NULL_RETURN_ERROR(compare);
+    CDS_IF_ZERO_RETURN_ERROR(span.type_size);
+    if (span.length < 2)
+        return cds_ok;
+    CDS_IF_NULL_RETURN_ERROR(span.data);
+    if (pool == NULL)
+        pool = cds_thread_pool_default();
+    CDS_IF_NULL_RETURN_ERROR(pool);
+    _cds_par_job_t job;
+    size_t chunks = _cds_par_job_init(&job, pool, span);
+    job.compare = compare;
+    if (chunks == 1)
+        return cds_sort(span.data, span.length, span.type_size, compare);
+    cds_byte_t *scratch = malloc(span.length * span.type_size);
+    CDS_IF_NULL_RETURN_ALLOC_ERROR(scratch);
+    CDS_NEW_STATUS = cds_thread_pool_run(
+        pool,
+        _cds_par_sort_task,
+        &job,
+        chunks
+    );
+    job.src = span.data;
+    job.dest = scratch;
+    job.width = job.grain;
+    while (!CDS_IS_ERROR(status) && job.width < span.length) {
+        status = cds_thread_pool_run(pool, _cds_par_merge_task, &job, chunks);
+        cds_byte_t *swap = job.src;
+        job.src = job.dest;
+        job.dest = swap;
+        job.width = job.width > span.length / 2
+            ? span.length
+            : 2 * job.width;
+    }
+    if (!CDS_IS_ERROR(status) && job.src != span.data) {
+        // An odd number of merges left the elements in the scratch array.
+        job.dest = span.data;
+        status = cds_thread_pool_run(pool, _cds_par_copy_task, &job, chunks);
+    }
+    free(scratch);
+    return status;
+}
@@ -0,0 +1,189 @@
+#include <stdio.h>
+#include <string.h>
+#include <CDataStructures/serialize.h>
+
+#define _CDS_CHECKSUM_SEED UINT64_C(0xcbf29ce484222325)
+#define _CDS_CHECKSUM_PRIME UINT64_C(0x100000001b3)
+
+/**
+ * @brief Mix whole 32-byte blocks into the lanes of a checksum and get the
+ * number of bytes which were used.
+ */
+CDS_INLINE
+size_t _cds_serial_checksum_blocks(
+    uint64_t *lanes,
+    const cds_byte_t *current,
+    size_t bytes
+) {
+    size_t used = 0;
+    // 4 independent lanes keep the multiplications from waiting on each
+    // other.
+    while (bytes - used >= 4 * sizeof(uint64_t)) {
+        uint64_t words[4];
+        memcpy(words, current + used, sizeof(words));
+        lanes[0] = (lanes[0] ^ words[0]) * _CDS_CHECKSUM_PRIME;
+        lanes[1] = (lanes[1] ^ words[1]) * _CDS_CHECKSUM_PRIME;
+        lanes[2] = (lanes[2] ^ words[2]) * _CDS_CHECKSUM_PRIME;
+        lanes[3] = (lanes[3] ^ words[3]) * _CDS_CHECKSUM_PRIME;
+        used += sizeof(words);
+    }
+    return used;
+}
+
+CDS_PUBLIC
+void cds_serial_checksum_init(cds_serial_checksum_t *self, size_t bytes) {
+    uint64_t hash = _CDS_CHECKSUM_SEED ^ (uint64_t) bytes;
+    self->lanes[0] = hash;
+    self->lanes[1] = hash + 1;
+    self->lanes[2] = hash + 2;
+    self->lanes[3] = hash + 3;
+    self->pending_bytes = 0;
+}
+
+CDS_PUBLIC
+void cds_serial_checksum_update(
+    cds_serial_checksum_t *self,
+    cds_ptr_t data,
+    size_t bytes
+) {
+    const cds_byte_t *current = data;
+    if (bytes == 0)
+        return;
+    if (self->pending_bytes > 0) {
+        // Top up the block left over from the last piece first.
+        size_t missing = sizeof(self->pending) - self->pending_bytes;
+        size_t taken = bytes < missing ? bytes : missing;
+        memcpy(self->pending + self->pending_bytes, current, taken);
+        self->pending_bytes += taken;
+        current += taken;
+        bytes -= taken;
+        if (self->pending_bytes < sizeof(self->pending))
+            return;
+        _cds_serial_checksum_blocks(
+            self->lanes,
+            self->pending,
+            sizeof(self->pending)
+        );
+        self->pending_bytes = 0;
+    }
+    size_t used = _cds_serial_checksum_blocks(self->lanes, current, bytes);
+    memcpy(self->pending, current + used, bytes - used);
+    self->pending_bytes = bytes - used;
+}
+
+CDS_PUBLIC
+uint64_t cds_serial_checksum_finish(cds_serial_checksum_t *self) {
+    uint64_t hash = self->lanes[0];
+    size_t lane = 1;
+    for (; lane < 4; lane++)
+        hash = (hash ^ self->lanes[lane]) * _CDS_CHECKSUM_PRIME;
+    for (lane = 0; lane < self->pending_bytes; lane++)
+        hash = (hash ^ (uint8_t) self->pending[lane]) * _CDS_CHECKSUM_PRIME;
+    return hash;
+}
+
+CDS_PUBLIC
+uint64_t cds_serial_checksum(cds_ptr_t data, size_t bytes) {
+    cds_serial_checksum_t checksum;
+    cds_serial_checksum_init(&checksum, bytes);
+    cds_serial_checksum_update(&checksum, data, bytes);
+    return cds_serial_checksum_finish(&checksum);
+}
+
+CDS_PUBLIC
+cds_status_t cds_serial_write(
+    FILE *file,
+    cds_ptr_t array,
+    size_t length,
+    size_t type_size
+) {
+    return cds_serial_write_split(file, array, length, NULL, 0, type_size);
+}
+
+CDS_PUBLIC
+cds_status_t cds_serial_write_split(
+    FILE *file,
+    cds_ptr_t first,
+    size_t first_length,
+    cds_ptr_t second,
+    size_t second_length,
+    size_t type_size
+) {
+    CDS_IF_NULL_RETURN_ERROR(file);
+    CDS_IF_ZERO_RETURN_ERROR(type_size);
+    if ((first_length > 0 && first == NULL)
+        || (second_length > 0 && second == NULL))
+        return cds_null_error;
+    size_t first_bytes = first_length * type_size;
+    size_t second_bytes = second_length * type_size;
+    cds_serial_checksum_t checksum;
+    cds_serial_checksum_init(&checksum, first_bytes + second_bytes);
+    cds_serial_checksum_update(&checksum, first, first_bytes);
+    cds_serial_checksum_update(&checksum, second, second_bytes);
+    cds_serial_header_t header = {
+        .magic = CDS_SERIAL_MAGIC,
+        .version = CDS_SERIAL_VERSION,
+        .endian_marker = CDS_SERIAL_ENDIAN_MARKER,
+        .type_size = type_size,
+        .length = first_length + second_length,
+        .checksum = cds_serial_checksum_finish(&checksum)
+    };
+    if (fwrite(&header, sizeof(header), 1, file) != 1)
+        return cds_error;
+    if (first_bytes > 0 && fwrite(first, 1, first_bytes, file) != first_bytes)
+        return cds_error;
+    if (second_bytes > 0
+        && fwrite(second, 1, second_bytes, file) != second_bytes)
+        return cds_error;
+    return cds_ok;
+}
+
+CDS_PUBLIC
+cds_status_t cds_serial_read_header(
+    FILE *file,
+    size_t type_size,
+    cds_serial_header_t *header
+) {
+    CDS_IF_NULL_RETURN_ERROR(file);
+    CDS_IF_NULL_RETURN_ERROR(header);
+    if (fread(header, sizeof(*header), 1, file) != 1)
+        return cds_error;
+    if (header->magic != CDS_SERIAL_MAGIC
+        || header->version != CDS_SERIAL_VERSION
+        || header->endian_marker != CDS_SERIAL_ENDIAN_MARKER
+        || header->type_size != type_size)
+        return cds_error;
+    if (header->length > SIZE_MAX / type_size)
+        return cds_alloc_error;
+    // A corrupt length must not make the caller allocate more memory than
+    // the rest of the file could fill.
+    long position = ftell(file);
+    if (position >= 0 && fseek(file, 0, SEEK_END) == 0) {
+        long end = ftell(file);
+        if (fseek(file, position, SEEK_SET) != 0)
+            return cds_error;
+        if (end < position
+            || header->length > (uint64_t) (end - position) / type_size)
+            return cds_error;
+    }
+    return cds_ok;
+}
+
+CDS_PUBLIC
+cds_status_t cds_serial_read_elements(
+    FILE *file,
+    const cds_serial_header_t *header,
+    cds_ptr_t array
+) {
+    CDS_IF_NULL_RETURN_ERROR(file);
+    CDS_IF_NULL_RETURN_ERROR(header);
+    size_t bytes = (size_t) header->length * (size_t) header->type_size;
+    if (bytes > 0) {
+        CDS_IF_NULL_RETURN_ERROR(array);
+        if (fread(array, 1, bytes, file) != bytes)
+            return cds_error;
+    }
+    if (cds_serial_checksum(array, bytes) != header->checksum)
+        return cds_error;
+    return cds_ok;
+}
@@ -4,6 +4,16 @@
 #include <CDataStructures/slist.h>
 
 
+CDS_PRIVATE
+cds_unary_node_t *_cds_slist_new_node(cds_slist_t *self) {
+    return cds_unary_node_new_with_allocator(self->allocator);
+}
+
+CDS_PRIVATE
+void _cds_slist_free_node(cds_slist_t *self, cds_unary_node_t *node) {
+    cds_allocator_free(self->allocator, node, sizeof(cds_unary_node_t));
+}
+
 CDS_PRIVATE
 cds_unary_node_t *_cds_slist_get_node(
     cds_slist_t *self,
@@ -17,11 +27,11 @@ cds_status_t _cds_slist_push_front(
     cds_slist_t *self,
     cds_ptr_t data
 ) {
-    cds_unary_node_t *new_node = cds_unary_node_new();
+    cds_unary_node_t *new_node = _cds_slist_new_node(self);
     CDS_IF_NULL_RETURN_ALLOC_ERROR(new_node);
     CDS_NEW_STATUS;
     CDS_IF_STATUS_ERROR(cds_unary_node_init(new_node)) {
-        free(new_node);
+        _cds_slist_free_node(self, new_node);
         return status;
     }
     new_node->data = data;
@@ -36,11 +46,11 @@ cds_status_t _cds_slist_push_back(
     cds_ptr_t data
 ) {
     cds_unary_node_t *end_node = cds_unary_node_get_end(self->head);
-    cds_unary_node_t *new_node = cds_unary_node_new();
+    cds_unary_node_t *new_node = _cds_slist_new_node(self);
     CDS_IF_NULL_RETURN_ALLOC_ERROR(new_node);
     CDS_NEW_STATUS;
     CDS_IF_STATUS_ERROR(cds_unary_node_init(new_node)) {
-        free(new_node);
+        _cds_slist_free_node(self, new_node);
         return status;
     }
     new_node->data = data;
@@ -64,7 +74,7 @@ cds_status_t _cds_slist_pop_front(
     if (data != NULL)
         *data = head->data;
     self->head = next;
-    free(head);
+    _cds_slist_free_node(self, head);
     return cds_ok;
 }
 
@@ -75,8 +85,17 @@ cds_slist_t *cds_slist_new(void) {
 
 CDS_PUBLIC
 cds_status_t cds_slist_init(cds_slist_t *self) {
+    return cds_slist_init_with_allocator(self, NULL);
+}
+
+CDS_PUBLIC
+cds_status_t cds_slist_init_with_allocator(
+    cds_slist_t *self,
+    const cds_allocator_t *allocator
+) {
     CDS_IF_NULL_RETURN_ERROR(self);
     self->head = NULL;
+    self->allocator = allocator;
     return cds_ok;
 }
 
@@ -93,7 +112,11 @@ cds_status_t cds_slist_destroy(cds_slist_t *self, cds_free_f clean_element) {
         return cds_warning;
     cds_unary_node_t *last_head = self->head;
     self->head = NULL;
-    return cds_unary_node_free_all(last_head, clean_element);
+    return cds_unary_node_free_all_with_allocator(
+        last_head,
+        clean_element,
+        self->allocator
+    );
 }
 
 CDS_PUBLIC
@@ -135,15 +158,15 @@ cds_status_t cds_slist_insert(
     CDS_IF_NULL_RETURN_ERROR(self);
     CDS_NEW_STATUS;
     cds_unary_node_t *new_node;
-    CDS_IF_NULL_RETURN_ALLOC_ERROR(new_node = cds_unary_node_new());
+    CDS_IF_NULL_RETURN_ALLOC_ERROR(new_node = _cds_slist_new_node(self));
     CDS_IF_STATUS_ERROR(cds_unary_node_init(new_node)) {
-        free(new_node);
+        _cds_slist_free_node(self, new_node);
         return status;
     }
     new_node->data = data;
     cds_unary_node_t *before = _cds_slist_get_node(self, index - 1);
     if (before == NULL) {
-        free(new_node);
+        _cds_slist_free_node(self, new_node);
         return cds_index_error;
     } else {
         return cds_unary_node_cut_queue(before, new_node);
@@ -178,7 +201,7 @@ cds_status_t cds_slist_remove(
     else {
         cds_unary_node_t *node = cds_unary_node_remove_next(before);
         *data = node->data;
-        free(node);
+        _cds_slist_free_node(self, node);
         return cds_ok;
     }
 }
@@ -207,6 +230,6 @@ cds_status_t cds_slist_pop_back(cds_slist_t *self, cds_ptr_t *data) {
     if (data != NULL)
         *data = hare->data;
     tortoise->next = NULL;
-    free(hare);
+    _cds_slist_free_node(self, hare);
     return cds_ok;
 }
@@ -0,0 +1,575 @@
+#include <stdlib.h>
+#include <string.h>
+#include <CDataStructures/sort.h>
+#include <CDataStructures/utils.h>
+
+/**
+ * @brief The maximum size of an element whose scratch space is kept on the
+ * stack instead of the heap.
+ */
+#define _CDS_SORT_LOCAL_BYTES 64
+
+/**
+ * @brief The maximum number of elements `_cds_sort_partial_insertion` may move
+ * before giving up.
+ */
+#define _CDS_SORT_PARTIAL_LIMIT 8
+
+typedef struct _cds_sort_context_t {
+    cds_byte_t *array;
+    size_t type_size;
+    cds_compare_f compare;
+    cds_byte_t *pivot;
+    cds_byte_t *temp;
+} _cds_sort_context_t;
+
+#define _AT(ctx, index) ((ctx)->array + (index) * (ctx)->type_size)
+#define _LESS(ctx, a, b) ((ctx)->compare((a), (b)) < 0)
+
+/**
+ * @brief Copy one element. Common element sizes get a fixed-size copy which
+ * the compiler can turn into a single load and store.
+ */
+CDS_INLINE
+void _cds_sort_copy(_cds_sort_context_t *ctx, cds_ptr_t dest, cds_ptr_t src) {
+    switch (ctx->type_size) {
+        case 4: memcpy(dest, src, 4); break;
+        case 8: memcpy(dest, src, 8); break;
+        case 16: memcpy(dest, src, 16); break;
+        default: memcpy(dest, src, ctx->type_size); break;
+    }
+}
+
+CDS_INLINE
+void _cds_sort_swap(_cds_sort_context_t *ctx, size_t a, size_t b) {
+    cds_byte_t *x = _AT(ctx, a);
+    cds_byte_t *y = _AT(ctx, b);
+    _cds_sort_copy(ctx, ctx->temp, x);
+    _cds_sort_copy(ctx, x, y);
+    _cds_sort_copy(ctx, y, ctx->temp);
+}
+
+/**
+ * @brief Sort 3 elements so that a <= b <= c.
+ */
+CDS_PRIVATE
+void _cds_sort_3(_cds_sort_context_t *ctx, size_t a, size_t b, size_t c) {
+    if (_LESS(ctx, _AT(ctx, b), _AT(ctx, a)))
+        _cds_sort_swap(ctx, a, b);
+    if (_LESS(ctx, _AT(ctx, c), _AT(ctx, b))) {
+        _cds_sort_swap(ctx, b, c);
+        if (_LESS(ctx, _AT(ctx, b), _AT(ctx, a)))
+            _cds_sort_swap(ctx, a, b);
+    }
+}
+
+/**
+ * @brief Move the element at `current` into its place in the sorted range
+ * [begin, current). Returns the number of elements shifted.
+ */
+CDS_PRIVATE
+size_t _cds_sort_insert_one(
+    _cds_sort_context_t *ctx,
+    size_t begin,
+    size_t current
+) {
+    size_t type_size = ctx->type_size;
+    cds_byte_t *element = _AT(ctx, current);
+    if (!_LESS(ctx, element, element - type_size))
+        return 0;
+    _cds_sort_copy(ctx, ctx->temp, element);
+    size_t sift = current - 1;
+    while (sift > begin && _LESS(ctx, ctx->temp, _AT(ctx, sift - 1)))
+        --sift;
+    memmove(
+        _AT(ctx, sift + 1),
+        _AT(ctx, sift),
+        (current - sift) * type_size
+    );
+    _cds_sort_copy(ctx, _AT(ctx, sift), ctx->temp);
+    return current - sift;
+}
+
+CDS_PRIVATE
+void _cds_sort_insertion(_cds_sort_context_t *ctx, size_t begin, size_t end) {
+    size_t current = begin + 1;
+    for (; current < end; ++current)
+        _cds_sort_insert_one(ctx, begin, current);
+}
+
+/**
+ * @brief Try to insertion sort [begin, end), giving up after a few elements
+ * have been moved. Returns whether the range was fully sorted.
+ */
+CDS_PRIVATE
+bool _cds_sort_partial_insertion(
+    _cds_sort_context_t *ctx,
+    size_t begin,
+    size_t end
+) {
+    size_t moved = 0;
+    size_t current = begin + 1;
+    for (; current < end; ++current) {
+        moved += _cds_sort_insert_one(ctx, begin, current);
+        if (moved > _CDS_SORT_PARTIAL_LIMIT)
+            return current + 1 == end;
+    }
+    return true;
+}
+
+CDS_PRIVATE
+void _cds_sort_sift_down(
+    _cds_sort_context_t *ctx,
+    size_t begin,
+    size_t root,
+    size_t length
+) {
+    for (;;) {
+        size_t child = 2 * root + 1;
+        if (child >= length)
+            return;
+        if (child + 1 < length
+            && _LESS(ctx, _AT(ctx, begin + child), _AT(ctx, begin + child + 1)))
+            ++child;
+        if (!_LESS(ctx, _AT(ctx, begin + root), _AT(ctx, begin + child)))
+            return;
+        _cds_sort_swap(ctx, begin + root, begin + child);
+        root = child;
+    }
+}
+
+CDS_PRIVATE
+void _cds_sort_heap(_cds_sort_context_t *ctx, size_t begin, size_t end) {
+    size_t length = end - begin;
+    size_t root = length / 2;
+    while (root-- > 0)
+        _cds_sort_sift_down(ctx, begin, root, length);
+    while (length > 1) {
+        --length;
+        _cds_sort_swap(ctx, begin, begin + length);
+        _cds_sort_sift_down(ctx, begin, 0, length);
+    }
+}
+
+/**
+ * @brief Partition [begin, end) around the pivot at `begin` so that elements
+ * lesser than the pivot come before it. Returns the final position of the
+ * pivot and sets `already_partitioned` if no elements had to be swapped.
+ */
+CDS_PRIVATE
+size_t _cds_sort_partition_right(
+    _cds_sort_context_t *ctx,
+    size_t begin,
+    size_t end,
+    bool *already_partitioned
+) {
+    cds_byte_t *pivot = ctx->pivot;
+    _cds_sort_copy(ctx, pivot, _AT(ctx, begin));
+    size_t first = begin;
+    size_t last = end;
+    // The median-of-3 guarantees an element not lesser than the pivot at the
+    // end, so this loop is guarded.
+    while (_LESS(ctx, _AT(ctx, ++first), pivot));
+    if (first - 1 == begin) {
+        while (first < last && !_LESS(ctx, _AT(ctx, --last), pivot));
+    } else {
+        while (!_LESS(ctx, _AT(ctx, --last), pivot));
+    }
+    *already_partitioned = first >= last;
+    while (first < last) {
+        _cds_sort_swap(ctx, first, last);
+        while (_LESS(ctx, _AT(ctx, ++first), pivot));
+        while (!_LESS(ctx, _AT(ctx, --last), pivot));
+    }
+    size_t pivot_pos = first - 1;
+    _cds_sort_copy(ctx, _AT(ctx, begin), _AT(ctx, pivot_pos));
+    _cds_sort_copy(ctx, _AT(ctx, pivot_pos), pivot);
+    return pivot_pos;
+}
+
+/**
+ * @brief Partition [begin, end) around the pivot at `begin` so that elements
+ * equal to the pivot come before it. This is used when the pivot is equal to
+ * the element before the range, in which case the equal elements need no
+ * further sorting.
+ */
+CDS_PRIVATE
+size_t _cds_sort_partition_left(
+    _cds_sort_context_t *ctx,
+    size_t begin,
+    size_t end
+) {
+    cds_byte_t *pivot = ctx->pivot;
+    _cds_sort_copy(ctx, pivot, _AT(ctx, begin));
+    size_t first = begin;
+    size_t last = end;
+    while (_LESS(ctx, pivot, _AT(ctx, --last)));
+    if (last + 1 == end) {
+        while (first < last && !_LESS(ctx, pivot, _AT(ctx, ++first)));
+    } else {
+        while (!_LESS(ctx, pivot, _AT(ctx, ++first)));
+    }
+    while (first < last) {
+        _cds_sort_swap(ctx, first, last);
+        while (_LESS(ctx, pivot, _AT(ctx, --last)));
+        while (!_LESS(ctx, pivot, _AT(ctx, ++first)));
+    }
+    _cds_sort_copy(ctx, _AT(ctx, begin), _AT(ctx, last));
+    _cds_sort_copy(ctx, _AT(ctx, last), pivot);
+    return last;
+}
+
+/**
+ * @brief Shuffle some elements around to break up patterns which caused an
+ * unbalanced partition.
+ */
+CDS_PRIVATE
+void _cds_sort_break_patterns(
+    _cds_sort_context_t *ctx,
+    size_t begin,
+    size_t end
+) {
+    size_t size = end - begin;
+    if (size < CDS_SORT_INSERTION_THRESHOLD)
+        return;
+    _cds_sort_swap(ctx, begin, begin + size / 4);
+    _cds_sort_swap(ctx, end - 1, end - size / 4);
+    if (size > CDS_SORT_NINTHER_THRESHOLD) {
+        _cds_sort_swap(ctx, begin + 1, begin + (size / 4 + 1));
+        _cds_sort_swap(ctx, begin + 2, begin + (size / 4 + 2));
+        _cds_sort_swap(ctx, end - 2, end - (size / 4 + 1));
+        _cds_sort_swap(ctx, end - 3, end - (size / 4 + 2));
+    }
+}
+
+CDS_PRIVATE
+void _cds_sort_loop(
+    _cds_sort_context_t *ctx,
+    size_t begin,
+    size_t end,
+    int32_t bad_allowed,
+    bool leftmost
+) {
+    for (;;) {
+        size_t size = end - begin;
+        if (size < CDS_SORT_INSERTION_THRESHOLD) {
+            _cds_sort_insertion(ctx, begin, end);
+            return;
+        }
+        // Move the pivot to the start of the range.
+        size_t half = size / 2;
+        if (size > CDS_SORT_NINTHER_THRESHOLD) {
+            _cds_sort_3(ctx, begin, begin + half, end - 1);
+            _cds_sort_3(ctx, begin + 1, begin + (half - 1), end - 2);
+            _cds_sort_3(ctx, begin + 2, begin + (half + 1), end - 3);
+            _cds_sort_3(ctx, begin + (half - 1), begin + half, begin + (half + 1));
+            _cds_sort_swap(ctx, begin, begin + half);
+        } else {
+            _cds_sort_3(ctx, begin + half, begin, end - 1);
+        }
+        // If the pivot is equal to the element before this range, every
+        // element equal to the pivot is already in place.
+        if (!leftmost && !_LESS(ctx, _AT(ctx, begin - 1), _AT(ctx, begin))) {
+            begin = _cds_sort_partition_left(ctx, begin, end) + 1;
+            continue;
+        }
+        bool already_partitioned;
+        size_t pivot_pos = _cds_sort_partition_right(
+            ctx,
+            begin,
+            end,
+            &already_partitioned
+        );
+        size_t left_size = pivot_pos - begin;
+        size_t right_size = end - (pivot_pos + 1);
+        if (left_size < size / 8 || right_size < size / 8) {
+            if (--bad_allowed <= 0) {
+                _cds_sort_heap(ctx, begin, end);
+                return;
+            }
+            _cds_sort_break_patterns(ctx, begin, pivot_pos);
+            _cds_sort_break_patterns(ctx, pivot_pos + 1, end);
+        } else if (already_partitioned
+            && _cds_sort_partial_insertion(ctx, begin, pivot_pos)
+            && _cds_sort_partial_insertion(ctx, pivot_pos + 1, end)) {
+            return;
+        }
+        // Recurse into the smaller side to keep the stack shallow.
+        if (left_size < right_size) {
+            _cds_sort_loop(ctx, begin, pivot_pos, bad_allowed, leftmost);
+            begin = pivot_pos + 1;
+            leftmost = false;
+        } else {
+            _cds_sort_loop(ctx, pivot_pos + 1, end, bad_allowed, false);
+            end = pivot_pos;
+        }
+    }
+}
+
+/**
+ * @brief Sort the array in linear time if it is already sorted or strictly
+ * descending. Returns whether the array has been sorted.
+ */
+CDS_PRIVATE
+bool _cds_sort_runs(_cds_sort_context_t *ctx, size_t length) {
+    size_t index = 1;
+    if (_LESS(ctx, _AT(ctx, 1), _AT(ctx, 0))) {
+        while (++index < length && _LESS(ctx, _AT(ctx, index), _AT(ctx, index - 1)));
+        if (index != length)
+            return false;
+        size_t low = 0;
+        size_t high = length - 1;
+        for (; low < high; ++low, --high)
+            _cds_sort_swap(ctx, low, high);
+        return true;
+    }
+    while (++index < length && !_LESS(ctx, _AT(ctx, index), _AT(ctx, index - 1)));
+    return index == length;
+}
+
+CDS_PUBLIC
+cds_status_t cds_sort(
+    cds_ptr_t array,
+    size_t length,
+    size_t type_size,
+    cds_compare_f compare
+) {
+    CDS_IF_ZERO_RETURN_ERROR(type_size);
+    CDS_IF_NULL_RETURN_ERROR(compare);
+    if (length < 2)
+        return cds_ok;
+    CDS_IF_NULL_RETURN_ERROR(array);
+    cds_byte_t local[2 * _CDS_SORT_LOCAL_BYTES];
+    cds_byte_t *scratch = local;
+    if (type_size > _CDS_SORT_LOCAL_BYTES) {
+        scratch = malloc(2 * type_size);
+        CDS_IF_NULL_RETURN_ALLOC_ERROR(scratch);
+    }
+    _cds_sort_context_t ctx = {
+        .array = array,
+        .type_size = type_size,
+        .compare = compare,
+        .pivot = scratch,
+        .temp = scratch + type_size
+    };
+    if (!_cds_sort_runs(&ctx, length))
+        _cds_sort_loop(&ctx, 0, length, cds_int_log2(length), true);
+    if (scratch != local)
+        free(scratch);
+    return cds_ok;
+}
+
+CDS_PUBLIC
+bool cds_is_sorted(
+    cds_ptr_t array,
+    size_t length,
+    size_t type_size,
+    cds_compare_f compare
+) {
+    if (array == NULL || compare == NULL || length < 2)
+        return true;
+    cds_byte_t *current = (cds_byte_t *) array + type_size;
+    cds_byte_t *end = (cds_byte_t *) array + length * type_size;
+    for (; current < end; current += type_size) {
+        if (compare(current, current - type_size) < 0)
+            return false;
+    }
+    return true;
+}
+
+CDS_PUBLIC
+size_t cds_lower_bound(
+    cds_ptr_t array,
+    size_t length,
+    size_t type_size,
+    cds_ptr_t key,
+    cds_compare_f compare
+) {
+    if (array == NULL || compare == NULL)
+        return 0;
+    cds_byte_t *base = array;
+    size_t first = 0;
+    while (length > 0) {
+        size_t half = length / 2;
+        if (compare(base + (first + half) * type_size, key) < 0) {
+            first += half + 1;
+            length -= half + 1;
+        } else {
+            length = half;
+        }
+    }
+    return first;
+}
+
+CDS_PUBLIC
+size_t cds_upper_bound(
+    cds_ptr_t array,
+    size_t length,
+    size_t type_size,
+    cds_ptr_t key,
+    cds_compare_f compare
+) {
+    if (array == NULL || compare == NULL)
+        return 0;
+    cds_byte_t *base = array;
+    size_t first = 0;
+    while (length > 0) {
+        size_t half = length / 2;
+        if (compare(key, base + (first + half) * type_size) < 0) {
+            length = half;
+        } else {
+            first += half + 1;
+            length -= half + 1;
+        }
+    }
+    return first;
+}
+
+/**
+ * @brief The number of distinct values in one radix sort digit (one byte).
+ */
+#define _CDS_RADIX 256
+
+CDS_INLINE
+bool _cds_radix_is_little_endian(void) {
+    const uint16_t probe = 1;
+    return *(const uint8_t *) &probe == 1;
+}
+
+/**
+ * @brief Scatter the records from `src` into `dest` ordered by the byte at
+ * `digit_offset` in each record, where `offsets` holds the starting index of
+ * each digit in `dest`.
+ */
+CDS_PRIVATE
+void _cds_radix_scatter(
+    const cds_byte_t *src,
+    cds_byte_t *dest,
+    size_t length,
+    size_t type_size,
+    size_t digit_offset,
+    uint8_t flip,
+    size_t *offsets
+) {
+    const cds_byte_t *record = src;
+    const cds_byte_t *end = src + length * type_size;
+    switch (type_size) {
+#define _SCATTER(size) \
+        for (; record < end; record += (size)) { \
+            uint8_t digit = (uint8_t) record[digit_offset] ^ flip; \
+            memcpy(dest + offsets[digit]++ * (size), record, (size)); \
+        }
+        case 1: _SCATTER(1) break;
+        case 2: _SCATTER(2) break;
+        case 4: _SCATTER(4) break;
+        case 8: _SCATTER(8) break;
+        case 16: _SCATTER(16) break;
+        default: _SCATTER(type_size) break;
+#undef _SCATTER
+    }
+}
+
+CDS_PUBLIC
+cds_status_t cds_radix_sort(
+    cds_ptr_t array,
+    size_t length,
+    size_t type_size,
+    size_t key_offset,
+    size_t key_size,
+    bool is_signed
+) {
+    CDS_IF_ZERO_RETURN_ERROR(type_size);
+    CDS_IF_ZERO_RETURN_ERROR(key_size);
+    if (key_size > sizeof(uint64_t)
+        || key_offset > type_size
+        || key_size > type_size - key_offset)
+        return cds_error;
+    if (length < 2)
+        return cds_ok;
+    CDS_IF_NULL_RETURN_ERROR(array);
+    if (length > SIZE_MAX / type_size)
+        return cds_alloc_error;
+    bool little_endian = _cds_radix_is_little_endian();
+    // Build the histograms of every byte column in one pass.
+    size_t counts[sizeof(uint64_t)][_CDS_RADIX];
+    memset(counts, 0, sizeof(counts));
+    const cds_byte_t *key = (const cds_byte_t *) array + key_offset;
+    const cds_byte_t *end = key + length * type_size;
+    for (; key < end; key += type_size) {
+        size_t digit = 0;
+        for (; digit < key_size; digit++)
+            ++counts[digit][(uint8_t) key[digit]];
+    }
+    cds_byte_t *src = array;
+    cds_byte_t *dest = NULL;
+    size_t digit = 0;
+    for (; digit < key_size; digit++) {
+        // Byte columns from least to most significant.
+        size_t column = little_endian ? digit : key_size - 1 - digit;
+        // The most significant byte of a signed key has its sign bit flipped
+        // so that negative numbers come first.
+        uint8_t flip = (is_signed && digit == key_size - 1) ? 0x80 : 0;
+        size_t *count = counts[column];
+        size_t offsets[_CDS_RADIX];
+        size_t total = 0;
+        size_t value = 0;
+        bool trivial = false;
+        for (; value < _CDS_RADIX; value++) {
+            size_t bucket = count[value ^ flip];
+            if (bucket == length) {
+                trivial = true;
+                break;
+            }
+            offsets[value] = total;
+            total += bucket;
+        }
+        if (trivial)
+            continue;
+        if (dest == NULL) {
+            dest = malloc(length * type_size);
+            CDS_IF_NULL_RETURN_ALLOC_ERROR(dest);
+        }
+        _cds_radix_scatter(
+            src,
+            dest,
+            length,
+            type_size,
+            key_offset + column,
+            flip,
+            offsets
+        );
+        cds_byte_t *swap = src;
+        src = dest;
+        dest = swap;
+    }
+    if (src != array) {
+        // An odd number of passes left the records in the scratch array.
+        memcpy(array, src, length * type_size);
+        dest = src;
+    }
+    free(dest);
+    return cds_ok;
+}
+
+/**
+ * Keys are signed if -1 converted to their type is lesser than 1. Comparing
+ * with 0 instead would make -Wtype-limits warn for every unsigned type, and
+ * the signedness of `char` and `wchar_t` depends on the platform.
+ */
+#define _CDS_RADIX_SORT_DEFINE(stn, ltn) \
+    CDS_PUBLIC cds_status_t \
+    CDS_SMASH_PUBLIC(stn, radix_sort) \
+    (cds_ptr_t array, size_t length, size_t type_size, size_t key_offset) { \
+        return cds_radix_sort( \
+            array, \
+            length, \
+            type_size, \
+            key_offset, \
+            sizeof(ltn), \
+            ((ltn) -1) < (ltn) 1 \
+        ); \
+    }
+
+CDS_INTEGER_TYPES(_CDS_RADIX_SORT_DEFINE)
+
+#undef _CDS_RADIX_SORT_DEFINE
@@ -11,11 +11,19 @@ cds_stack_t *cds_stack_new(void) {
 
 CDS_PUBLIC
 cds_status_t cds_stack_init(cds_stack_t *self) {
+    return cds_stack_init_with_allocator(self, NULL);
+}
+
+CDS_PUBLIC
+cds_status_t cds_stack_init_with_allocator(
+    cds_stack_t *self,
+    const cds_allocator_t *allocator
+) {
     CDS_IF_NULL_RETURN_ERROR(self);
     cds_slist_t *slist = cds_slist_new();
     if (slist == NULL)
         return cds_alloc_error;
-    if (CDS_IS_ERROR(cds_slist_init(slist))) {
+    if (CDS_IS_ERROR(cds_slist_init_with_allocator(slist, allocator))) {
         free(slist);
         return cds_alloc_error;
     }
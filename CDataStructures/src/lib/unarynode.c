@@ -8,7 +8,7 @@ cds_status_t _cds_unary_node_cut_queue(
     cds_unary_node_t *next
 ) {
     cds_unary_node_t *after = before->next;
-    before->next;
+    before->next = next;
     cds_unary_node_get_end(next)->next = after;
     return cds_ok;
 }
@@ -48,7 +48,14 @@ cds_status_t _cds_unary_node_clean_once(
 
 CDS_PUBLIC
 cds_unary_node_t *cds_unary_node_new(void) {
-    return malloc(sizeof(cds_unary_node_t));
+    return cds_unary_node_new_with_allocator(NULL);
+}
+
+CDS_PUBLIC
+cds_unary_node_t *cds_unary_node_new_with_allocator(
+    const cds_allocator_t *allocator
+) {
+    return cds_allocator_alloc(allocator, sizeof(cds_unary_node_t));
 }
 
 CDS_PUBLIC
@@ -146,12 +153,21 @@ CDS_PUBLIC
 cds_status_t cds_unary_node_free_all(
     cds_unary_node_t *node,
     cds_free_f clean_element
+) {
+    return cds_unary_node_free_all_with_allocator(node, clean_element, NULL);
+}
+
+CDS_PUBLIC
+cds_status_t cds_unary_node_free_all_with_allocator(
+    cds_unary_node_t *node,
+    cds_free_f clean_element,
+    const cds_allocator_t *allocator
 ) {
     CDS_NEW_STATUS = cds_ok;
     while (node != NULL) {
         cds_unary_node_t *next = node->next;
         status = _cds_unary_node_clean_once(node, clean_element);
-        free(node);
+        cds_allocator_free(allocator, node, sizeof(cds_unary_node_t));
         node = next;
     }
     return status;
@@ -31,38 +31,133 @@ cds_status_t _cds_vector_copy_from(
     return cds_ok;
 }
 
+CDS_PRIVATE
+bool _cds_vector_is_inline(cds_vector_t *self) {
+    return self->_inline_storage != NULL
+        && self->buffer == self->_inline_storage;
+}
+
+/**
+ * @brief Move the elements back into the inline storage (if they are on the
+ * heap) and use the whole inline storage as the capacity of the vector.
+ */
+CDS_PRIVATE
+cds_status_t _cds_vector_move_inline(cds_vector_t *self) {
+    size_t capacity = self->_inline_bytes / self->type_size;
+    if (!_cds_vector_is_inline(self)) {
+        // The length may not have been updated yet when shrinking, so never
+        // copy more than what fits.
+        size_t length = self->length < capacity ? self->length : capacity;
+        memcpy(
+            self->_inline_storage,
+            self->buffer,
+            length * self->type_size
+        );
+        cds_allocator_free(
+            self->allocator,
+            self->buffer,
+            self->_bytes_allocated
+        );
+        self->buffer = self->_inline_storage;
+    }
+    self->capacity = capacity;
+    self->_bytes_allocated = capacity * self->type_size;
+    return cds_ok;
+}
+
+/**
+ * @brief Move the elements out of the inline storage into a block from the
+ * allocator, so that the array can be handed over to someone else.
+ */
+CDS_PRIVATE
+cds_status_t _cds_vector_spill(cds_vector_t *self) {
+    if (!_cds_vector_is_inline(self))
+        return cds_ok;
+    cds_byte_t *buffer = cds_allocator_alloc(
+        self->allocator,
+        self->_bytes_allocated
+    );
+    CDS_IF_NULL_RETURN_ALLOC_ERROR(buffer);
+    memcpy(buffer, self->buffer, self->length * self->type_size);
+    self->buffer = buffer;
+    return cds_ok;
+}
+
+/**
+ * @brief Move the elements into a block from `malloc` and switch the vector
+ * to `CDS_MALLOC_ALLOCATOR`, so that the array can be given to `free`. Blocks
+ * from other allocators may be mappings or carry headers of their own.
+ */
+CDS_PRIVATE
+cds_status_t _cds_vector_to_malloc(cds_vector_t *self) {
+    if (self->allocator == &CDS_MALLOC_ALLOCATOR)
+        return _cds_vector_spill(self);
+    cds_byte_t *buffer = malloc(self->_bytes_allocated);
+    CDS_IF_NULL_RETURN_ALLOC_ERROR(buffer);
+    memcpy(buffer, self->buffer, self->length * self->type_size);
+    if (!_cds_vector_is_inline(self)) {
+        cds_allocator_free(
+            self->allocator,
+            self->buffer,
+            self->_bytes_allocated
+        );
+    }
+    self->buffer = buffer;
+    self->allocator = &CDS_MALLOC_ALLOCATOR;
+    return cds_ok;
+}
+
+CDS_PRIVATE
+bool _cds_vector_same_allocator(cds_vector_t *self, cds_vector_t *other) {
+    const cds_allocator_t *mine = self->allocator == NULL
+        ? &CDS_DEFAULT_ALLOCATOR
+        : self->allocator;
+    const cds_allocator_t *theirs = other->allocator == NULL
+        ? &CDS_DEFAULT_ALLOCATOR
+        : other->allocator;
+    return mine == theirs;
+}
+
 CDS_PRIVATE
 cds_status_t _cds_vector_realloc_buffer(
     cds_vector_t *self,
     size_t capacity
 ) {
-    cds_array_t new_buffer = realloc(self->buffer, capacity);
-    if (new_buffer == NULL)
+    if (capacity > SIZE_MAX / self->type_size)
         return cds_alloc_error;
+    // Keep at least one element's worth of memory around so that the buffer
+    // never becomes NULL, even if the vector has been shrunk to 0.
+    size_t bytes = (capacity == 0 ? 1 : capacity) * self->type_size;
+    if (bytes <= self->_inline_bytes)
+        return _cds_vector_move_inline(self);
+    cds_array_t new_buffer;
+    if (_cds_vector_is_inline(self)) {
+        // Spill the elements over onto the heap.
+        new_buffer = cds_allocator_alloc(self->allocator, bytes);
+        if (new_buffer == NULL)
+            return cds_alloc_error;
+        memcpy(new_buffer, self->buffer, self->length * self->type_size);
+    } else {
+        new_buffer = cds_allocator_realloc(
+            self->allocator,
+            self->buffer,
+            self->_bytes_allocated,
+            bytes
+        );
+        if (new_buffer == NULL)
+            return cds_alloc_error;
+    }
     self->buffer = new_buffer;
-    self->_bytes_allocated = capacity;
+    self->capacity = capacity;
+    self->_bytes_allocated = bytes;
     return cds_ok;
 }
 
 CDS_PRIVATE
-cds_status_t _cds_vector_reallocate(
-    cds_vector_t *self,
-    size_t length
-) {
-    size_t recommended = _cds_recommended_capacity(length) * self->type_size;
-    return _cds_vector_realloc_buffer(self, recommended);
-}
-
-CDS_PRIVATE
-cds_status_t _cds_vector_lazy_reallocate(
-    cds_vector_t *self,
-    size_t length
-) {
-    size_t recommended = _cds_recommended_capacity(length) * self->type_size;
-    if (self->_bytes_allocated != recommended)
-        return _cds_vector_realloc_buffer(self, recommended);
-    else
+cds_status_t _cds_vector_reserve(cds_vector_t *self, size_t capacity) {
+    if (capacity <= self->capacity)
         return cds_ok;
+    return _cds_vector_realloc_buffer(self, capacity);
 }
 
 CDS_PRIVATE
@@ -70,9 +165,35 @@ cds_status_t _cds_vector_change_length(
     cds_vector_t *self,
     size_t new_length
 ) {
-    cds_status_t status = _cds_vector_lazy_reallocate(self, new_length);
-    if (CDS_IS_ERROR(status))
-        return status;
+    if (new_length > self->capacity) {
+        cds_status_t status = _cds_vector_reserve(
+            self,
+            cds_growth_policy_grow(
+                self->policy,
+                self->capacity,
+                new_length,
+                self->type_size,
+                0
+            )
+        );
+        if (CDS_IS_ERROR(status))
+            return status;
+    } else if (cds_growth_policy_should_shrink(
+        self->policy,
+        new_length,
+        self->capacity,
+        self->type_size
+    )) {
+        size_t capacity = cds_growth_policy_shrink(
+            self->policy,
+            new_length,
+            self->type_size,
+            0
+        );
+        // Failing to give memory back is not an error.
+        if (capacity < self->capacity)
+            _cds_vector_realloc_buffer(self, capacity);
+    }
     self->length = new_length;
     return cds_ok;
 }
@@ -101,7 +222,7 @@ cds_status_t _cds_vector_make_gap(
     size_t block_size = (self->length - index) * self->type_size;
     cds_byte_t *old_location = _cds_vector_get(self, index);
     cds_byte_t *new_location = old_location + self->type_size;
-    memcpy(new_location, old_location, block_size);
+    memmove(new_location, old_location, block_size);
     return cds_ok;
 }
 
@@ -115,7 +236,7 @@ cds_status_t _cds_vector_close_gap(
     size_t block_size = (self->length - index - 1) * self->type_size;
     cds_byte_t *new_location = _cds_vector_get(self, index);
     cds_byte_t *old_location = new_location + self->type_size;
-    memcpy(new_location, old_location, block_size);
+    memmove(new_location, old_location, block_size);
     return cds_ok;
 }
 
@@ -135,16 +256,81 @@ cds_vector_t *cds_vector_new(void) {
 
 CDS_PUBLIC
 cds_status_t cds_vector_init(cds_vector_t *self, size_t type_size) {
+    return cds_vector_init_with_policy(self, type_size, NULL);
+}
+
+CDS_PUBLIC
+cds_status_t cds_vector_init_with_policy(
+    cds_vector_t *self,
+    size_t type_size,
+    const cds_growth_policy_t *policy
+) {
+    return cds_vector_init_with_allocator(self, type_size, policy, NULL);
+}
+
+CDS_PUBLIC
+cds_status_t cds_vector_init_with_allocator(
+    cds_vector_t *self,
+    size_t type_size,
+    const cds_growth_policy_t *policy,
+    const cds_allocator_t *allocator
+) {
     CDS_IF_NULL_RETURN_ERROR(self);
     CDS_IF_ZERO_RETURN_ERROR(type_size);
     self->type_size = type_size;
-    self->_bytes_allocated = _cds_recommended_capacity(0) * self->type_size;
-    self->buffer = malloc(self->_bytes_allocated);
+    self->policy = policy;
+    self->allocator = allocator;
+    self->_inline_storage = NULL;
+    self->_inline_bytes = 0;
+    self->capacity = cds_growth_policy_grow(policy, 0, 0, type_size, 0);
+    if (self->capacity == 0)
+        self->capacity = 1;
+    self->_bytes_allocated = self->capacity * self->type_size;
+    self->buffer = cds_allocator_alloc(allocator, self->_bytes_allocated);
     self->length = 0;
     CDS_IF_NULL_RETURN_ALLOC_ERROR(self->buffer);
     return cds_ok;
 }
 
+CDS_PUBLIC
+cds_status_t cds_vector_init_inline(
+    cds_vector_t *self,
+    size_t type_size,
+    cds_ptr_t storage,
+    size_t bytes
+) {
+    CDS_IF_NULL_RETURN_ERROR(self);
+    CDS_IF_ZERO_RETURN_ERROR(type_size);
+    if (storage == NULL || bytes < type_size)
+        return cds_vector_init(self, type_size);
+    self->type_size = type_size;
+    self->policy = NULL;
+    self->allocator = NULL;
+    self->_inline_storage = storage;
+    self->_inline_bytes = bytes;
+    self->buffer = storage;
+    self->length = 0;
+    self->capacity = bytes / type_size;
+    self->_bytes_allocated = self->capacity * type_size;
+    return cds_ok;
+}
+
+CDS_PUBLIC
+cds_status_t cds_small_vector_init(cds_small_vector_t *self, size_t type_size) {
+    CDS_IF_NULL_RETURN_ERROR(self);
+    return cds_vector_init_inline(
+        &self->vector,
+        type_size,
+        self->storage.bytes,
+        sizeof(self->storage.bytes)
+    );
+}
+
+CDS_PUBLIC
+bool cds_vector_is_inline(cds_vector_t *self) {
+    return self != NULL && _cds_vector_is_inline(self);
+}
+
 CDS_PUBLIC
 cds_status_t cds_vector_destroy(cds_vector_t *self, cds_free_f clean_element) {
     if (self == NULL)
@@ -156,9 +342,18 @@ cds_status_t cds_vector_destroy(cds_vector_t *self, cds_free_f clean_element) {
                 clean_element(_cds_vector_get(self, index));
             }
         }
-        free(self->buffer);
+        if (!_cds_vector_is_inline(self)) {
+            cds_allocator_free(
+                self->allocator,
+                self->buffer,
+                self->_bytes_allocated
+            );
+        }
         self->buffer = NULL;
     }
+    self->length = 0;
+    self->capacity = 0;
+    self->_bytes_allocated = 0;
     return cds_ok;
 }
 
@@ -171,6 +366,148 @@ cds_status_t cds_vector_free(cds_vector_t *self, cds_free_f clean_element) {
     return status;
 }
 
+CDS_PUBLIC
+size_t cds_vector_capacity(cds_vector_t *self) {
+    if (self == NULL || self->buffer == NULL)
+        return 0;
+    return self->capacity;
+}
+
+CDS_PUBLIC
+cds_status_t cds_vector_reserve(cds_vector_t *self, size_t amount) {
+    if (self == NULL || self->buffer == NULL)
+        return cds_null_error;
+    if (amount > SIZE_MAX - self->length)
+        return cds_alloc_error;
+    return _cds_vector_reserve(self, self->length + amount);
+}
+
+CDS_PUBLIC
+cds_status_t cds_vector_shrink_to_fit(cds_vector_t *self) {
+    if (self == NULL || self->buffer == NULL)
+        return cds_null_error;
+    if (self->length == self->capacity)
+        return cds_ok;
+    return _cds_vector_realloc_buffer(self, self->length);
+}
+
+CDS_PUBLIC
+cds_status_t cds_vector_adopt(
+    cds_vector_t *self,
+    cds_ptr_t array,
+    size_t length,
+    size_t capacity
+) {
+    CDS_IF_NULL_RETURN_ERROR(self);
+    CDS_IF_NULL_RETURN_ERROR(array);
+    if (capacity == 0 || capacity < length)
+        return cds_error;
+    if (capacity > SIZE_MAX / self->type_size)
+        return cds_alloc_error;
+    if (self->buffer != NULL && !_cds_vector_is_inline(self)) {
+        cds_allocator_free(
+            self->allocator,
+            self->buffer,
+            self->_bytes_allocated
+        );
+    }
+    self->buffer = array;
+    self->allocator = &CDS_MALLOC_ALLOCATOR;
+    self->length = length;
+    self->capacity = capacity;
+    self->_bytes_allocated = capacity * self->type_size;
+    return cds_ok;
+}
+
+CDS_PUBLIC
+cds_ptr_t cds_vector_release(
+    cds_vector_t *self,
+    size_t *length,
+    size_t *capacity
+) {
+    if (self == NULL || self->buffer == NULL)
+        return NULL;
+    if (CDS_IS_ERROR(_cds_vector_to_malloc(self)))
+        return NULL;
+    cds_ptr_t array = self->buffer;
+    if (length != NULL)
+        *length = self->length;
+    if (capacity != NULL)
+        *capacity = self->_bytes_allocated / self->type_size;
+    self->buffer = NULL;
+    self->length = 0;
+    self->capacity = 0;
+    self->_bytes_allocated = 0;
+    return array;
+}
+
+CDS_PUBLIC
+cds_status_t cds_vector_swap(cds_vector_t *self, cds_vector_t *other) {
+    if (self == NULL || self->buffer == NULL)
+        return cds_null_error;
+    if (other == NULL || other->buffer == NULL)
+        return cds_null_error;
+    if (self == other)
+        return cds_ok;
+    CDS_NEW_STATUS = cds_ok;
+    CDS_IF_ERROR_RETURN_STATUS(_cds_vector_spill(self));
+    CDS_IF_ERROR_RETURN_STATUS(_cds_vector_spill(other));
+    // The inline storage belongs to the struct it lives in, so it stays put.
+    cds_byte_t *inline_storage = self->_inline_storage;
+    size_t inline_bytes = self->_inline_bytes;
+    cds_vector_t swap = *self;
+    *self = *other;
+    *other = swap;
+    other->_inline_storage = self->_inline_storage;
+    other->_inline_bytes = self->_inline_bytes;
+    self->_inline_storage = inline_storage;
+    self->_inline_bytes = inline_bytes;
+    return cds_ok;
+}
+
+CDS_PUBLIC
+cds_status_t cds_vector_append_move(cds_vector_t *self, cds_vector_t *other) {
+    if (self == NULL || self->buffer == NULL)
+        return cds_null_error;
+    if (other == NULL || other->buffer == NULL)
+        return cds_null_error;
+    if (self == other || self->type_size != other->type_size)
+        return cds_error;
+    if (other->length == 0)
+        return cds_ok;
+    if (self->length == 0
+        && !_cds_vector_is_inline(self)
+        && !_cds_vector_is_inline(other)
+        && _cds_vector_same_allocator(self, other)) {
+        // Trade arrays so that `other` is left with the empty one.
+        cds_byte_t *buffer = self->buffer;
+        size_t capacity = self->capacity;
+        size_t bytes_allocated = self->_bytes_allocated;
+        self->buffer = other->buffer;
+        self->length = other->length;
+        self->capacity = other->capacity;
+        self->_bytes_allocated = other->_bytes_allocated;
+        other->buffer = buffer;
+        other->length = 0;
+        other->capacity = capacity;
+        other->_bytes_allocated = bytes_allocated;
+        return cds_ok;
+    }
+    size_t length = self->length;
+    if (other->length > SIZE_MAX - length)
+        return cds_alloc_error;
+    CDS_NEW_STATUS = cds_ok;
+    CDS_IF_ERROR_RETURN_STATUS(
+        _cds_vector_change_length(self, length + other->length)
+    );
+    memcpy(
+        _cds_vector_get(self, length),
+        other->buffer,
+        other->length * other->type_size
+    );
+    return _cds_vector_change_length(other, 0);
+}
+
 CDS_PUBLIC
 cds_ptr_t cds_vector_get(cds_vector_t *self, size_t index) {
     // Safe short-circuit in logic gate
@@ -213,9 +550,13 @@ cds_status_t cds_vector_insert(
 ) {
     if (self == NULL || self->buffer == NULL || src == NULL)
         return cds_null_error;
+    if (index > self->length)
+        return cds_index_error;
     CDS_NEW_STATUS = cds_ok;
     CDS_IF_ERROR_RETURN_STATUS(_cds_vector_increase_one(self));
+    --(self->length);
     CDS_IF_ERROR_RETURN_STATUS(_cds_vector_make_gap(self, index));
+    ++(self->length);
     return _cds_vector_copy_from(self, index, src);
 }
 
@@ -224,6 +565,22 @@ cds_status_t cds_vector_push_back(cds_vector_t *self, cds_ptr_t src) {
     return cds_vector_insert(self, self->length, src);
 }
 
+CDS_PUBLIC
+cds_ptr_t cds_vector_emplace_back(cds_vector_t *self) {
+    if (self == NULL || self->buffer == NULL)
+        return NULL;
+    if (CDS_IS_ERROR(_cds_vector_increase_one(self)))
+        return NULL;
+    return _cds_vector_get(self, self->length - 1);
+}
+
+CDS_PUBLIC
+cds_status_t cds_vector_resize_uninit(cds_vector_t *self, size_t length) {
+    if (self == NULL || self->buffer == NULL)
+        return cds_null_error;
+    return _cds_vector_change_length(self, length);
+}
+
 CDS_PUBLIC
 cds_status_t cds_vector_push_front(cds_vector_t *self, cds_ptr_t src) {
     return cds_vector_insert(self, 0, src);
@@ -259,3 +616,93 @@ cds_status_t cds_vector_pop_front(cds_vector_t *self, cds_ptr_t dest) {
         return cds_warning;
     return cds_vector_remove(self, 0, dest);
 }
+
+CDS_PUBLIC
+cds_status_t cds_vector_sort(cds_vector_t *self, cds_compare_f compare) {
+    if (self == NULL || self->buffer == NULL)
+        return cds_null_error;
+    return cds_sort(self->buffer, self->length, self->type_size, compare);
+}
+
+CDS_PUBLIC
+size_t cds_vector_lower_bound(
+    cds_vector_t *self,
+    cds_ptr_t key,
+    cds_compare_f compare
+) {
+    if (self == NULL || self->buffer == NULL)
+        return 0;
+    return cds_lower_bound(
+        self->buffer,
+        self->length,
+        self->type_size,
+        key,
+        compare
+    );
+}
+
+CDS_PUBLIC
+size_t cds_vector_upper_bound(
+    cds_vector_t *self,
+    cds_ptr_t key,
+    cds_compare_f compare
+) {
+    if (self == NULL || self->buffer == NULL)
+        return 0;
+    return cds_upper_bound(
+        self->buffer,
+        self->length,
+        self->type_size,
+        key,
+        compare
+    );
+}
+
+#define _CDS_VECTOR_RADIX_SORT_DEFINE(stn, ltn) \
+    CDS_PUBLIC cds_status_t \
+    cds_vector_radix_sort_##stn(cds_vector_t *self, size_t key_offset) { \
+        if (self == NULL || self->buffer == NULL) \
+            return cds_null_error; \
+        return CDS_SMASH_PUBLIC(stn, radix_sort)( \
+            self->buffer, \
+            self->length, \
+            self->type_size, \
+            key_offset \
+        ); \
+    }
+
+CDS_INTEGER_TYPES(_CDS_VECTOR_RADIX_SORT_DEFINE)
+
+#undef _CDS_VECTOR_RADIX_SORT_DEFINE
+
+CDS_PUBLIC
+cds_status_t cds_vector_write(cds_vector_t *self, FILE *file) {
+    if (self == NULL || self->buffer == NULL)
+        return cds_null_error;
+    return cds_serial_write(file, self->buffer, self->length, self->type_size);
+}
+
+CDS_PUBLIC
+cds_status_t cds_vector_read(cds_vector_t *self, FILE *file) {
+    if (self == NULL || self->buffer == NULL)
+        return cds_null_error;
+    CDS_NEW_STATUS = cds_ok;
+    cds_serial_header_t header;
+    self->length = 0;
+    CDS_IF_ERROR_RETURN_STATUS(cds_serial_read_header(
+        file,
+        self->type_size,
+        &header
+    ));
+    CDS_IF_ERROR_RETURN_STATUS(_cds_vector_reserve(
+        self,
+        (size_t) header.length
+    ));
+    CDS_IF_ERROR_RETURN_STATUS(cds_serial_read_elements(
+        file,
+        &header,
+        self->buffer
+    ));
+    self->length = (size_t) header.length;
+    return cds_ok;
+}